@@ -0,0 +1,449 @@
+// ======================================================================== //
+// Copyright 2017 Intel Corporation                                         //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "ProceduralScenes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "ospcommon/vec.h"
+
+namespace ospray {
+  namespace bench {
+
+    using namespace ospcommon;
+
+    // the scenes use fixed seeds, so every run sees the same data
+    static const unsigned int SEED = 0x05b7a9;
+
+    /*! accumulates the time spent in OSPRay calls */
+    struct CommitTimer
+    {
+      template <typename FCN_T>
+      void operator()(FCN_T &&fcn)
+      {
+        const auto start = std::chrono::high_resolution_clock::now();
+        fcn();
+        const auto end = std::chrono::high_resolution_clock::now();
+        seconds += std::chrono::duration<double>(end - start).count();
+      }
+
+      double seconds {0.0};
+    };
+
+    void ProceduralScene::release()
+    {
+      for (auto obj : objects)
+        ospRelease(obj);
+      objects.clear();
+      if (model)
+        ospRelease(model);
+      model = nullptr;
+    }
+
+    /*! blue-white-red transfer function over the given value range */
+    static OSPTransferFunction createTransferFunction(const vec2f &range)
+    {
+      const vec3f colors[] = {vec3f(0.23f, 0.30f, 0.75f),
+                              vec3f(0.87f, 0.87f, 0.87f),
+                              vec3f(0.71f, 0.02f, 0.15f)};
+      const float opacities[] = {0.f, 0.05f, 0.1f};
+
+      OSPTransferFunction tfn = ospNewTransferFunction("piecewise_linear");
+      OSPData colorData = ospNewData(3, OSP_FLOAT3, colors);
+      OSPData opacityData = ospNewData(3, OSP_FLOAT, opacities);
+      ospSetData(tfn, "colors", colorData);
+      ospSetData(tfn, "opacities", opacityData);
+      ospSet2f(tfn, "valueRange", range.x, range.y);
+      ospCommit(tfn);
+      ospRelease(colorData);
+      ospRelease(opacityData);
+      return tfn;
+    }
+
+    /*! smooth scalar field in [-1,1] used by all volume scenes; 'p' is
+        in [0,1]^3 */
+    static inline float field(const vec3f &p)
+    {
+      const float r = length(p - vec3f(.5f));
+      return 0.5f * std::sin(31.f * r)
+           + 0.5f * std::sin(9.f * p.x) * std::cos(11.f * p.y)
+                  * std::sin(7.f * p.z);
+    }
+
+    // Triangles //////////////////////////////////////////////////////////////
+
+    /*! a bumpy torus tessellated into 'scale' * 2M triangles */
+    static void createTriangles(ProceduralScene &scene,
+                                const SceneParams &params,
+                                CommitTimer &timer)
+    {
+      const int nv = std::max(4, int(std::sqrt(params.scale * 2e6f / 4.f)));
+      const int nu = 2 * nv;
+      const float R = 1.f;
+
+      std::vector<vec3f> vertices;
+      std::vector<vec3f> normals;
+      vertices.reserve(size_t(nu) * nv);
+      normals.reserve(size_t(nu) * nv);
+      for (int i = 0; i < nu; i++) {
+        const float u = 2.f * float(M_PI) * i / nu;
+        for (int j = 0; j < nv; j++) {
+          const float v = 2.f * float(M_PI) * j / nv;
+          const float r = 0.35f + 0.03f * std::sin(24.f * u) * std::sin(16.f * v);
+          const vec3f n(std::cos(u) * std::cos(v),
+                        std::sin(v),
+                        std::sin(u) * std::cos(v));
+          vertices.push_back(vec3f(R * std::cos(u), 0.f, R * std::sin(u))
+                             + r * n);
+          normals.push_back(n);
+        }
+      }
+
+      std::vector<vec3i> indices;
+      indices.reserve(size_t(2) * nu * nv);
+      for (int i = 0; i < nu; i++) {
+        for (int j = 0; j < nv; j++) {
+          const int i1 = (i + 1) % nu;
+          const int j1 = (j + 1) % nv;
+          const int a = i * nv + j,  b = i1 * nv + j;
+          const int c = i1 * nv + j1, d = i * nv + j1;
+          indices.push_back(vec3i(a, b, c));
+          indices.push_back(vec3i(a, c, d));
+        }
+      }
+
+      scene.size = std::to_string(indices.size()) + " triangles";
+      scene.bounds = box3f(vec3f(-R - .4f, -.4f, -R - .4f),
+                           vec3f( R + .4f,  .4f,  R + .4f));
+
+      timer([&]() {
+        OSPGeometry mesh = ospNewGeometry("triangles");
+        OSPData vertexData = ospNewData(vertices.size(), OSP_FLOAT3,
+                                        vertices.data());
+        OSPData normalData = ospNewData(normals.size(), OSP_FLOAT3,
+                                        normals.data());
+        OSPData indexData = ospNewData(indices.size(), OSP_INT3,
+                                       indices.data());
+        ospSetData(mesh, "vertex", vertexData);
+        ospSetData(mesh, "vertex.normal", normalData);
+        ospSetData(mesh, "index", indexData);
+        ospCommit(mesh);
+        ospRelease(vertexData);
+        ospRelease(normalData);
+        ospRelease(indexData);
+
+        ospAddGeometry(scene.model, mesh);
+        scene.objects.push_back(mesh);
+      });
+    }
+
+    // Spheres ////////////////////////////////////////////////////////////////
+
+    /*! 'scale' * 1M spheres of varying radius, clustered in a unit cube */
+    static void createSpheres(ProceduralScene &scene,
+                              const SceneParams &params,
+                              CommitTimer &timer)
+    {
+      const size_t numSpheres = std::max(size_t(1), size_t(params.scale * 1e6f));
+      const int numClusters = 64;
+
+      std::mt19937 rng(SEED);
+      std::uniform_real_distribution<float> uniform(0.f, 1.f);
+      std::normal_distribution<float> normal(0.f, 0.08f);
+
+      std::vector<vec3f> centers(numClusters);
+      for (auto &c : centers)
+        c = vec3f(uniform(rng), uniform(rng), uniform(rng));
+
+      const float baseRadius = 0.25f / std::cbrt(float(numSpheres));
+      std::vector<vec4f> spheres(numSpheres);
+      for (auto &s : spheres) {
+        const vec3f &c = centers[rng() % numClusters];
+        const vec3f p = c + vec3f(normal(rng), normal(rng), normal(rng));
+        s = vec4f(p.x, p.y, p.z, baseRadius * (0.5f + uniform(rng)));
+      }
+
+      scene.size = std::to_string(numSpheres) + " spheres";
+      scene.bounds = box3f(vec3f(-.4f), vec3f(1.4f));
+
+      timer([&]() {
+        OSPGeometry geom = ospNewGeometry("spheres");
+        OSPData sphereData = ospNewData(spheres.size(), OSP_FLOAT4,
+                                        spheres.data());
+        ospSetData(geom, "spheres", sphereData);
+        ospSet1i(geom, "bytes_per_sphere", sizeof(vec4f));
+        ospSet1i(geom, "offset_radius", 3 * sizeof(float));
+        ospCommit(geom);
+        ospRelease(sphereData);
+
+        ospAddGeometry(scene.model, geom);
+        scene.objects.push_back(geom);
+      });
+    }
+
+    // Structured volume //////////////////////////////////////////////////////
+
+    /*! a volumeDims^3 uchar block_bricked_volume, uploaded slice by slice */
+    static void createStructuredVolume(ProceduralScene &scene,
+                                       const SceneParams &params,
+                                       CommitTimer &timer)
+    {
+      const vec3i dims(params.volumeDims);
+
+      OSPVolume volume = nullptr;
+      timer([&]() {
+        volume = ospNewVolume("block_bricked_volume");
+        ospSetString(volume, "voxelType", "uchar");
+        ospSetVec3i(volume, "dimensions", (const osp::vec3i&)dims);
+        ospSet2f(volume, "voxelRange", 0.f, 255.f);
+      });
+
+      std::vector<unsigned char> slice(size_t(dims.x) * dims.y);
+      const vec3f rcpDims = rcp(vec3f(dims - vec3i(1)));
+      for (int z = 0; z < dims.z; z++) {
+        size_t i = 0;
+        for (int y = 0; y < dims.y; y++)
+          for (int x = 0; x < dims.x; x++) {
+            const float f = field(vec3f(x, y, z) * rcpDims);
+            slice[i++] = (unsigned char)(127.5f + 127.f * f);
+          }
+        timer([&]() {
+          ospSetRegion(volume, slice.data(), osp::vec3i{0, 0, z},
+                       osp::vec3i{dims.x, dims.y, 1});
+        });
+      }
+
+      scene.size = std::to_string(dims.x) + "^3 voxels";
+      scene.bounds = box3f(vec3f(0.f), vec3f(dims - vec3i(1)));
+      scene.isVolume = true;
+
+      timer([&]() {
+        OSPTransferFunction tfn = createTransferFunction(vec2f(0.f, 255.f));
+        ospSetObject(volume, "transferFunction", tfn);
+        ospCommit(volume);
+        ospRelease(tfn);
+
+        ospAddVolume(scene.model, volume);
+        scene.objects.push_back(volume);
+      });
+    }
+
+    // AMR volume /////////////////////////////////////////////////////////////
+
+    //! the layout amr_volume expects for each brick
+    struct BrickInfo
+    {
+      box3i box;
+      int   level;
+      float cellWidth;
+    };
+
+    /*! three levels of 16^3 cell bricks: a root level of (8*cbrt(scale))^3
+        bricks, refined by 2x over the central half of the domain, and again
+        by 2x over the central quarter */
+    static void createAMRVolume(ProceduralScene &scene,
+                                const SceneParams &params,
+                                CommitTimer &timer)
+    {
+      const int brickSize  = 16;
+      const int rootBricks = std::max(2, int(8 * std::cbrt(params.scale)));
+      const int rootCells  = rootBricks * brickSize;
+
+      std::vector<BrickInfo> bricks;
+      std::vector<std::vector<float>> values;
+
+      auto addLevel = [&](int level, float lower, float upper) {
+        const float cellWidth = 1.f / (1 << level);
+        const int begin = int(lower * rootCells / cellWidth);
+        const int end   = int(upper * rootCells / cellWidth);
+        for (int z = begin; z < end; z += brickSize)
+          for (int y = begin; y < end; y += brickSize)
+            for (int x = begin; x < end; x += brickSize) {
+              BrickInfo info;
+              info.box       = box3i(vec3i(x, y, z),
+                                     vec3i(x, y, z) + vec3i(brickSize - 1));
+              info.level     = level;
+              info.cellWidth = cellWidth;
+              bricks.push_back(info);
+
+              values.emplace_back(brickSize * brickSize * brickSize);
+              auto &v = values.back();
+              size_t i = 0;
+              for (int k = 0; k < brickSize; k++)
+                for (int j = 0; j < brickSize; j++)
+                  for (int l = 0; l < brickSize; l++) {
+                    const vec3f p = (vec3f(x + l, y + j, z + k) + vec3f(.5f))
+                                    * (cellWidth / rootCells);
+                    v[i++] = field(p);
+                  }
+            }
+      };
+
+      addLevel(0, 0.f,    1.f);
+      addLevel(1, .25f,   .75f);
+      addLevel(2, .375f,  .625f);
+
+      scene.size = std::to_string(bricks.size()) + " bricks of "
+                   + std::to_string(brickSize) + "^3 cells, 3 levels";
+      scene.bounds = box3f(vec3f(0.f), vec3f(float(rootCells)));
+      scene.isVolume = true;
+
+      timer([&]() {
+        std::vector<OSPData> brickData;
+        for (auto &v : values) {
+          brickData.push_back(ospNewData(v.size(), OSP_FLOAT, v.data()));
+        }
+
+        OSPVolume volume = ospNewVolume("amr_volume");
+        OSPData infoData = ospNewData(bricks.size() * sizeof(BrickInfo),
+                                      OSP_RAW, bricks.data());
+        OSPData dataData = ospNewData(brickData.size(), OSP_DATA,
+                                      brickData.data());
+        ospSetData(volume, "brickInfo", infoData);
+        ospSetData(volume, "brickData", dataData);
+        ospSet2f(volume, "voxelRange", -1.f, 1.f);
+
+        OSPTransferFunction tfn = createTransferFunction(vec2f(-1.f, 1.f));
+        ospSetObject(volume, "transferFunction", tfn);
+        ospCommit(volume);
+        ospRelease(tfn);
+        ospRelease(infoData);
+        ospRelease(dataData);
+        for (auto d : brickData)
+          ospRelease(d);
+
+        ospAddVolume(scene.model, volume);
+        scene.objects.push_back(volume);
+      });
+    }
+
+    // Tetrahedral volume /////////////////////////////////////////////////////
+
+    /*! a (48*cbrt(scale))^3 cell grid, each cell split into 5 tets */
+    static void createTetVolume(ProceduralScene &scene,
+                                const SceneParams &params,
+                                CommitTimer &timer)
+    {
+      const int n = std::max(2, int(48 * std::cbrt(params.scale)));
+      const int nv = n + 1;
+
+      std::vector<vec3f> vertices;
+      std::vector<float> values;
+      vertices.reserve(size_t(nv) * nv * nv);
+      values.reserve(size_t(nv) * nv * nv);
+      for (int z = 0; z < nv; z++)
+        for (int y = 0; y < nv; y++)
+          for (int x = 0; x < nv; x++) {
+            const vec3f p = vec3f(x, y, z) / float(n);
+            vertices.push_back(p);
+            values.push_back(field(p));
+          }
+
+      // corners of a cell, and the two mirrored 5-tet splits that keep
+      // faces of neighboring cells conforming
+      static const int split[2][5][4] = {
+        {{0,1,3,5}, {0,3,2,6}, {0,5,6,4}, {3,5,6,7}, {0,3,6,5}},
+        {{1,0,2,4}, {1,2,3,7}, {1,4,7,5}, {2,4,7,6}, {1,2,4,7}}
+      };
+
+      std::vector<vec4i> tets;
+      tets.reserve(size_t(5) * n * n * n);
+      for (int z = 0; z < n; z++)
+        for (int y = 0; y < n; y++)
+          for (int x = 0; x < n; x++) {
+            int corner[8];
+            for (int c = 0; c < 8; c++) {
+              corner[c] = (x + (c & 1))
+                        + nv * ((y + ((c >> 1) & 1)) + nv * (z + (c >> 2)));
+            }
+            const auto &s = split[(x + y + z) & 1];
+            for (int t = 0; t < 5; t++) {
+              tets.push_back(vec4i(corner[s[t][0]], corner[s[t][1]],
+                                   corner[s[t][2]], corner[s[t][3]]));
+            }
+          }
+
+      scene.size = std::to_string(tets.size()) + " tetrahedra";
+      scene.bounds = box3f(vec3f(0.f), vec3f(1.f));
+      scene.isVolume = true;
+
+      timer([&]() {
+        OSPVolume volume = ospNewVolume("tetrahedral_volume");
+        OSPData vertexData = ospNewData(vertices.size(), OSP_FLOAT3,
+                                        vertices.data());
+        OSPData tetData = ospNewData(tets.size(), OSP_INT4, tets.data());
+        OSPData fieldData = ospNewData(values.size(), OSP_FLOAT,
+                                       values.data());
+        ospSetData(volume, "vertices", vertexData);
+        ospSetData(volume, "tetrahedra", tetData);
+        ospSetData(volume, "field", fieldData);
+
+        OSPTransferFunction tfn = createTransferFunction(vec2f(-1.f, 1.f));
+        ospSetObject(volume, "transferFunction", tfn);
+        ospCommit(volume);
+        ospRelease(tfn);
+        ospRelease(vertexData);
+        ospRelease(tetData);
+        ospRelease(fieldData);
+
+        ospAddVolume(scene.model, volume);
+        scene.objects.push_back(volume);
+      });
+    }
+
+    // Scene library //////////////////////////////////////////////////////////
+
+    std::vector<std::string> proceduralSceneNames()
+    {
+      return {"triangles", "spheres", "volume", "amr", "tets"};
+    }
+
+    ProceduralScene createProceduralScene(const std::string &name,
+                                          const SceneParams &params)
+    {
+      ProceduralScene scene;
+      scene.name = name;
+
+      CommitTimer timer;
+      timer([&]() { scene.model = ospNewModel(); });
+
+      if (name == "triangles")
+        createTriangles(scene, params, timer);
+      else if (name == "spheres")
+        createSpheres(scene, params, timer);
+      else if (name == "volume")
+        createStructuredVolume(scene, params, timer);
+      else if (name == "amr")
+        createAMRVolume(scene, params, timer);
+      else if (name == "tets")
+        createTetVolume(scene, params, timer);
+      else {
+        ospRelease(scene.model);
+        throw std::runtime_error("unknown procedural scene '" + name + "'");
+      }
+
+      timer([&]() { ospCommit(scene.model); });
+
+      scene.commitSeconds = timer.seconds;
+      return scene;
+    }
+
+  } // ::ospray::bench
+} // ::ospray
@@ -0,0 +1,69 @@
+// ======================================================================== //
+// Copyright 2017 Intel Corporation                                         //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+/*! \file ProceduralScenes.h built-in benchmark scenes, generated
+    deterministically in-process (no data sets to download) */
+
+#include <string>
+#include <vector>
+
+#include "ospray/ospray.h"
+#include "ospcommon/box.h"
+
+namespace ospray {
+  namespace bench {
+
+    /*! knobs controlling the size of the procedural scenes */
+    struct SceneParams
+    {
+      //! scales the number of triangles, spheres, AMR bricks and tets
+      float scale {1.f};
+      //! edge length (in voxels) of the structured volume
+      int volumeDims {512};
+    };
+
+    /*! a generated scene, committed and ready to render */
+    struct ProceduralScene
+    {
+      std::string name;
+      //! human readable size, e.g. "2000000 triangles"
+      std::string size;
+      OSPModel model {nullptr};
+      ospcommon::box3f bounds;
+      //! whether the scene holds a volume (instead of geometry)
+      bool isVolume {false};
+      /*! time spent in OSPRay to upload and commit all objects
+          (including the model); generating the data is not included */
+      double commitSeconds {0.0};
+
+      //! release all OSPRay objects of this scene
+      void release();
+
+      std::vector<OSPObject> objects;
+    };
+
+    /*! names of all scenes, in the order a full run uses */
+    std::vector<std::string> proceduralSceneNames();
+
+    /*! generate (and commit) the scene with the given name; throws
+        std::runtime_error for unknown names */
+    ProceduralScene createProceduralScene(const std::string &name,
+                                          const SceneParams &params);
+
+  } // ::ospray::bench
+} // ::ospray
@@ -0,0 +1,219 @@
+// ======================================================================== //
+// Copyright 2017 Intel Corporation                                         //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file amrSampling.cpp compares AMR volume sampling throughput with and
+    without the coherent (cursor based) sampling path, on a procedural
+    two-level data set sampled along rays, and reports samples/s */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "pico_bench/pico_bench.h"
+
+#include "ospray/ospray.h"
+#include "ospcommon/vec.h"
+#include "ospcommon/box.h"
+
+namespace ospAMRSampling {
+
+  using namespace ospcommon;
+  using namespace std::chrono;
+
+  //! the layout amr_volume expects for each brick
+  struct BrickInfo
+  {
+    box3i box;
+    int   level;
+    float cellWidth;
+  };
+
+  int brickSize     = 8;
+  int rootBricks    = 8;  // per dimension
+  int numRays       = 4096;
+  int samplesPerRay = 256;
+  size_t numBenchRuns = 10;
+
+  void parseCommandLine(int ac, const char **av)
+  {
+    for (int i = 1; i < ac; ++i) {
+      const std::string arg = av[i];
+      if (arg == "-bs" || arg == "--brick-size")
+        brickSize = std::atoi(av[++i]);
+      else if (arg == "-rb" || arg == "--root-bricks")
+        rootBricks = std::atoi(av[++i]);
+      else if (arg == "-r" || arg == "--rays")
+        numRays = std::atoi(av[++i]);
+      else if (arg == "-s" || arg == "--samples-per-ray")
+        samplesPerRay = std::atoi(av[++i]);
+      else if (arg == "-bf" || arg == "--bench")
+        numBenchRuns = std::atoi(av[++i]);
+    }
+  }
+
+  inline float field(const vec3f &p)
+  {
+    return std::sin(0.37f*p.x) * std::cos(0.23f*p.y) + std::sin(0.11f*p.z);
+  }
+
+  /*! root level bricks covering the domain, plus a refined (half cell
+      width) level over its central half */
+  OSPVolume createVolume(std::vector<std::vector<float>> &values)
+  {
+    std::vector<BrickInfo> bricks;
+    const int rootCells = rootBricks * brickSize;
+
+    auto addBrick = [&](const vec3i &lower, int level, float cellWidth) {
+      BrickInfo info;
+      info.box       = box3i(lower, lower + vec3i(brickSize - 1));
+      info.level     = level;
+      info.cellWidth = cellWidth;
+      bricks.push_back(info);
+
+      values.emplace_back(brickSize * brickSize * brickSize);
+      auto &v = values.back();
+      for (int z = 0; z < brickSize; ++z)
+        for (int y = 0; y < brickSize; ++y)
+          for (int x = 0; x < brickSize; ++x) {
+            const vec3f p = (vec3f(lower + vec3i(x, y, z)) + vec3f(.5f))
+              * cellWidth;
+            v[x + brickSize * (y + brickSize * z)] = field(p);
+          }
+    };
+
+    for (int z = 0; z < rootBricks; ++z)
+      for (int y = 0; y < rootBricks; ++y)
+        for (int x = 0; x < rootBricks; ++x)
+          addBrick(vec3i(x, y, z) * brickSize, 0, 1.f);
+
+    // level 1 covers [rootCells/4, 3*rootCells/4)^3 in root cells
+    const int fineBegin = rootCells / 2;
+    const int fineEnd   = 3 * rootCells / 2;
+    for (int z = fineBegin; z < fineEnd; z += brickSize)
+      for (int y = fineBegin; y < fineEnd; y += brickSize)
+        for (int x = fineBegin; x < fineEnd; x += brickSize)
+          addBrick(vec3i(x, y, z), 1, .5f);
+
+    std::vector<OSPData> brickData;
+    for (auto &v : values)
+      brickData.push_back(ospNewData(v.size(), OSP_FLOAT, v.data(),
+                                     OSP_DATA_SHARED_BUFFER));
+
+    OSPVolume volume = ospNewVolume("amr_volume");
+    OSPData infoData = ospNewData(bricks.size() * sizeof(BrickInfo),
+                                  OSP_RAW, bricks.data());
+    OSPData dataData = ospNewData(brickData.size(), OSP_DATA,
+                                  brickData.data());
+    ospSetData(volume, "brickInfo", infoData);
+    ospSetData(volume, "brickData", dataData);
+    ospSetString(volume, "amrMethod", "current");
+
+    OSPTransferFunction tfn = ospNewTransferFunction("piecewise_linear");
+    ospCommit(tfn);
+    ospSetObject(volume, "transferFunction", tfn);
+
+    return volume;
+  }
+
+  /*! sample positions along random rays through the domain, ray by ray,
+      at the spacing a ray marcher would use */
+  std::vector<osp::vec3f> generateRaySamples(const box3f &bounds)
+  {
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+
+    std::vector<osp::vec3f> samples;
+    samples.reserve(size_t(numRays) * samplesPerRay);
+    const vec3f size = bounds.size();
+    for (int r = 0; r < numRays; ++r) {
+      const vec3f a = bounds.lower + vec3f(u(rng), u(rng), u(rng)) * size;
+      const vec3f b = bounds.lower + vec3f(u(rng), u(rng), u(rng)) * size;
+      for (int s = 0; s < samplesPerRay; ++s) {
+        const vec3f p = a + (b - a) * (float(s) / samplesPerRay);
+        samples.push_back(osp::vec3f{p.x, p.y, p.z});
+      }
+    }
+    return samples;
+  }
+
+  double benchmark(OSPVolume volume,
+                   bool coherent,
+                   const std::vector<osp::vec3f> &samples,
+                   std::vector<float> &values)
+  {
+    ospSet1i(volume, "coherentSampling", coherent);
+    ospCommit(volume);
+
+    auto benchmarker = pico_bench::Benchmarker<microseconds>{numBenchRuns};
+    auto stats = benchmarker([&]() {
+      float *results = nullptr;
+      ospSampleVolume(&results, volume, samples[0], samples.size());
+      values.assign(results, results + samples.size());
+      free(results);
+    });
+
+    const double seconds = stats.median().count() * 1e-6;
+    std::cout << (coherent ? "coherent (cursor) sampling:\n"
+                           : "independent sampling:\n");
+    std::cout << stats << std::endl;
+    std::cout << "\tsamples/s: " << samples.size() / seconds << "\n"
+              << std::endl;
+    return samples.size() / seconds;
+  }
+
+  int main(int ac, const char **av)
+  {
+    int init_error = ospInit(&ac, av);
+    if (init_error != OSP_NO_ERROR) {
+      std::cerr << "FATAL ERROR DURING INITIALIZATION!" << std::endl;
+      return init_error;
+    }
+    parseCommandLine(ac, av);
+
+    std::vector<std::vector<float>> brickValues;
+    OSPVolume volume = createVolume(brickValues);
+
+    const float domain = rootBricks * brickSize;
+    const auto samples = generateRaySamples(box3f(vec3f(0.f),
+                                                  vec3f(domain)));
+
+    std::vector<float> reference, coherent;
+    const double plainRate    = benchmark(volume, false, samples, reference);
+    const double coherentRate = benchmark(volume, true, samples, coherent);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+      mismatches += reference[i] != coherent[i];
+
+    std::cout << numRays << " rays x " << samplesPerRay << " samples, "
+              << brickValues.size() << " bricks\n"
+              << "speedup of coherent sampling: "
+              << coherentRate / plainRate << "x\n"
+              << "mismatching samples: " << mismatches << std::endl;
+
+    ospRelease(volume);
+    return mismatches == 0 ? 0 : 1;
+  }
+
+} // ::ospAMRSampling
+
+int main(int ac, const char **av)
+{
+  return ospAMRSampling::main(ac, av);
+}
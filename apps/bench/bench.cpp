@@ -14,7 +14,9 @@
 // limitations under the License.                                           //
 // ======================================================================== //
 
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -38,13 +40,34 @@ inline void outputStats(const T &stats)
 #include "sg/common/FrameBuffer.h"
 #include "common/sg/SceneGraph.h"
 
+#include "ospray/version.h"
+#include "ProceduralScenes.h"
+
 namespace ospray {
 
   using namespace std::chrono;
 
   void printUsageAndExit()
   {
-    std::cout << "TODO: usage description..." << std::endl;
+    std::cout << "usage: ospBenchmark [options] <files...>\n"
+              << "       ospBenchmark [options] --suite <all|scene,...>\n"
+              << "\n"
+              << "  -i  | --image <file>     save the last frame to <file>.ppm\n"
+              << "  -w  | --width <w>        framebuffer width\n"
+              << "  -h  | --height <h>       framebuffer height\n"
+              << "  -wf | --warmup <n>       number of warmup frames\n"
+              << "  -bf | --bench <n>        number of benchmarked frames\n"
+              << "  -vp | --eye <x y z>      camera position\n"
+              << "  -vu | --up <x y z>       camera up vector\n"
+              << "  -vi | --gaze <x y z>     camera look-at point\n"
+              << "  -fv | --fovy <deg>       camera field of view\n"
+              << "\n"
+              << "  --suite <all|scene,...>  run the built-in procedural scenes\n"
+              << "                           (triangles, spheres, volume, amr, tets)\n"
+              << "  --scale <s>              scale the size of the scenes\n"
+              << "  --volume-dims <n>        edge length of the structured volume\n"
+              << "  --json <file>            write the suite results as JSON\n"
+              << std::endl;
     exit(0);
   }
 
@@ -61,6 +84,10 @@ namespace ospray {
   float fovy = 60.f;
   bool customView = false;
 
+  std::vector<std::string> suiteScenes;
+  std::string jsonOutputFile = "";
+  bench::SceneParams sceneParams;
+
   void initializeOSPRay(int argc, const char *argv[])
   {
     int init_error = ospInit(&argc, argv);
@@ -124,17 +151,207 @@ namespace ospray {
         customView = true;
       } else if (arg == "-fv" || arg == "--fovy") {
         fovy = atof(argv[++i]);
+      } else if (arg == "--suite") {
+        const std::string list = argv[++i];
+        if (list == "all") {
+          suiteScenes = bench::proceduralSceneNames();
+        } else {
+          std::stringstream ss(list);
+          std::string name;
+          while (std::getline(ss, name, ','))
+            suiteScenes.push_back(name);
+        }
+      } else if (arg == "--scale") {
+        sceneParams.scale = atof(argv[++i]);
+      } else if (arg == "--volume-dims") {
+        sceneParams.volumeDims = atoi(argv[++i]);
+      } else if (arg == "--json") {
+        jsonOutputFile = argv[++i];
       } else if (arg[0] != '-') {
         files.push_back(arg);
       }
     }
   }
 
+  // Procedural suite ///////////////////////////////////////////////////////
+
+  /*! timings of one procedural scene */
+  struct SuiteResult
+  {
+    std::string name;
+    std::string size;
+    double commitMS {0.0};
+    double firstFrameMS {0.0};
+    pico_bench::Statistics<microseconds> frames {std::vector<microseconds>()};
+  };
+
+  static double toMS(microseconds t)
+  {
+    return t.count() / 1000.0;
+  }
+
+  /*! render one procedural scene with the raw API, such that only
+      ospRenderFrame() is timed */
+  SuiteResult runScene(const std::string &name)
+  {
+    std::cout << "generating '" << name << "'..." << std::endl;
+    auto scene = bench::createProceduralScene(name, sceneParams);
+
+    OSPRenderer renderer = ospNewRenderer("scivis");
+
+    OSPLight ambient = ospNewLight(renderer, "ambient");
+    ospSet1f(ambient, "intensity", 0.4f);
+    ospCommit(ambient);
+    OSPLight sun = ospNewLight(renderer, "distant");
+    ospSet3f(sun, "direction", 0.462f, -1.f, -.1f);
+    ospSet1f(sun, "intensity", 1.5f);
+    ospCommit(sun);
+    OSPLight lights[] = {ambient, sun};
+    OSPData lightData = ospNewData(2, OSP_LIGHT, lights);
+
+    const box3f bbox = scene.bounds;
+    vec3f diag = bbox.size();
+    diag = max(diag, vec3f(0.3f * length(diag)));
+    const vec3f at  = customView ? gaze : ospcommon::center(bbox);
+    const vec3f eye = customView ? pos :
+                      at - .75f*vec3f(-.6*diag.x, -1.2f*diag.y, .8f*diag.z);
+    const vec3f camUp = customView ? up : vec3f(0.f, 1.f, 0.f);
+    const vec3f dir = at - eye;
+
+    OSPCamera camera = ospNewCamera("perspective");
+    ospSet3f(camera, "pos", eye.x, eye.y, eye.z);
+    ospSet3f(camera, "dir", dir.x, dir.y, dir.z);
+    ospSet3f(camera, "up", camUp.x, camUp.y, camUp.z);
+    ospSet1f(camera, "fovy", fovy);
+    ospSet1f(camera, "aspect", width / float(height));
+    ospCommit(camera);
+
+    ospSetObject(renderer, "model", scene.model);
+    ospSetObject(renderer, "camera", camera);
+    ospSetData(renderer, "lights", lightData);
+    ospSet1i(renderer, "shadowsEnabled", 1);
+    ospSet1i(renderer, "aoSamples", scene.isVolume ? 0 : 1);
+    ospSet1i(renderer, "spp", 1);
+    ospCommit(renderer);
+
+    const uint32_t channels = OSP_FB_COLOR | OSP_FB_ACCUM;
+    OSPFrameBuffer fb = ospNewFrameBuffer(osp::vec2i{width, height},
+                                          OSP_FB_SRGBA, channels);
+
+    SuiteResult result;
+    result.name     = scene.name;
+    result.size     = scene.size;
+    result.commitMS = scene.commitSeconds * 1000.0;
+
+    // the first frame also pays for lazily built acceleration structures
+    auto start = high_resolution_clock::now();
+    ospRenderFrame(fb, renderer, channels);
+    auto end = high_resolution_clock::now();
+    result.firstFrameMS = duration<double, std::milli>(end - start).count();
+
+    for (size_t i = 0; i < numWarmupFrames; ++i)
+      ospRenderFrame(fb, renderer, channels);
+
+    auto benchmarker = pico_bench::Benchmarker<microseconds>{numBenchFrames};
+    result.frames = benchmarker([&]() {
+      ospRenderFrame(fb, renderer, channels);
+    });
+
+    if (!imageOutputFile.empty()) {
+      auto *srcPB = (const uint32_t*)ospMapFrameBuffer(fb, OSP_FB_COLOR);
+      utility::writePPM(imageOutputFile + "_" + name + ".ppm",
+                        width, height, srcPB);
+      ospUnmapFrameBuffer(srcPB, fb);
+    }
+
+    std::cout << name << " (" << result.size << "):\n"
+              << "\tcommit: " << result.commitMS << "ms\n"
+              << "\tfirst frame: " << result.firstFrameMS << "ms\n"
+              << "\tframes:" << std::endl;
+    outputStats(result.frames);
+
+    ospFreeFrameBuffer(fb);
+    ospRelease(renderer);
+    ospRelease(camera);
+    ospRelease(lightData);
+    ospRelease(ambient);
+    ospRelease(sun);
+    scene.release();
+
+    return result;
+  }
+
+  static std::string jsonString(const std::string &str)
+  {
+    std::string result = "\"";
+    for (char c : str) {
+      if (c == '"' || c == '\\')
+        result += '\\';
+      result += c;
+    }
+    return result + "\"";
+  }
+
+  void writeJSON(const std::vector<SuiteResult> &results)
+  {
+    std::ofstream out(jsonOutputFile);
+    if (!out.good())
+      throw std::runtime_error("could not open '" + jsonOutputFile + "'");
+
+    out << "{\n"
+        << "  \"ospray_version\": " << jsonString(OSPRAY_VERSION) << ",\n"
+        << "  \"ospray_githash\": " << jsonString(OSPRAY_VERSION_GITHASH)
+        << ",\n"
+        << "  \"width\": " << width << ",\n"
+        << "  \"height\": " << height << ",\n"
+        << "  \"scale\": " << sceneParams.scale << ",\n"
+        << "  \"warmup_frames\": " << numWarmupFrames << ",\n"
+        << "  \"scenes\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+      const auto &r = results[i];
+      out << (i == 0 ? "\n" : ",\n")
+          << "    {\n"
+          << "      \"name\": " << jsonString(r.name) << ",\n"
+          << "      \"size\": " << jsonString(r.size) << ",\n"
+          << "      \"commit_ms\": " << r.commitMS << ",\n"
+          << "      \"first_frame_ms\": " << r.firstFrameMS << ",\n"
+          << "      \"frame_ms\": {\n"
+          << "        \"median\": " << toMS(r.frames.median()) << ",\n"
+          << "        \"mean\": " << toMS(r.frames.mean()) << ",\n"
+          << "        \"min\": " << toMS(r.frames.min()) << ",\n"
+          << "        \"max\": " << toMS(r.frames.max()) << ",\n"
+          << "        \"std_dev\": " << toMS(r.frames.std_dev()) << ",\n"
+          << "        \"median_abs_dev\": "
+          << toMS(r.frames.median_abs_dev()) << ",\n"
+          << "        \"samples\": " << r.frames.size() << "\n"
+          << "      }\n"
+          << "    }";
+    }
+
+    out << "\n  ]\n}" << std::endl;
+  }
+
+  int runSuite()
+  {
+    std::vector<SuiteResult> results;
+    for (const auto &name : suiteScenes)
+      results.push_back(runScene(name));
+
+    if (!jsonOutputFile.empty())
+      writeJSON(results);
+
+    return 0;
+  }
+
   extern "C" int main(int argc, const char *argv[])
   {
     initializeOSPRay(argc, argv);
     parseCommandLine(argc, argv);
 
+    if (!suiteScenes.empty())
+      return runSuite();
+
     // Setup scene nodes //////////////////////////////////////////////////////
 
     auto renderer_ptr = sg::createNode("renderer", "Renderer");
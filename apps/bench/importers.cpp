@@ -0,0 +1,224 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file importers.cpp measures the loader throughput of the ospray::sg
+    OBJ and PLY importers, i.e., how fast a file is turned into
+    TriangleMesh arrays, and reports MB/s and triangles/s. Without input
+    files a tessellated grid is written as .obj and as binary .ply */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pico_bench/pico_bench.h"
+
+#include "common/sg/SceneGraph.h"
+#include "common/sg/importer/Importer.h"
+
+namespace ospImporterBench {
+
+  using namespace ospcommon;
+  using namespace ospray;
+  using namespace std::chrono;
+
+  int gridSize = 1024;
+  size_t numBenchRuns = 5;
+  std::vector<std::string> files;
+  std::string tmpDir = ".";
+
+  void parseCommandLine(int ac, const char **av)
+  {
+    for (int i = 1; i < ac; ++i) {
+      const std::string arg = av[i];
+      if (arg == "-g" || arg == "--grid") {
+        gridSize = std::atoi(av[++i]);
+      } else if (arg == "-bf" || arg == "--bench") {
+        numBenchRuns = std::atoi(av[++i]);
+      } else if (arg == "--tmp") {
+        tmpDir = av[++i];
+      } else if (arg[0] != '-') {
+        files.push_back(arg);
+      }
+    }
+  }
+
+  inline vec3f gridVertex(int x, int y)
+  {
+    const float u = x / float(gridSize), v = y / float(gridSize);
+    return vec3f(u, v, 0.1f * std::sin(20.f * u) * std::cos(20.f * v));
+  }
+
+  inline int gridIndex(int x, int y)
+  {
+    return y * (gridSize + 1) + x;
+  }
+
+  std::string writeOBJ()
+  {
+    const std::string fileName = tmpDir + "/ospImporterBench.obj";
+    FILE *file = fopen(fileName.c_str(), "w");
+    if (!file)
+      throw std::runtime_error("could not create '" + fileName + "'");
+
+    for (int y = 0; y <= gridSize; ++y) {
+      for (int x = 0; x <= gridSize; ++x) {
+        const vec3f p = gridVertex(x, y);
+        fprintf(file, "v %f %f %f\nvn 0 0 1\nvt %f %f\n",
+                p.x, p.y, p.z, p.x, p.y);
+      }
+    }
+
+    for (int y = 0; y < gridSize; ++y) {
+      for (int x = 0; x < gridSize; ++x) {
+        const int a = gridIndex(x, y) + 1, b = gridIndex(x + 1, y) + 1;
+        const int c = gridIndex(x + 1, y + 1) + 1, d = gridIndex(x, y + 1) + 1;
+        fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a,a,a, b,b,b, c,c,c);
+        fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a,a,a, c,c,c, d,d,d);
+      }
+    }
+
+    fclose(file);
+    return fileName;
+  }
+
+  std::string writePLY()
+  {
+    const std::string fileName = tmpDir + "/ospImporterBench.ply";
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (!file)
+      throw std::runtime_error("could not create '" + fileName + "'");
+
+    const int numVertices = (gridSize + 1) * (gridSize + 1);
+    const int numFaces    = 2 * gridSize * gridSize;
+    fprintf(file,
+            "ply\nformat binary_little_endian 1.0\n"
+            "element vertex %d\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "property float nx\nproperty float ny\nproperty float nz\n"
+            "element face %d\n"
+            "property list uchar int vertex_indices\n"
+            "end_header\n", numVertices, numFaces);
+
+    for (int y = 0; y <= gridSize; ++y) {
+      for (int x = 0; x <= gridSize; ++x) {
+        const vec3f vertex[2] = {gridVertex(x, y), vec3f(0.f, 0.f, 1.f)};
+        fwrite(vertex, sizeof(vertex), 1, file);
+      }
+    }
+
+    const unsigned char three = 3;
+    for (int y = 0; y < gridSize; ++y) {
+      for (int x = 0; x < gridSize; ++x) {
+        const int a = gridIndex(x, y), b = gridIndex(x + 1, y);
+        const int c = gridIndex(x + 1, y + 1), d = gridIndex(x, y + 1);
+        const int tris[2][3] = {{a, b, c}, {a, c, d}};
+        for (const auto &tri : tris) {
+          fwrite(&three, 1, 1, file);
+          fwrite(tri, sizeof(tri), 1, file);
+        }
+      }
+    }
+
+    fclose(file);
+    return fileName;
+  }
+
+  size_t fileSize(const std::string &fileName)
+  {
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (!file)
+      return 0;
+    fseek(file, 0, SEEK_END);
+    const size_t size = ftell(file);
+    fclose(file);
+    return size;
+  }
+
+  size_t countTriangles(const sg::Node &node)
+  {
+    size_t count = 0;
+    if (node.type() == "TriangleMesh" && node.hasChild("index"))
+      count += node.child("index").nodeAs<sg::DataBuffer>()->size();
+    for (const auto &child : node.children())
+      count += countTriangles(*child.second);
+    return count;
+  }
+
+  void benchmark(const FileName &fileName)
+  {
+    const std::string ext = fileName.ext();
+    size_t numTriangles = 0;
+
+    auto benchmarker = pico_bench::Benchmarker<milliseconds>{numBenchRuns};
+    auto stats = benchmarker([&]() {
+      std::shared_ptr<sg::Node> world = sg::createNode("world", "Node");
+      if (ext == "obj")
+        sg::importOBJ(world, fileName);
+      else if (ext == "ply" || ext == "gz")
+        sg::importPLY(world, fileName);
+      else
+        throw std::runtime_error("unsupported file '" + fileName.str() + "'");
+      numTriangles = countTriangles(*world);
+    });
+
+    const double seconds = stats.median().count() * 1e-3;
+    const double mb = fileSize(fileName) / (1024.0 * 1024.0);
+    std::cout << fileName.str() << " (" << numTriangles << " triangles):\n"
+              << stats << std::endl;
+    std::cout << "\tMB/s: " << mb / seconds << "\n"
+              << "\tMtriangles/s: " << numTriangles * 1e-6 / seconds << "\n"
+              << std::endl;
+  }
+
+  int main(int ac, const char **av)
+  {
+    int init_error = ospInit(&ac, av);
+    if (init_error != OSP_NO_ERROR) {
+      std::cerr << "FATAL ERROR DURING INITIALIZATION!" << std::endl;
+      return init_error;
+    }
+    parseCommandLine(ac, av);
+
+    try {
+      std::vector<std::string> generated;
+      if (files.empty()) {
+        generated.push_back(writeOBJ());
+        generated.push_back(writePLY());
+        files = generated;
+      }
+
+      for (const auto &file : files)
+        benchmark(file);
+
+      for (const auto &file : generated)
+        std::remove(file.c_str());
+    } catch (const std::runtime_error &e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+
+} // ::ospImporterBench
+
+int main(int ac, const char **av)
+{
+  return ospImporterBench::main(ac, av);
+}
@@ -0,0 +1,197 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file numaVolume.cpp compares the device's NUMA modes ('none',
+    'interleave' and 'local', see the numaMode device parameter) on a
+    large procedural block_bricked_volume: for each mode the volume is
+    rebuilt and frames are rendered into a fresh accumulating
+    framebuffer with variance, so that volume bricks, accumBuffer and
+    varianceBuffer are all placed according to that mode */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pico_bench/pico_bench.h"
+
+#include "ospray/ospray.h"
+#include "ospcommon/numa.h"
+#include "ospcommon/vec.h"
+
+namespace ospNumaVolumeBench {
+
+  using namespace ospcommon;
+  using namespace std::chrono;
+
+  vec3i dims {1024};
+  vec2i imgSize {1024, 1024};
+  size_t numBenchFrames = 20;
+  std::vector<std::string> modes {"none", "interleave", "local"};
+
+  void parseCommandLine(int ac, const char **av)
+  {
+    for (int i = 1; i < ac; ++i) {
+      const std::string arg = av[i];
+      if (arg == "-d" || arg == "--dimensions") {
+        dims.x = std::atoi(av[++i]);
+        dims.y = std::atoi(av[++i]);
+        dims.z = std::atoi(av[++i]);
+      } else if (arg == "-w" || arg == "--width") {
+        imgSize.x = std::atoi(av[++i]);
+      } else if (arg == "-h" || arg == "--height") {
+        imgSize.y = std::atoi(av[++i]);
+      } else if (arg == "-bf" || arg == "--bench") {
+        numBenchFrames = std::atoi(av[++i]);
+      } else if (arg == "-m" || arg == "--mode") {
+        modes = {av[++i]};
+      }
+    }
+  }
+
+  /*! concentric shells around the volume center */
+  void fillSlice(int z, std::vector<unsigned char> &slice)
+  {
+    const vec3f center = vec3f(dims) * 0.5f;
+    size_t i = 0;
+    for (int y = 0; y < dims.y; ++y) {
+      for (int x = 0; x < dims.x; ++x) {
+        const float r = length(vec3f(x, y, z) - center) / center.x;
+        slice[i++] = (unsigned char)(127.5f + 127.5f * std::cos(20.f * r));
+      }
+    }
+  }
+
+  OSPVolume createVolume(double &seconds)
+  {
+    OSPVolume volume = ospNewVolume("block_bricked_volume");
+    ospSetString(volume, "voxelType", "uchar");
+    ospSetVec3i(volume, "dimensions", (const osp::vec3i&)dims);
+    ospSet2f(volume, "voxelRange", 0.f, 255.f);
+
+    std::vector<unsigned char> slice(size_t(dims.x) * dims.y);
+    double setRegionSeconds = 0.0;
+    for (int z = 0; z < dims.z; ++z) {
+      fillSlice(z, slice);
+      auto start = high_resolution_clock::now();
+      ospSetRegion(volume, slice.data(), osp::vec3i{0, 0, z},
+                   osp::vec3i{dims.x, dims.y, 1});
+      auto end = high_resolution_clock::now();
+      setRegionSeconds += duration<double>(end - start).count();
+    }
+
+    OSPTransferFunction tfn = ospNewTransferFunction("piecewise_linear");
+    const float colors[] = {0.f, 0.f, 1.f,  1.f, 1.f, 1.f,  1.f, 0.f, 0.f};
+    const float opacities[] = {0.f, 0.02f};
+    OSPData colorData = ospNewData(3, OSP_FLOAT3, colors);
+    OSPData opacityData = ospNewData(2, OSP_FLOAT, opacities);
+    ospSetData(tfn, "colors", colorData);
+    ospSetData(tfn, "opacities", opacityData);
+    ospSet2f(tfn, "valueRange", 0.f, 255.f);
+    ospCommit(tfn);
+    ospRelease(colorData);
+    ospRelease(opacityData);
+
+    ospSetObject(volume, "transferFunction", tfn);
+    ospCommit(volume);
+    ospRelease(tfn);
+
+    seconds = setRegionSeconds;
+    return volume;
+  }
+
+  void benchmarkMode(const std::string &mode)
+  {
+    OSPDevice device = ospGetCurrentDevice();
+    ospDeviceSetString(device, "numaMode", mode.c_str());
+    ospDeviceCommit(device);
+
+    double setRegionSeconds = 0.0;
+    OSPVolume volume = createVolume(setRegionSeconds);
+
+    OSPModel model = ospNewModel();
+    ospAddVolume(model, volume);
+    ospCommit(model);
+
+    OSPCamera camera = ospNewCamera("perspective");
+    const vec3f center = vec3f(dims) * 0.5f;
+    const vec3f pos = center + vec3f(-0.8f, 0.6f, -1.6f) * float(dims.x);
+    const vec3f dir = center - pos;
+    ospSet3f(camera, "pos", pos.x, pos.y, pos.z);
+    ospSet3f(camera, "dir", dir.x, dir.y, dir.z);
+    ospSet3f(camera, "up", 0.f, 1.f, 0.f);
+    ospSet1f(camera, "aspect", imgSize.x / float(imgSize.y));
+    ospCommit(camera);
+
+    OSPRenderer renderer = ospNewRenderer("scivis");
+    ospSetObject(renderer, "model", model);
+    ospSetObject(renderer, "camera", camera);
+    ospSet1i(renderer, "spp", 1);
+    ospCommit(renderer);
+
+    const uint32_t channels = OSP_FB_COLOR | OSP_FB_ACCUM | OSP_FB_VARIANCE;
+    OSPFrameBuffer fb = ospNewFrameBuffer((const osp::vec2i&)imgSize,
+                                          OSP_FB_SRGBA, channels);
+
+    // warm up (builds the grid accelerator)
+    ospRenderFrame(fb, renderer, channels);
+
+    auto benchmarker = pico_bench::Benchmarker<milliseconds>{numBenchFrames};
+    auto stats = benchmarker([&]() {
+      ospRenderFrame(fb, renderer, channels);
+    });
+
+    const double gb = double(dims.x) * dims.y * dims.z / (1024.0*1024*1024);
+    std::cout << "numaMode '" << mode << "':\n" << stats << std::endl;
+    std::cout << "\tsetRegion: " << setRegionSeconds << "s, "
+              << gb / setRegionSeconds << " GB/s\n"
+              << "\tFPS: " << 1000.0 / stats.median().count() << "\n"
+              << std::endl;
+
+    ospFreeFrameBuffer(fb);
+    ospRelease(renderer);
+    ospRelease(camera);
+    ospRelease(model);
+    ospRelease(volume);
+  }
+
+  int main(int ac, const char **av)
+  {
+    int init_error = ospInit(&ac, av);
+    if (init_error != OSP_NO_ERROR) {
+      std::cerr << "FATAL ERROR DURING INITIALIZATION!" << std::endl;
+      return init_error;
+    }
+    parseCommandLine(ac, av);
+
+    std::cout << dims.x << "x" << dims.y << "x" << dims.z << " uchar volume, "
+              << imgSize.x << "x" << imgSize.y << " pixels, "
+              << numa::numNodes() << " NUMA node(s)\n" << std::endl;
+
+    for (const auto &mode : modes)
+      benchmarkMode(mode);
+
+    return 0;
+  }
+
+} // ::ospNumaVolumeBench
+
+int main(int ac, const char **av)
+{
+  return ospNumaVolumeBench::main(ac, av);
+}
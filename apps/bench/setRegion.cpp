@@ -0,0 +1,154 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file setRegion.cpp measures how fast ospSetRegion() converts linear
+    float voxels into the bricked layout of a block_bricked_volume, both
+    for the whole volume in one call and slice by slice, and reports
+    GB/s */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pico_bench/pico_bench.h"
+
+#include "ospray/ospray.h"
+#include "ospcommon/vec.h"
+
+namespace ospSetRegionBench {
+
+  using namespace ospcommon;
+  using namespace std::chrono;
+
+  vec3i dims {512};
+  size_t numBenchRuns = 10;
+
+  void parseCommandLine(int ac, const char **av)
+  {
+    for (int i = 1; i < ac; ++i) {
+      const std::string arg = av[i];
+      if (arg == "-d" || arg == "--dimensions") {
+        dims.x = std::atoi(av[++i]);
+        dims.y = std::atoi(av[++i]);
+        dims.z = std::atoi(av[++i]);
+      } else if (arg == "-bf" || arg == "--bench") {
+        numBenchRuns = std::atoi(av[++i]);
+      }
+    }
+  }
+
+  inline float voxel(int x, int y, int z)
+  {
+    return float(x) + 2.f * float(y) + 3.f * float(z);
+  }
+
+  OSPVolume createVolume()
+  {
+    OSPVolume volume = ospNewVolume("block_bricked_volume");
+    ospSetString(volume, "voxelType", "float");
+    ospSetVec3i(volume, "dimensions", (const osp::vec3i&)dims);
+    return volume;
+  }
+
+  double benchmark(const std::string &name,
+                   const std::vector<float> &voxels,
+                   bool sliceBySlice,
+                   OSPVolume volume)
+  {
+    auto benchmarker = pico_bench::Benchmarker<microseconds>{numBenchRuns};
+    auto stats = benchmarker([&]() {
+      if (sliceBySlice) {
+        const size_t sliceSize = size_t(dims.x) * dims.y;
+        for (int z = 0; z < dims.z; ++z) {
+          ospSetRegion(volume,
+                       (void*)(voxels.data() + z * sliceSize),
+                       osp::vec3i{0, 0, z},
+                       osp::vec3i{dims.x, dims.y, 1});
+        }
+      } else {
+        ospSetRegion(volume,
+                     (void*)voxels.data(),
+                     osp::vec3i{0, 0, 0},
+                     (const osp::vec3i&)dims);
+      }
+    });
+
+    const double seconds = stats.median().count() * 1e-6;
+    const double gb = voxels.size() * sizeof(float) / (1024.0*1024.0*1024.0);
+    std::cout << name << ":\n" << stats << std::endl;
+    std::cout << "\tGB/s: " << gb / seconds << "\n" << std::endl;
+    return gb / seconds;
+  }
+
+  int main(int ac, const char **av)
+  {
+    int init_error = ospInit(&ac, av);
+    if (init_error != OSP_NO_ERROR) {
+      std::cerr << "FATAL ERROR DURING INITIALIZATION!" << std::endl;
+      return init_error;
+    }
+    parseCommandLine(ac, av);
+
+    std::vector<float> voxels(size_t(dims.x) * dims.y * dims.z);
+    size_t i = 0;
+    for (int z = 0; z < dims.z; ++z)
+      for (int y = 0; y < dims.y; ++y)
+        for (int x = 0; x < dims.x; ++x)
+          voxels[i++] = voxel(x, y, z);
+
+    // the first call also allocates (and first-touches) the bricks
+    OSPVolume volume = createVolume();
+    ospSetRegion(volume, voxels.data(), osp::vec3i{0, 0, 0},
+                 (const osp::vec3i&)dims);
+
+    benchmark("whole volume", voxels, false, volume);
+    benchmark("slice by slice", voxels, true, volume);
+
+    // sampling at voxel centers has to return the voxels exactly
+    ospCommit(volume);
+
+    std::vector<osp::vec3f> coords;
+    std::vector<float> expected;
+    for (int n = 0; n < 4096; ++n) {
+      const int x = std::rand() % dims.x;
+      const int y = std::rand() % dims.y;
+      const int z = std::rand() % dims.z;
+      coords.push_back(osp::vec3f{float(x), float(y), float(z)});
+      expected.push_back(voxel(x, y, z));
+    }
+
+    float *results = nullptr;
+    ospSampleVolume(&results, volume, coords[0], coords.size());
+    size_t mismatches = 0;
+    for (size_t n = 0; n < coords.size(); ++n)
+      mismatches += results[n] != expected[n];
+    free(results);
+
+    std::cout << dims.x << "x" << dims.y << "x" << dims.z
+              << " float voxels, mismatching samples: " << mismatches
+              << std::endl;
+
+    ospRelease(volume);
+    return mismatches == 0 ? 0 : 1;
+  }
+
+} // ::ospSetRegionBench
+
+int main(int ac, const char **av)
+{
+  return ospSetRegionBench::main(ac, av);
+}
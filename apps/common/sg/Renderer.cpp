@@ -107,6 +107,10 @@ namespace ospray {
       createChild("autoEpsilon", "bool", true, NodeFlags::required,
         "automatically adjust epsilon step by world bounds");
 
+      createChild("parallelCommit", "bool", false, NodeFlags::none,
+                  "commit independent parts of the world in parallel. Only"
+                  " enable if the device supports concurrent API calls.");
+
       createChild("oneSidedLighting", "bool", true, NodeFlags::required);
       createChild("aoTransparencyEnabled", "bool", true, NodeFlags::required);
     }
@@ -156,6 +160,7 @@ namespace ospray {
         setValue((OSPObject)ospRenderer);
       }
       ctx.ospRenderer = ospRenderer;
+      ctx.parallelCommit = child("parallelCommit").valueAs<bool>();
     }
 
     void Renderer::postCommit(RenderContext &ctx)
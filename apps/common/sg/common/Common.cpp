@@ -24,6 +24,7 @@
 #  include <windows.h>
 #else
 #  include <sys/mman.h>
+#  include <unistd.h>
 #endif
 #include <fcntl.h>
 
@@ -83,5 +84,59 @@ namespace ospray {
 #endif
     }
 
+    MappedFile::MappedFile(const std::string &fileName)
+    {
+#ifdef _WIN32
+      HANDLE file = CreateFile(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                               nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                               nullptr);
+      if (file == INVALID_HANDLE_VALUE)
+        THROW_SG_ERROR("could not open file '" + fileName + "'");
+      fileHandle = file;
+      LARGE_INTEGER fileSize;
+      GetFileSizeEx(file, &fileSize);
+      size = fileSize.QuadPart;
+      mappingHandle = CreateFileMapping(file, nullptr, PAGE_READONLY,
+                                        0, 0, nullptr);
+      if (mappingHandle) {
+        base = (const unsigned char *)MapViewOfFile(mappingHandle,
+                                                    FILE_MAP_READ, 0, 0, size);
+      }
+      if (!base) {
+        if (mappingHandle) CloseHandle(mappingHandle);
+        CloseHandle(file);
+        THROW_SG_ERROR("could not map file '" + fileName + "'");
+      }
+#else
+      int fd = ::open(fileName.c_str(), O_LARGEFILE | O_RDONLY);
+      if (fd == -1)
+        THROW_SG_ERROR("could not open file '" + fileName + "'");
+      struct stat st;
+      if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        THROW_SG_ERROR("could not stat file '" + fileName + "'");
+      }
+      size = st.st_size;
+      void *mem = size ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+      // the mapping stays valid after closing the descriptor
+      ::close(fd);
+      if (mem == MAP_FAILED)
+        THROW_SG_ERROR("could not map file '" + fileName + "'");
+      base = (const unsigned char *)mem;
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+#ifdef _WIN32
+      UnmapViewOfFile(base);
+      CloseHandle(mappingHandle);
+      CloseHandle(fileHandle);
+#else
+      munmap((void *)base, size);
+#endif
+    }
+
   } // ::ospray::sg
 } // ::ospray
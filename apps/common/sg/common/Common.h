@@ -30,6 +30,7 @@
 
 // ospcommon
 #include "ospcommon/AffineSpace.h"
+#include "ospcommon/tasking/parallel_for.h"
 
 // ospray API
 #include "ospray/ospray.h"
@@ -69,6 +70,36 @@ namespace ospray {
     //! map the given file to memory and return that pointer
     const unsigned char* mapFile(const std::string &fileName);
 
+    /*! read-only memory mapping of a whole file, unmapped on destruction;
+        throws if the file cannot be mapped */
+    struct OSPSG_INTERFACE MappedFile
+    {
+      MappedFile(const std::string &fileName);
+      ~MappedFile();
+
+      MappedFile(const MappedFile &) = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+
+      const unsigned char *base {nullptr};
+      size_t size {0};
+
+    private:
+      void *fileHandle {nullptr};    //!< only used on Windows
+      void *mappingHandle {nullptr}; //!< only used on Windows
+    };
+
+    /*! run f(begin, end) for [0, n) in parallel, split into blocks of
+        (at most) blockSize items */
+    template <typename F>
+    inline void parallel_in_blocks(size_t n, size_t blockSize, F &&f)
+    {
+      const size_t numBlocks = (n + blockSize - 1) / blockSize;
+      ospcommon::tasking::parallel_for(numBlocks, [&](size_t blockID) {
+        const size_t begin = blockID * blockSize;
+        f(begin, std::min(begin + blockSize, n));
+      });
+    }
+
   } // ::ospray::sg
 } // ::ospray
 
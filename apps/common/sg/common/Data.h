@@ -94,6 +94,11 @@ namespace ospray {
       DataArrayT(T *base, size_t size, bool mine = true)
         : DataBuffer((OSPDataType)TID), numElements(size),
           mine(mine), base_ptr(base) {}
+      /*! reference memory owned by someone else, which is kept alive
+          (e.g. a mapped file) as long as this array exists */
+      DataArrayT(T *base, size_t size, std::shared_ptr<const void> owner)
+        : DataBuffer((OSPDataType)TID), numElements(size),
+          mine(false), base_ptr(base), owner(owner) {}
       ~DataArrayT() { if (mine && base_ptr) delete base_ptr; }
 
       std::string toString() const override
@@ -114,6 +119,7 @@ namespace ospray {
       size_t  numElements {0};
       bool    mine {false};
       T      *base_ptr {nullptr};
+      std::shared_ptr<const void> owner;
     };
 
     using DataArray1uc = DataArrayT<unsigned char, OSP_UCHAR>;
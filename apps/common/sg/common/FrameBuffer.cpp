@@ -23,6 +23,7 @@ namespace ospray {
     {
       createChild("size", "vec2i", size);
       createChild("displayWall", "string", std::string(""));
+      createChild("denoise", "bool", false);
       createFB();
     }
 
@@ -30,10 +31,18 @@ namespace ospray {
     {
       std::string displayWall = child("displayWall").valueAs<std::string>();
       this->displayWallStream = displayWall;
+      this->denoise = child("denoise").valueAs<bool>();
 
       destroyFB();
       createFB();
 
+      if (denoise && displayWall == "") {
+        OSPPixelOp pixelOp = ospNewPixelOp("denoise");
+        ospCommit(pixelOp);
+        ospSetPixelOp(ospFrameBuffer,pixelOp);
+        ospRelease(pixelOp);
+      }
+
       if (displayWall != "") {
         ospLoadModule("displayWald");
         OSPPixelOp pixelOp = ospNewPixelOp("display_wald");
@@ -98,7 +107,9 @@ namespace ospray {
                                          ? OSP_FB_SRGBA
                                          : OSP_FB_NONE,
                                          OSP_FB_COLOR | OSP_FB_ACCUM |
-                                         OSP_FB_VARIANCE);
+                                         OSP_FB_VARIANCE |
+                                         (denoise ? OSP_FB_NORMAL |
+                                                    OSP_FB_ALBEDO : 0));
       clearAccum();
       setValue(ospFrameBuffer);
     }
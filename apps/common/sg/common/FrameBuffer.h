@@ -53,6 +53,8 @@ namespace ospray {
 
       OSPFrameBuffer ospFrameBuffer {nullptr};
       std::string displayWallStream;
+      //! attach the 'denoise' pixel op (with normal and albedo channels)
+      bool denoise {false};
     };
 
   } // ::ospray::sg
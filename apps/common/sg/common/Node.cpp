@@ -18,6 +18,8 @@
 #include "sg/common/Data.h"
 #include "sg/common/Texture2D.h"
 #include "sg/common/RenderContext.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
 
 namespace ospray {
   namespace sg {
@@ -202,6 +204,12 @@ namespace ospray {
       return properties.childrenMTime;
     }
 
+    bool Node::needsCommit() const
+    {
+      return lastModified() >= lastCommitted() ||
+             childrenLastModified() >= lastCommitted();
+    }
+
     void Node::markAsCommitted()
     {
       properties.lastCommitted = TimeStamp();
@@ -216,11 +224,17 @@ namespace ospray {
 
     void Node::setChildrenModified(TimeStamp t)
     {
-      if (t > properties.childrenMTime) {
+      // NOTE: siblings committed in parallel all propagate up into the
+      //       same parent
+      {
+        std::lock_guard<std::mutex> lock{value_mutex};
+        if (t <= properties.childrenMTime)
+          return;
         properties.childrenMTime = t;
-        if (hasParent())
-          parent().setChildrenModified(properties.childrenMTime);
       }
+
+      if (hasParent())
+        parent().setChildrenModified(t);
     }
 
     // Parent-child structual interface ///////////////////////////////////////
@@ -391,8 +405,12 @@ namespace ospray {
 
       if (traverseChildren)
       {
-        for (auto &child : properties.children)
-          child.second->traverse(ctx, operation);
+        if (operation == "commit")
+          commitChildren(ctx);
+        else {
+          for (auto &child : properties.children)
+            child.second->traverse(ctx, operation);
+        }
       }
 
       ctx.level--;
@@ -422,8 +440,7 @@ namespace ospray {
           std::cout << valueAs<vec2i>();
         std::cout << "\"\n";
       } else if (operation == "commit") {
-       if (lastModified() >= lastCommitted() ||
-                childrenLastModified() >= lastCommitted())
+        if (needsCommit())
           preCommit(ctx);
         else
           traverseChildren = false;
@@ -439,9 +456,7 @@ namespace ospray {
 
     void Node::postTraverse(RenderContext &ctx, const std::string& operation)
     {
-      if (operation == "commit" &&
-          (lastModified() >= lastCommitted() ||
-           childrenLastModified() >= lastCommitted())) {
+      if (operation == "commit" && needsCommit()) {
         postCommit(ctx);
         markAsCommitted();
       } else if (operation == "verify") {
@@ -456,6 +471,51 @@ namespace ospray {
     {
     }
 
+    bool Node::commitChildrenInParallel() const
+    {
+      return false;
+    }
+
+    void Node::commitChildren(RenderContext &ctx)
+    {
+      // only visit the dirty set, clean subtrees would early-out in
+      // preTraverse() anyways
+      std::vector<Node*> dirty;
+      for (auto &child : properties.children) {
+        if (child.second->isValid() && child.second->needsCommit())
+          dirty.push_back(child.second.get());
+      }
+
+      if (!ctx.parallelCommit || !commitChildrenInParallel()) {
+        for (auto *child : dirty)
+          child->traverse(ctx, "commit");
+        return;
+      }
+
+      // parameter children set their value on our own OSPObject, so they
+      // must not run concurrently; children owning an OSPObject are
+      // independent subtrees and get committed in parallel, each with
+      // its own copy of the context
+      std::vector<Node*> subtrees;
+      for (auto *child : dirty) {
+        if (child->valueIsType<OSPObject>() && child->numChildren() > 0)
+          subtrees.push_back(child);
+        else
+          child->traverse(ctx, "commit");
+      }
+
+      if (subtrees.size() < 2) {
+        for (auto *child : subtrees)
+          child->traverse(ctx, "commit");
+        return;
+      }
+
+      tasking::parallel_for(subtrees.size(), [&](int taskIndex) {
+        RenderContext subtreeCtx = ctx;
+        subtrees[taskIndex]->traverse(subtreeCtx, "commit");
+      });
+    }
+
     void Node::postCommit(RenderContext &ctx)
     {
     }
@@ -158,6 +158,9 @@ namespace ospray {
       TimeStamp lastCommitted() const;
       TimeStamp childrenLastModified() const;
 
+      //! node or any of its children changed since the last commit
+      bool needsCommit() const;
+
       void markAsCommitted();
       virtual void markAsModified();
       virtual void setChildrenModified(TimeStamp t);
@@ -236,6 +239,13 @@ namespace ospray {
 
     protected:
 
+      //! commit the dirty children of this node, see traverse()
+      void commitChildren(RenderContext &ctx);
+
+      //! whether children owning their own OSPObject may be committed
+      //  concurrently (only done if the RenderContext allows it)
+      virtual bool commitChildrenInParallel() const;
+
       struct
       {
         std::string name;
@@ -46,6 +46,10 @@ namespace ospray {
       OSPRenderer ospRenderer {nullptr};
       int level {0};
 
+      //! commit independent subtrees concurrently, requires the device
+      //  to accept API calls from multiple threads
+      bool parallelCommit {false};
+
 
       TimeStamp _MTime;
       TimeStamp _childMTime;
@@ -59,7 +63,8 @@ namespace ospray {
         currentOSPModel(nullptr),
         currentTransform(newXfm),
         ospRenderer(nullptr),
-        level(0)
+        level(0),
+        parallelCommit(other.parallelCommit)
     {}
 
     inline TimeStamp RenderContext::MTime()
@@ -69,6 +69,13 @@ namespace ospray {
       return (OSPModel)valueAs<OSPObject>();
     }
 
+    bool Model::commitChildrenInParallel() const
+    {
+      // geometries, volumes and instances of a model only get added to
+      // it after they are all committed (see postCommit())
+      return true;
+    }
+
     std::string World::toString() const
     {
       return "ospray::sg::World";
@@ -195,15 +202,33 @@ namespace ospray {
       updateTransform(ctx);
       cachedTransform=ctx.currentTransform;
 
-      if (ospInstance)
+      auto model = child("model").valueAs<OSPModel>();
+
+      if (ospInstance && model != instancedModel) {
         ospRelease(ospInstance);
-      ospInstance = nullptr;
+        ospInstance = nullptr;
+      }
 
-      auto model = child("model").valueAs<OSPModel>();
-      if (model) {
+      if (!model) {
+        instancedModel = nullptr;
+        instanceDirty = false;
+        return;
+      }
+
+      // a changed transform only needs to update the existing instance,
+      // the new xfm is picked up when the parent model gets committed
+      if (ospInstance) {
+        const affine3f &xfm = worldTransform;
+        ospSet3f(ospInstance, "xfm.l.vx", xfm.l.vx.x, xfm.l.vx.y, xfm.l.vx.z);
+        ospSet3f(ospInstance, "xfm.l.vy", xfm.l.vy.x, xfm.l.vy.y, xfm.l.vy.z);
+        ospSet3f(ospInstance, "xfm.l.vz", xfm.l.vz.x, xfm.l.vz.y, xfm.l.vz.z);
+        ospSet3f(ospInstance, "xfm.p", xfm.p.x, xfm.p.y, xfm.p.z);
+      } else {
         ospInstance = ospNewInstance(model,(osp::affine3f&)worldTransform);
-        ospCommit(ospInstance);
+        instancedModel = model;
       }
+
+      ospCommit(ospInstance);
       instanceDirty=false;
     }
 
@@ -40,6 +40,8 @@ namespace ospray {
 
     protected:
 
+      virtual bool commitChildrenInParallel() const override;
+
       OSPModel stashedModel{nullptr};
     };
 
@@ -92,6 +94,8 @@ namespace ospray {
       void updateInstance(RenderContext &ctx);
       void updateTransform(RenderContext &ctx);
       bool instanceDirty{true};
+      //! model the current ospInstance was created for
+      OSPModel instancedModel{nullptr};
       ospcommon::affine3f cachedTransform{ospcommon::one};
       ospcommon::affine3f worldTransform{ospcommon::one};
       //    computed from baseTransform*position*rotation*scale
@@ -0,0 +1,112 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include <cstdint>
+
+/*! \file BinaryScene.h on-disk layout of the '.ospb' binary scene format.
+
+    An .ospb file is loaded by mapping it into memory, it is never
+    parsed: all arrays are stored at 64 byte aligned file offsets and
+    directly referenced (OSP_DATA_SHARED_BUFFER) by the data nodes
+    created when loading. All values are stored in native (i.e., little
+    endian) byte order.
+
+    Layout:
+
+      BinarySceneHeader
+      BinarySceneNode[numNodes]   (at nodesOffset)
+      string table                (at stringsOffset, '\0' terminated)
+      arrays                      (each at its node's arrayOffset)
+
+    The node table stores the scene graph in pre-order, i.e., a node's
+    parent always precedes it; node 0 is the root. A node which is
+    child of several parents (e.g., a shared material) is stored once,
+    further occurrences are references to it.
+*/
+
+namespace ospray {
+  namespace sg {
+
+    static const char     BINARY_SCENE_MAGIC[8] = {'O','S','P','B','S','C','N','\0'};
+    static const uint32_t BINARY_SCENE_VERSION  = 1;
+    static const uint64_t BINARY_SCENE_ALIGNMENT = 64;
+    static const uint32_t BINARY_SCENE_NO_NODE  = uint32_t(-1);
+
+    /*! what kind of value (or payload) a node carries */
+    enum BinarySceneValueKind : uint32_t
+    {
+      BSV_NONE = 0,
+      BSV_FLOAT,
+      BSV_INT,
+      BSV_BOOL,       //!< stored as int32
+      BSV_STRING,     //!< uint32 string table offset
+      BSV_VEC2F,
+      BSV_VEC3F,
+      BSV_VEC4F,
+      BSV_VEC2I,
+      BSV_VEC3I,
+      BSV_BOX3F,
+      BSV_AFFINE3F,
+      BSV_ARRAY,      //!< a DataBuffer, the node's array holds the elements
+      BSV_TEXTURE2D,  //!< a Texture2D, value is a BinarySceneTexture, the
+                      //!< array holds the texels
+    };
+
+    struct BinarySceneHeader
+    {
+      char     magic[8];
+      uint32_t version;
+      uint32_t numNodes;
+      uint64_t nodesOffset;
+      uint64_t stringsOffset;
+      uint64_t stringsSize;
+      uint64_t fileSize;
+      uint64_t reserved[2];
+    };
+
+    struct BinarySceneNode
+    {
+      uint32_t slot;       //!< string offset: name under which the parent holds it
+      uint32_t name;       //!< string offset: the node's own name
+      uint32_t type;       //!< string offset: registered sg node type
+      uint32_t parent;     //!< parent node index, NO_NODE for the root
+      uint32_t reference;  //!< index of the referenced node, or NO_NODE
+      uint32_t valueKind;  //!< BinarySceneValueKind
+      uint32_t arrayType;  //!< OSPDataType of the array elements
+      uint32_t bytesPerElement;
+      uint64_t arrayOffset;
+      uint64_t arrayCount; //!< number of array elements
+      uint8_t  value[48];  //!< the value, see BinarySceneValueKind
+    };
+
+    struct BinarySceneTexture
+    {
+      int32_t width, height;
+      int32_t channels;
+      int32_t depth;
+      int32_t preferLinear;
+      int32_t texelType;
+    };
+
+    static_assert(sizeof(BinarySceneHeader) == 64,
+                  "BinarySceneHeader must not contain padding");
+    static_assert(sizeof(BinarySceneNode) == 96,
+                  "BinarySceneNode must not contain padding");
+
+  } // ::ospray::sg
+} // ::ospray
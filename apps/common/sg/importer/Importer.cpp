@@ -147,10 +147,17 @@ namespace ospray {
       if (loadedFileName != "" || fileName.str() == "")
         return; //TODO: support dynamic re-loading, need to clear children first
 
-      loadedFileName = "";
-
       auto wsg = this->nodeAs<Node>();
 
+      if (importFileByExtension(wsg, fileName))
+        loadedFileName = fileName.str();
+    }
+
+    bool importFileByExtension(const std::shared_ptr<Node> &world,
+                               const FileName &fileName)
+    {
+      auto wsg = world;
+
       std::shared_ptr<FormatURL> fu;
       try {
         fu = std::make_shared<FormatURL>(fileName.c_str());
@@ -166,8 +173,7 @@ namespace ospray {
            looks up right function based on loaded symbols... */
         if (fu->formatType == "points" || fu->formatType == "spheres") {
           importFileType_points(wsg,fileName);
-          loadedFileName = fileName;
-          return;
+          return true;
         } else
           std::cout << "Found a URL-style file type specified, but didn't recognize file type '" << fu->formatType<< "' ... reverting to loading by file extension" << std::endl;
       }
@@ -186,16 +192,18 @@ namespace ospray {
         sg::importRIVL(wsg, fileName);
       } else if (ext == "xyz" || ext == "xyz2" || ext == "xyz3") {
         sg::importXYZ(wsg, fileName);
+      } else if (ext == "ospb") {
+        sg::loadBinaryScene(wsg, fileName);
 #ifdef OSPRAY_APPS_SG_VTK
       } else if (ext == "vtu" || ext == "off") {
         sg::importTetVolume(wsg, fileName);
 #endif
       } else {
         std::cout << "unsupported file format\n";
-        return;
+        return false;
       }
 
-      loadedFileName = fileName.str();
+      return true;
     }
 
     OSP_REGISTER_SG_NODE(Importer);
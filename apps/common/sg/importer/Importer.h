@@ -143,5 +143,25 @@ namespace ospray {
     void writeOSPSG(const std::shared_ptr<Node> &world,
                     const std::string &fileName);
 
+    /*! load an .ospb binary scene (see BinaryScene.h) by mapping it into
+        memory; the data arrays of the loaded nodes directly reference
+        the mapped file */
+    OSPSG_INTERFACE
+    void loadBinaryScene(const std::shared_ptr<Node> &world,
+                         const std::string &fileName);
+
+    /*! write the given node and all of its children as .ospb binary
+        scene */
+    OSPSG_INTERFACE
+    void writeBinaryScene(const std::shared_ptr<Node> &root,
+                          const std::string &fileName);
+
+    /*! import the given file (or file format url) into 'world', picking
+        the importer by file extension; returns false if the format is
+        not supported */
+    OSPSG_INTERFACE
+    bool importFileByExtension(const std::shared_ptr<Node> &world,
+                               const FileName &fileName);
+
   } // ::ospray::sg
 } // ::ospray
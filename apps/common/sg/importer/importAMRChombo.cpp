@@ -20,8 +20,13 @@
 // hdf
 #include "ospcommon/range.h"
 #include "ospcommon/box.h"
+#include "ospcommon/tasking/parallel_for.h"
 
 #include "hdf5.h"
+// stl
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
 namespace ospray {
 
@@ -45,24 +50,21 @@ namespace ospray {
         return boxes[boxID].size() + 1;
       }
 
-      inline double getValue(int boxID, int compID, const vec3i &coordNoGhost)
+      inline vec3i boxSizeWithGhosts(const int boxID) const
       {
-        assert(compID >= 0);
-        const vec3i sizeNoGhosts   = boxSize(boxID);
-        const vec3i sizeWithGhosts = sizeNoGhosts + 2 * numGhostCells;
-        size_t brickOfs            = offsets[boxID] +
-                          compID * (size_t)sizeWithGhosts.x *
-                              (size_t)sizeWithGhosts.y *
-                              (size_t)sizeWithGhosts.z;
-        const vec3i coordWithGhosts = coordNoGhost + numGhostCells;
-        return data[brickOfs + coordWithGhosts.x +
-                    sizeWithGhosts.x * (coordWithGhosts.y +
-                                        sizeWithGhosts.y * coordWithGhosts.z)];
+        return boxSize(boxID) + 2 * numGhostCells;
+      }
+
+      /*! number of values one component of the given box has in the
+          file, ghost cells included */
+      inline size_t numValuesWithGhosts(const int boxID) const
+      {
+        const vec3i size = boxSizeWithGhosts(boxID);
+        return size_t(size.x) * size_t(size.y) * size_t(size.z);
       }
 
       std::vector<box3i> boxes;
       std::vector<int64_t> offsets;
-      std::vector<double> data;
 
       box3f getWorldBounds(const int boxID) const;
       box3f getWorldBounds() const;
@@ -72,14 +74,25 @@ namespace ospray {
     //!   file loading
     struct AMR
     {
+      ~AMR();
+
+      std::string fileName;
       std::vector<Level *> level;
       //! array of component names
       std::vector<std::string> component;
 
+      /*! parse the level structure (boxes, offsets, ...) of the given
+          file; the voxel data itself gets read by readBricks() */
       static AMR *parse(const std::string &fileName, int maxLevel = 1 << 30);
       box3f getWorldBounds() const;
     };
 
+    AMR::~AMR()
+    {
+      for (auto *l : level)
+        delete l;
+    }
+
     //! parses out level data from hdf5 files
     void parseBoxes(hid_t file, Level *level)
     {
@@ -140,30 +153,6 @@ namespace ospray {
       H5Dclose(data);
     }
 
-    //! parse scalar data from hdf5 file
-    void parseData(hid_t file, Level *level)
-    {
-      herr_t status;
-      char dataName[1000];
-      sprintf(dataName, "level_%i/data:datatype=0", level->levelID);
-      hid_t data         = H5Dopen(file, dataName, H5P_DEFAULT);
-      hid_t space        = H5Dget_space(data);
-      const size_t nDims = H5Sget_simple_extent_ndims(space);
-      hsize_t dims[nDims];
-      H5Sget_simple_extent_dims(space, dims, NULL);
-      size_t numData = dims[0];
-
-      level->data.resize(numData);
-      H5Dread(data,
-              H5T_NATIVE_DOUBLE,
-              H5S_ALL,
-              H5S_ALL,
-              H5P_DEFAULT,
-              &level->data[0]);
-
-      H5Dclose(data);
-    }
-
     //! parse attributes in hdf5 amr data
     void parseDataAttributes(hid_t file,
                              Level *level,
@@ -192,7 +181,6 @@ namespace ospray {
 
       parseDataAttributes(file, level, levelName);
       parseBoxes(file, level);
-      parseData(file, level);
       parseOffsets(file, level);
 
       ospLogF(1) << "read input level #" << level->levelID << ", cellWidth is "
@@ -203,6 +191,7 @@ namespace ospray {
     AMR *AMR::parse(const std::string &fileName, int maxLevel)
     {
       AMR *cd           = new AMR;
+      cd->fileName      = fileName;
       char *maxLevelEnv = getenv("AMR_MAX_LEVEL");
       if (maxLevelEnv) {
         maxLevel = atoi(maxLevelEnv);
@@ -282,6 +271,117 @@ namespace ospray {
       return cd;
     }
 
+    /*! read component 'compID' of every box of every level, with the
+        ghost cells stripped, into 'brickPtrs' (one per box, boxes in
+        level order); returns the number of bytes read from the file */
+    size_t readBricks(const AMR &amr,
+                      int compID,
+                      const range1f *clampRange,
+                      float *const *brickPtrs,
+                      range1f &valueRange)
+    {
+      hid_t file = H5Fopen(amr.fileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      if (file < 0)
+        throw std::runtime_error("could not open AMR HDF file '" +
+                                 amr.fileName + "'");
+
+      struct BoxRef
+      {
+        const Level *level;
+        int boxID;
+        hid_t data;
+      };
+
+      std::vector<hid_t> levelData;
+      std::vector<BoxRef> boxes;
+      size_t numBytes = 0;
+      for (const auto *level : amr.level) {
+        char dataName[1000];
+        sprintf(dataName, "level_%i/data:datatype=0", level->levelID);
+        hid_t data = H5Dopen(file, dataName, H5P_DEFAULT);
+        if (data < 0) {
+          for (auto d : levelData)
+            H5Dclose(d);
+          H5Fclose(file);
+          throw std::runtime_error("could not open '" +
+                                   std::string(dataName) + "'");
+        }
+        levelData.push_back(data);
+
+        for (int boxID = 0; boxID < level->boxes.size(); boxID++) {
+          boxes.push_back({level, boxID, data});
+          numBytes += level->numValuesWithGhosts(boxID) * sizeof(double);
+        }
+      }
+
+      // HDF5 is not reentrant (and thread-safe builds serialize on a
+      // global lock anyway), so the file I/O is serial: the hyperslab
+      // reads are done one at a time, only the per box work after them
+      // (ghost stripping, clamping, value range) runs in parallel with
+      // the reads of the other boxes
+      std::mutex hdf5Mutex;
+      std::vector<range1f> boxRanges(boxes.size());
+      std::atomic<bool> readFailed(false);
+
+      tasking::parallel_for(boxes.size(), [&](size_t i) {
+        const BoxRef &ref   = boxes[i];
+        const Level &level  = *ref.level;
+        const vec3i size    = level.boxSize(ref.boxID);
+        const vec3i sizeWithGhosts = level.boxSizeWithGhosts(ref.boxID);
+        const vec3i &ghosts = level.numGhostCells;
+
+        // only the requested component's slab of this box
+        const hsize_t count = level.numValuesWithGhosts(ref.boxID);
+        const hsize_t start = level.offsets[ref.boxID] + compID * count;
+        std::vector<double> values(count);
+
+        {
+          std::lock_guard<std::mutex> lock(hdf5Mutex);
+          hid_t fileSpace = H5Dget_space(ref.data);
+          hid_t memSpace  = H5Screate_simple(1, &count, NULL);
+          H5Sselect_hyperslab(
+              fileSpace, H5S_SELECT_SET, &start, NULL, &count, NULL);
+          if (H5Dread(ref.data,
+                      H5T_NATIVE_DOUBLE,
+                      memSpace,
+                      fileSpace,
+                      H5P_DEFAULT,
+                      values.data()) < 0)
+            readFailed = true;
+          H5Sclose(memSpace);
+          H5Sclose(fileSpace);
+        }
+
+        float *out = brickPtrs[i];
+        for (int iz = 0; iz < size.z; iz++)
+          for (int iy = 0; iy < size.y; iy++) {
+            const double *in = values.data() + ghosts.x +
+                sizeWithGhosts.x * (size_t(iy + ghosts.y) +
+                                    sizeWithGhosts.y * size_t(iz + ghosts.z));
+            for (int ix = 0; ix < size.x; ix++) {
+              float v = in[ix];
+              if (clampRange)
+                v = clampRange->clamp(v);
+              boxRanges[i].extend(v);
+              *out++ = v;
+            }
+          }
+      });
+
+      for (auto data : levelData)
+        H5Dclose(data);
+      H5Fclose(file);
+
+      if (readFailed)
+        throw std::runtime_error("could not read AMR data from '" +
+                                 amr.fileName + "'");
+
+      for (const auto &r : boxRanges)
+        valueRange.extend(r);
+
+      return numBytes;
+    }
+
     //! get bounds for leaf level
     box3f Level::getWorldBounds(const int boxID) const
     {
@@ -329,6 +429,8 @@ namespace ospray {
                             const range1f *clampRange,
                             int maxLevel)
     {
+      const auto startTime = std::chrono::steady_clock::now();
+
       amr::AMR *amr = ospray::amr::AMR::parse(fileName.str(), maxLevel);
       assert(!amr->level.empty());
 
@@ -366,25 +468,25 @@ namespace ospray {
           bi.level = levelID;
 
           node->brickInfo.push_back(bi);
-
-          size_t numValues = bi.size().product();
-          float *f         = new float[numValues];
-          node->brickPtrs.push_back(f);
-          for (int iz = 0; iz < bi.size().z; iz++)
-            for (int iy = 0; iy < bi.size().y; iy++)
-              for (int ix = 0; ix < bi.size().x; ix++) {
-                vec3i coord(ix, iy, iz);
-                double v = level->getValue(brickID, node->componentID, coord);
-                if (clampRange)
-                  v = clampRange->clamp(v);
-                node->valueRange.extend(v);
-                *f++ = v;
-              }
         }
-        level->data.clear();
       }
-      ospLogF(1) << "found " << node->brickInfo.size() << " bricks"
-                 << std::endl;
+
+      // all boxes get decoded straight into the node's brick buffers
+      node->allocateBricks();
+      const size_t numBytes = amr::readBricks(*amr,
+                                              node->componentID,
+                                              clampRange,
+                                              node->brickPtrs.data(),
+                                              node->valueRange);
+      delete amr;
+
+      const double seconds = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - startTime).count();
+      const double megaBytes = numBytes / (1024.0 * 1024.0);
+      ospLogF(1) << "#osp:sg: read " << node->brickInfo.size()
+                 << " amr bricks (" << megaBytes << "MB) from '"
+                 << fileName.str() << "' in " << seconds << "s, "
+                 << megaBytes / seconds << " MB/s" << std::endl;
     }
 
   }  // ::ospray::sg
@@ -0,0 +1,541 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "SceneGraph.h"
+#include "BinaryScene.h"
+#include "sg/common/Texture2D.h"
+#include "sg/volume/AMRVolume.h"
+// stl
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace ospray {
+  namespace sg {
+
+    // ------------------------------------------------------------------
+    // array types
+    // ------------------------------------------------------------------
+
+    /*! creates a data array node referencing 'count' elements at 'ptr';
+        returns nullptr for unsupported element types */
+    template <typename ARRAY_T>
+    static std::shared_ptr<DataBuffer>
+    makeArray(const void *ptr, size_t count, size_t bytesPerElement,
+              const std::shared_ptr<const void> &owner)
+    {
+      using T = typename ARRAY_T::ElementType;
+      if (bytesPerElement != sizeof(T))
+        return nullptr;
+      return std::make_shared<ARRAY_T>((T*)ptr, count, owner);
+    }
+
+    static std::shared_ptr<DataBuffer>
+    createArray(OSPDataType type, const void *ptr, size_t count,
+                size_t bytesPerElement,
+                const std::shared_ptr<const void> &owner)
+    {
+      switch (type) {
+      case OSP_UCHAR: // == OSP_RAW
+        return makeArray<DataArray1uc>(ptr, count, bytesPerElement, owner);
+      case OSP_FLOAT:
+        return makeArray<DataArray1f>(ptr, count, bytesPerElement, owner);
+      case OSP_FLOAT2:
+        return makeArray<DataArray2f>(ptr, count, bytesPerElement, owner);
+      case OSP_FLOAT3:
+        return makeArray<DataArray3f>(ptr, count, bytesPerElement, owner);
+      case OSP_FLOAT3A:
+        return makeArray<DataArray3fa>(ptr, count, bytesPerElement, owner);
+      case OSP_FLOAT4:
+        return makeArray<DataArray4f>(ptr, count, bytesPerElement, owner);
+      case OSP_INT:
+        return makeArray<DataArray1i>(ptr, count, bytesPerElement, owner);
+      case OSP_INT2:
+        return makeArray<DataArray2i>(ptr, count, bytesPerElement, owner);
+      case OSP_INT3:
+        return makeArray<DataArray3i>(ptr, count, bytesPerElement, owner);
+      case OSP_INT4:
+        return makeArray<DataArray4i>(ptr, count, bytesPerElement, owner);
+      default:
+        return nullptr;
+      }
+    }
+
+    static bool isStorableArrayType(OSPDataType type)
+    {
+      switch (type) {
+      case OSP_UCHAR: // == OSP_RAW
+      case OSP_FLOAT:
+      case OSP_FLOAT2:
+      case OSP_FLOAT3:
+      case OSP_FLOAT3A:
+      case OSP_FLOAT4:
+      case OSP_INT:
+      case OSP_INT2:
+      case OSP_INT3:
+      case OSP_INT4:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    // ------------------------------------------------------------------
+    // loading
+    // ------------------------------------------------------------------
+
+    template <typename T>
+    static inline T readValue(const BinarySceneNode &rec)
+    {
+      static_assert(sizeof(T) <= sizeof(rec.value),
+                    "value does not fit into BinarySceneNode::value");
+      T t;
+      memcpy((void *)&t, rec.value, sizeof(T));
+      return t;
+    }
+
+    static void setNodeValue(Node &node, const BinarySceneNode &rec,
+                             const char *strings)
+    {
+      switch (rec.valueKind) {
+      case BSV_FLOAT:
+        node.setValue(readValue<float>(rec));
+        break;
+      case BSV_INT:
+        node.setValue(readValue<int>(rec));
+        break;
+      case BSV_BOOL:
+        node.setValue(readValue<int32_t>(rec) != 0);
+        break;
+      case BSV_STRING:
+        node.setValue(std::string(strings + readValue<uint32_t>(rec)));
+        break;
+      case BSV_VEC2F:
+        node.setValue(readValue<vec2f>(rec));
+        break;
+      case BSV_VEC3F:
+        node.setValue(readValue<vec3f>(rec));
+        break;
+      case BSV_VEC4F:
+        node.setValue(readValue<vec4f>(rec));
+        break;
+      case BSV_VEC2I:
+        node.setValue(readValue<vec2i>(rec));
+        break;
+      case BSV_VEC3I:
+        node.setValue(readValue<vec3i>(rec));
+        break;
+      case BSV_BOX3F:
+        node.setValue(readValue<box3f>(rec));
+        break;
+      case BSV_AFFINE3F:
+        node.setValue(readValue<affine3f>(rec));
+        break;
+      default:
+        break;
+      }
+    }
+
+    /*! check all offsets of the file before touching anything, such
+        that a truncated or corrupt file fails cleanly */
+    static void validateBinaryScene(const MappedFile &file,
+                                    const std::string &fileName)
+    {
+      auto fail = [&](const std::string &why) {
+        throw std::runtime_error("#osp:sg: '" + fileName
+                                 + "' is not a valid .ospb file: " + why);
+      };
+
+      if (file.size < sizeof(BinarySceneHeader))
+        fail("file too small");
+
+      const auto &header = *(const BinarySceneHeader *)file.base;
+      if (memcmp(header.magic, BINARY_SCENE_MAGIC, sizeof(header.magic)))
+        fail("wrong magic number");
+      if (header.version != BINARY_SCENE_VERSION) {
+        fail("unsupported version " + std::to_string(header.version)
+             + " (expected " + std::to_string(BINARY_SCENE_VERSION) + ")");
+      }
+      if (header.fileSize != file.size)
+        fail("file is truncated");
+      if (header.numNodes == 0)
+        fail("no nodes");
+
+      // numNodes is 32 bits, so its byte size cannot overflow
+      const uint64_t nodesSize =
+          uint64_t(header.numNodes) * sizeof(BinarySceneNode);
+      if (header.nodesOffset % BINARY_SCENE_ALIGNMENT
+          || header.nodesOffset > file.size
+          || nodesSize > file.size - header.nodesOffset)
+        fail("node table out of bounds");
+      if (header.stringsSize == 0
+          || header.stringsOffset > file.size
+          || header.stringsSize > file.size - header.stringsOffset)
+        fail("string table out of bounds");
+
+      const char *strings = (const char *)file.base + header.stringsOffset;
+      if (strings[header.stringsSize-1] != '\0')
+        fail("string table not terminated");
+
+      const auto *nodes =
+          (const BinarySceneNode *)(file.base + header.nodesOffset);
+      for (uint32_t i = 0; i < header.numNodes; i++) {
+        const auto &rec = nodes[i];
+        if (rec.slot >= header.stringsSize || rec.name >= header.stringsSize
+            || rec.type >= header.stringsSize)
+          fail("string offset out of bounds");
+        if (i == 0 ? rec.parent != BINARY_SCENE_NO_NODE : rec.parent >= i)
+          fail("nodes are not stored in pre-order");
+        if (rec.reference != BINARY_SCENE_NO_NODE
+            && (rec.reference >= i || i == 0))
+          fail("invalid node reference");
+        if (i != 0 && nodes[rec.parent].reference != BINARY_SCENE_NO_NODE)
+          fail("node reference with children");
+        if (rec.reference != BINARY_SCENE_NO_NODE) {
+          // referencing an ancestor would make the graph cyclic; the
+          // ancestors are never references themselves (see above)
+          uint32_t target = rec.reference;
+          while (nodes[target].reference != BINARY_SCENE_NO_NODE)
+            target = nodes[target].reference;
+          for (uint32_t p = rec.parent; p != BINARY_SCENE_NO_NODE;
+               p = nodes[p].parent) {
+            if (p == target)
+              fail("node references its own ancestor");
+          }
+        }
+        if (rec.valueKind == BSV_STRING
+            && readValue<uint32_t>(rec) >= header.stringsSize)
+          fail("string offset out of bounds");
+        if (rec.valueKind == BSV_ARRAY || rec.valueKind == BSV_TEXTURE2D) {
+          const uint64_t bytes = rec.arrayCount * rec.bytesPerElement;
+          if (rec.bytesPerElement != 0
+              && bytes / rec.bytesPerElement != rec.arrayCount)
+            fail("array size overflow");
+          if (rec.arrayOffset % BINARY_SCENE_ALIGNMENT
+              || rec.arrayOffset > file.size
+              || bytes > file.size - rec.arrayOffset)
+            fail("array out of bounds");
+        }
+        if (rec.valueKind == BSV_TEXTURE2D) {
+          // the texels are bounded by the file size, hence the size of
+          // the texture cannot overflow once width*height fits
+          const auto info = readValue<BinarySceneTexture>(rec);
+          if (info.width <= 0 || info.height <= 0
+              || info.channels < 1 || info.channels > 4
+              || (info.depth != 1 && info.depth != 4)
+              || rec.bytesPerElement != 1)
+            fail("invalid texture format");
+          const uint64_t pixels = uint64_t(info.width) * info.height;
+          if (pixels > rec.arrayCount
+              || pixels * info.channels * info.depth != rec.arrayCount)
+            fail("texture size does not match its texel array");
+        }
+      }
+    }
+
+    void loadBinaryScene(const std::shared_ptr<Node> &world,
+                         const std::string &fileName)
+    {
+      auto file = std::make_shared<MappedFile>(fileName);
+      validateBinaryScene(*file, fileName);
+
+      const auto &header = *(const BinarySceneHeader *)file->base;
+      const auto *recs =
+          (const BinarySceneNode *)(file->base + header.nodesOffset);
+      const char *strings = (const char *)file->base + header.stringsOffset;
+
+      // the data arrays keep the mapping alive
+      std::shared_ptr<const void> owner = file;
+
+      std::vector<std::shared_ptr<Node>> nodes(header.numNodes);
+      nodes[0] = world;
+
+      for (uint32_t i = 1; i < header.numNodes; i++) {
+        const auto &rec = recs[i];
+        auto &parent = *nodes[rec.parent];
+        const std::string slot = strings + rec.slot;
+        const std::string name = strings + rec.name;
+        std::string type = strings + rec.type;
+        if (type.empty())
+          type = "Node";
+
+        if (rec.reference != BINARY_SCENE_NO_NODE) {
+          nodes[i] = nodes[rec.reference];
+          parent.setChild(slot, nodes[i]);
+          continue;
+        }
+
+        std::shared_ptr<Node> node;
+        const void *array = file->base + rec.arrayOffset;
+
+        if (rec.valueKind == BSV_ARRAY) {
+          node = createArray((OSPDataType)rec.arrayType, array, rec.arrayCount,
+                             rec.bytesPerElement, owner);
+          if (!node) {
+            throw std::runtime_error("#osp:sg: unsupported array type in '"
+                                     + fileName + "' (node '" + name + "')");
+          }
+          node->setName(name);
+          node->setType(type);
+        } else if (rec.valueKind == BSV_TEXTURE2D) {
+          auto tex = createNode(name, "Texture2D")->nodeAs<Texture2D>();
+          const auto info = readValue<BinarySceneTexture>(rec);
+          tex->size         = vec2i(info.width, info.height);
+          tex->channels     = info.channels;
+          tex->depth        = info.depth;
+          tex->preferLinear = info.preferLinear;
+          tex->texelType    = (OSPTextureFormat)info.texelType;
+          tex->texelData    =
+              std::make_shared<DataArray1uc>((unsigned char *)array,
+                                             rec.arrayCount, owner);
+          node = tex;
+        } else if (parent.hasChild(slot)
+                   && parent.child(slot).type() == type) {
+          // children created by the parent's constructor
+          node = parent.child(slot).shared_from_this();
+        } else {
+          node = createNode(name, type);
+        }
+
+        setNodeValue(*node, rec, strings);
+
+        if (!parent.hasChild(slot) || &parent.child(slot) != node.get())
+          parent.add(node, slot);
+
+        nodes[i] = node;
+      }
+
+      world->traverse("modified");
+    }
+
+    // ------------------------------------------------------------------
+    // writing
+    // ------------------------------------------------------------------
+
+    struct BinarySceneWriter
+    {
+      std::vector<BinarySceneNode> nodes;
+      std::vector<const void *>    arrays; //!< per node, or nullptr
+      std::string                  strings;
+      std::map<std::string, uint32_t> stringOffsets;
+      std::map<const Node *, uint32_t> written;
+
+      uint32_t addString(const std::string &s)
+      {
+        auto it = stringOffsets.find(s);
+        if (it != stringOffsets.end())
+          return it->second;
+        const uint32_t ofs = strings.size();
+        strings.append(s.c_str(), s.size() + 1);
+        stringOffsets[s] = ofs;
+        return ofs;
+      }
+
+      template <typename T>
+      static void storeValue(BinarySceneNode &rec, BinarySceneValueKind kind,
+                             const T &t)
+      {
+        static_assert(sizeof(T) <= sizeof(rec.value),
+                      "value does not fit into BinarySceneNode::value");
+        rec.valueKind = kind;
+        memcpy(rec.value, &t, sizeof(T));
+      }
+
+      void storeValue(BinarySceneNode &rec, const Any &v)
+      {
+        if (!v.valid())
+          return;
+        else if (v.is<float>())
+          storeValue(rec, BSV_FLOAT, v.get<float>());
+        else if (v.is<int>())
+          storeValue(rec, BSV_INT, v.get<int>());
+        else if (v.is<bool>())
+          storeValue(rec, BSV_BOOL, int32_t(v.get<bool>()));
+        else if (v.is<std::string>())
+          storeValue(rec, BSV_STRING, addString(v.get<std::string>()));
+        else if (v.is<vec2f>())
+          storeValue(rec, BSV_VEC2F, v.get<vec2f>());
+        else if (v.is<vec3f>())
+          storeValue(rec, BSV_VEC3F, v.get<vec3f>());
+        else if (v.is<vec4f>())
+          storeValue(rec, BSV_VEC4F, v.get<vec4f>());
+        else if (v.is<vec2i>())
+          storeValue(rec, BSV_VEC2I, v.get<vec2i>());
+        else if (v.is<vec3i>())
+          storeValue(rec, BSV_VEC3I, v.get<vec3i>());
+        else if (v.is<box3f>())
+          storeValue(rec, BSV_BOX3F, v.get<box3f>());
+        else if (v.is<affine3f>())
+          storeValue(rec, BSV_AFFINE3F, v.get<affine3f>());
+        // everything else (i.e., OSPObjects) is created on commit
+      }
+
+      void addNode(const std::string &slot, const std::shared_ptr<Node> &node,
+                   uint32_t parent)
+      {
+        BinarySceneNode rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.slot      = addString(slot);
+        rec.name      = addString(node->name());
+        rec.type      = addString(node->type());
+        rec.parent    = parent;
+        rec.reference = BINARY_SCENE_NO_NODE;
+
+        const void *array = nullptr;
+
+        auto it = written.find(node.get());
+        if (it != written.end()) {
+          rec.reference = it->second;
+          nodes.push_back(rec);
+          arrays.push_back(nullptr);
+          return;
+        }
+
+        if (auto buffer = std::dynamic_pointer_cast<DataBuffer>(node)) {
+          const OSPDataType type = buffer->getType();
+          if (!isStorableArrayType(type)) {
+            std::cerr << "#osp:sg: skipping data array '" << slot
+                      << "' of type " << stringForType(type)
+                      << " (cannot be stored in .ospb files)" << std::endl;
+            return;
+          }
+          // raw arrays (e.g. of spheres) may have any element size, they
+          // are stored byte-wise
+          rec.valueKind       = BSV_ARRAY;
+          rec.arrayType       = type;
+          rec.bytesPerElement = type == OSP_RAW ? 1 : buffer->bytesPerElement();
+          rec.arrayCount      = type == OSP_RAW ? buffer->numBytes()
+                                                : buffer->size();
+          array = buffer->base();
+        } else if (auto tex = std::dynamic_pointer_cast<Texture2D>(node)) {
+          array = tex->data ? tex->data
+                            : (tex->texelData ? tex->texelData->base()
+                                              : nullptr);
+          if (!array) {
+            std::cerr << "#osp:sg: skipping texture '" << slot
+                      << "' without texel data" << std::endl;
+            return;
+          }
+          BinarySceneTexture info;
+          info.width        = tex->size.x;
+          info.height       = tex->size.y;
+          info.channels     = tex->channels;
+          info.depth        = tex->depth;
+          info.preferLinear = tex->preferLinear;
+          info.texelType    = tex->texelType;
+          storeValue(rec, BSV_TEXTURE2D, info);
+          rec.arrayType       = OSP_UCHAR;
+          rec.bytesPerElement = 1;
+          rec.arrayCount      = size_t(tex->size.x) * tex->size.y
+                                * tex->channels * tex->depth;
+        } else {
+          // fail before anything gets written instead of writing a file
+          // that loads volumes without voxels
+          if (std::dynamic_pointer_cast<StructuredVolume>(node)
+              || std::dynamic_pointer_cast<AMRVolume>(node)) {
+            throw std::runtime_error("#osp:sg: cannot store volume '"
+                                     + node->name() + "' in .ospb files,"
+                                     " its voxels are kept outside of the"
+                                     " scene graph");
+          }
+          storeValue(rec, node->value());
+        }
+
+        const uint32_t index = nodes.size();
+        written[node.get()] = index;
+        nodes.push_back(rec);
+        arrays.push_back(array);
+
+        if (rec.valueKind == BSV_ARRAY || rec.valueKind == BSV_TEXTURE2D)
+          return;
+
+        for (auto &child : node->children())
+          addNode(child.first, child.second, index);
+      }
+
+      static uint64_t align(uint64_t ofs)
+      {
+        return (ofs + BINARY_SCENE_ALIGNMENT - 1)
+               / BINARY_SCENE_ALIGNMENT * BINARY_SCENE_ALIGNMENT;
+      }
+
+      void write(const std::string &fileName)
+      {
+        BinarySceneHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, BINARY_SCENE_MAGIC, sizeof(header.magic));
+        header.version       = BINARY_SCENE_VERSION;
+        header.numNodes      = nodes.size();
+        header.nodesOffset   = align(sizeof(header));
+        header.stringsOffset = header.nodesOffset
+                               + nodes.size() * sizeof(BinarySceneNode);
+        header.stringsSize   = strings.size();
+
+        uint64_t ofs = header.stringsOffset + header.stringsSize;
+        for (auto &rec : nodes) {
+          if (rec.valueKind == BSV_ARRAY || rec.valueKind == BSV_TEXTURE2D) {
+            ofs = align(ofs);
+            rec.arrayOffset = ofs;
+            ofs += rec.arrayCount * rec.bytesPerElement;
+          }
+        }
+        header.fileSize = ofs;
+
+        FILE *file = fopen(fileName.c_str(), "wb");
+        if (!file) {
+          throw std::runtime_error("#osp:sg: could not open file for writing '"
+                                   + fileName + "'");
+        }
+
+        uint64_t pos = 0;
+        auto put = [&](const void *ptr, uint64_t bytes) {
+          if (bytes && fwrite(ptr, 1, bytes, file) != bytes) {
+            fclose(file);
+            throw std::runtime_error("#osp:sg: error writing '"
+                                     + fileName + "'");
+          }
+          pos += bytes;
+        };
+        auto padTo = [&](uint64_t target) {
+          static const char zeros[BINARY_SCENE_ALIGNMENT] = {};
+          put(zeros, target - pos);
+        };
+
+        put(&header, sizeof(header));
+        padTo(header.nodesOffset);
+        put(nodes.data(), nodes.size() * sizeof(BinarySceneNode));
+        put(strings.data(), strings.size());
+        for (size_t i = 0; i < nodes.size(); i++) {
+          if (!arrays[i])
+            continue;
+          padTo(nodes[i].arrayOffset);
+          put(arrays[i], nodes[i].arrayCount * nodes[i].bytesPerElement);
+        }
+
+        fclose(file);
+      }
+    };
+
+    void writeBinaryScene(const std::shared_ptr<Node> &root,
+                          const std::string &fileName)
+    {
+      BinarySceneWriter writer;
+      writer.addNode(root->name(), root, BINARY_SCENE_NO_NODE);
+      writer.write(fileName);
+    }
+
+  } // ::ospray::sg
+} // ::ospray
@@ -24,7 +24,11 @@
 #define TINYOBJLOADER_IMPLEMENTATION  // define this in only *one* .cc
 #include "../3rdParty/tiny_obj_loader.h"
 
+#include <atomic>
+#include <climits>
+#include <cmath>
 #include <cstring>
+#include <map>
 #include <sstream>
 
 #define USE_INSTANCES 0
@@ -145,103 +149,568 @@ namespace ospray {
       return sgMaterials;
     }
 
-    void importOBJ(const std::shared_ptr<Node> &world, const FileName &fileName)
-    {
-      tinyobj::attrib_t attrib;
-      std::vector<tinyobj::shape_t> shapes;
-      std::vector<tinyobj::material_t> materials;
+    namespace obj {
+
+      /*! The OBJ file is mapped into memory and split into chunks which
+          end on line boundaries; the chunks are parsed in parallel and
+          then merged (prefix sums over the per chunk counts). Finally
+          the faces of each group are triangulated (as fans) into the
+          arrays of one TriangleMesh, again in parallel.
+
+          Line continuations ('\\' at the end of a line) are not
+          supported. */
+
+      //! bytes per parse task
+      static const size_t CHUNK_SIZE = 8 * 1024 * 1024;
+      //! faces per task when building the meshes
+      static const size_t FACE_BLOCK_SIZE = 64 * 1024;
+
+      //! one face corner, 0-based indices, -1 if not given (or invalid)
+      struct Corner
+      {
+        int v {-1};
+        int vt {-1};
+        int vn {-1};
+      };
+
+      /*! a corner index given relative to the end of the vertex list
+          (negative in the file); resolved when merging the chunks, as it
+          may refer to vertices of previous chunks */
+      struct RelativeIndex
+      {
+        size_t  corner;    //!< chunk local corner
+        int     attribute; //!< 0: v, 1: vt, 2: vn
+        int64_t index;     //!< chunk local, may be negative
+      };
+
+      enum EventType
+      {
+        GROUP,        //!< 'g' and 'o'
+        USE_MATERIAL, //!< 'usemtl'
+        MATERIAL_LIB  //!< 'mtllib'
+      };
+
+      //! a statement affecting all faces following it
+      struct Event
+      {
+        EventType   type;
+        size_t      face; //!< number of faces before the event
+        std::string name;
+      };
+
+      struct Chunk
+      {
+        std::vector<vec3f>         v;
+        std::vector<vec2f>         vt;
+        std::vector<vec3f>         vn;
+        std::vector<Corner>        corners;
+        std::vector<int>           faceSize;
+        std::vector<RelativeIndex> relative;
+        std::vector<Event>         events;
+      };
+
+      // Parsing //////////////////////////////////////////////////////////////
+
+      static inline bool isSpace(char c)
+      {
+        return c == ' ' || c == '\t' || c == '\r';
+      }
 
-      std::string err;
-      auto containingPath = fileName.path().str() + '/';
-      bool ret            = tinyobj::LoadObj(&attrib,
-                                  &shapes,
-                                  &materials,
-                                  &err,
-                                  fileName.c_str(),
-                                  containingPath.c_str());
-
-      if (!err.empty())
-        std::cerr << "#ospsg: obj parsing warning(s)...\n" << err << std::endl;
-
-      if (!ret) {
-        std::cerr << "#ospsg: FATAL error parsing obj file, no geometry added"
-                  << " to the scene!" << std::endl;
-        return;
+      static inline const char *skipSpace(const char *p, const char *end)
+      {
+        while (p < end && isSpace(*p))
+          p++;
+        return p;
       }
 
-      auto sgMaterials = createSgMaterials(materials, containingPath);
+      static inline bool isDigit(char c)
+      {
+        return c >= '0' && c <= '9';
+      }
 
-      std::string base_name = fileName.name() + '_';
-      int shapeId           = 0;
+      static inline bool parseInt(const char *&p, const char *end,
+                                  int64_t &value)
+      {
+        const char *q = p;
+        const bool negative = q < end && *q == '-';
+        if (q < end && (*q == '-' || *q == '+'))
+          q++;
+        if (q == end || !isDigit(*q))
+          return false;
+        int64_t i = 0;
+        while (q < end && isDigit(*q))
+          i = 10 * i + (*q++ - '0');
+        value = negative ? -i : i;
+        p = q;
+        return true;
+      }
 
-#if !USE_INSTANCES
-      auto objInstance = createNode("instance", "Instance");
-      world->add(objInstance);
-#endif
-      for (auto &shape : shapes) {
-        for (int numVertsInFace : shape.mesh.num_face_vertices) {
-          if (numVertsInFace != 3) {
-            std::cerr << "Warning: more thant 3 verts in face!";
-            PRINT(numVertsInFace);
+      /*! parses decimal floats (with optional exponent); does not rely on
+          a terminating '\\0', which the mapped file does not have */
+      static inline bool parseFloat(const char *&p, const char *end,
+                                    float &value)
+      {
+        static const double pow10[] = {
+          1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+          1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+          1e22
+        };
+
+        const char *q = p;
+        const bool negative = q < end && *q == '-';
+        if (q < end && (*q == '-' || *q == '+'))
+          q++;
+
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        int numDigits = 0;
+        bool anyDigits = false;
+
+        for (; q < end && isDigit(*q); q++, anyDigits = true) {
+          if (numDigits < 19) {
+            mantissa = 10 * mantissa + (*q - '0');
+            if (mantissa) numDigits++;
+          } else {
+            exponent++;
+          }
+        }
+        if (q < end && *q == '.') {
+          for (q++; q < end && isDigit(*q); q++, anyDigits = true) {
+            if (numDigits < 19) {
+              mantissa = 10 * mantissa + (*q - '0');
+              if (mantissa) numDigits++;
+              exponent--;
+            }
+          }
+        }
+        if (!anyDigits)
+          return false;
+
+        if (q < end && (*q == 'e' || *q == 'E')) {
+          const char *e = q + 1;
+          int64_t exp10 = 0;
+          if (parseInt(e, end, exp10)) {
+            exponent += int(std::max<int64_t>(-1000, std::min<int64_t>(1000, exp10)));
+            q = e;
           }
         }
 
-        auto name = base_name + std::to_string(shapeId++) + '_' + shape.name;
-        auto mesh = createNode(name, "TriangleMesh")->nodeAs<TriangleMesh>();
+        double d = double(mantissa);
+        if (mantissa != 0) {
+          if (exponent < 0 && exponent >= -22)
+            d /= pow10[-exponent];
+          else if (exponent > 0 && exponent <= 22)
+            d *= pow10[exponent];
+          else if (exponent != 0)
+            d *= std::pow(10.0, double(exponent));
+        }
 
-        auto v = createNode("vertex", "DataVector3f")->nodeAs<DataVector3f>();
-        auto numSrcIndices = shape.mesh.indices.size();
-        v->v.reserve(numSrcIndices);
+        value = float(negative ? -d : d);
+        p = q;
+        return true;
+      }
 
-        auto vi = createNode("index", "DataVector3i")->nodeAs<DataVector3i>();
-        vi->v.reserve(numSrcIndices / 3);
+      static inline std::string restOfLine(const char *p, const char *end)
+      {
+        while (end > p && isSpace(end[-1]))
+          end--;
+        return std::string(p, end);
+      }
 
-        auto vn = createNode("normal", "DataVector3f")->nodeAs<DataVector3f>();
-        vn->v.reserve(numSrcIndices);
+      static inline void setIndex(Chunk &chunk, int attribute, int64_t index,
+                                  int64_t count, int &target)
+      {
+        if (index > 0) {
+          target = index - 1 <= INT_MAX ? int(index - 1) : -1;
+        } else if (index < 0) {
+          chunk.relative.push_back({chunk.corners.size(), attribute,
+                                    count + index});
+        }
+      }
+
+      static void parseFace(const char *p, const char *end, Chunk &chunk)
+      {
+        int numCorners = 0;
+        int64_t index = 0;
+
+        while (p < end && parseInt(p, end, index)) {
+          Corner corner;
+          setIndex(chunk, 0, index, chunk.v.size(), corner.v);
+          if (p < end && *p == '/') {
+            p++;
+            if (parseInt(p, end, index))
+              setIndex(chunk, 1, index, chunk.vt.size(), corner.vt);
+            if (p < end && *p == '/') {
+              p++;
+              if (parseInt(p, end, index))
+                setIndex(chunk, 2, index, chunk.vn.size(), corner.vn);
+            }
+          }
+          chunk.corners.push_back(corner);
+          numCorners++;
+          p = skipSpace(p, end);
+        }
+
+        if (numCorners >= 3) {
+          chunk.faceSize.push_back(numCorners);
+        } else {
+          // degenerate face, drop its corners again
+          chunk.corners.resize(chunk.corners.size() - numCorners);
+          while (!chunk.relative.empty()
+                 && chunk.relative.back().corner >= chunk.corners.size())
+            chunk.relative.pop_back();
+        }
+      }
+
+      static inline bool keywordIs(const char *kw, size_t len, const char *s)
+      {
+        return len == strlen(s) && !strncmp(kw, s, len);
+      }
+
+      static void parseLine(const char *p, const char *end, Chunk &chunk)
+      {
+        p = skipSpace(p, end);
+        if (p == end || *p == '#')
+          return;
+
+        const char *kw = p;
+        while (p < end && !isSpace(*p))
+          p++;
+        const size_t kwLen = p - kw;
+        p = skipSpace(p, end);
+
+        if (keywordIs(kw, kwLen, "v")) {
+          vec3f v(0.f);
+          parseFloat(p, end, v.x);
+          p = skipSpace(p, end);
+          parseFloat(p, end, v.y);
+          p = skipSpace(p, end);
+          parseFloat(p, end, v.z);
+          chunk.v.push_back(v);
+        } else if (keywordIs(kw, kwLen, "vn")) {
+          vec3f n(0.f);
+          parseFloat(p, end, n.x);
+          p = skipSpace(p, end);
+          parseFloat(p, end, n.y);
+          p = skipSpace(p, end);
+          parseFloat(p, end, n.z);
+          chunk.vn.push_back(n);
+        } else if (keywordIs(kw, kwLen, "vt")) {
+          vec2f t(0.f);
+          parseFloat(p, end, t.x);
+          p = skipSpace(p, end);
+          parseFloat(p, end, t.y);
+          chunk.vt.push_back(t);
+        } else if (keywordIs(kw, kwLen, "f")) {
+          parseFace(p, end, chunk);
+        } else if (keywordIs(kw, kwLen, "g") || keywordIs(kw, kwLen, "o")) {
+          chunk.events.push_back({GROUP, chunk.faceSize.size(),
+                                  restOfLine(p, end)});
+        } else if (keywordIs(kw, kwLen, "usemtl")) {
+          chunk.events.push_back({USE_MATERIAL, chunk.faceSize.size(),
+                                  restOfLine(p, end)});
+        } else if (keywordIs(kw, kwLen, "mtllib")) {
+          chunk.events.push_back({MATERIAL_LIB, chunk.faceSize.size(),
+                                  restOfLine(p, end)});
+        }
+      }
+
+      static void parseChunk(const char *begin, const char *end, Chunk &chunk)
+      {
+        while (begin < end) {
+          const char *eol = (const char *)memchr(begin, '\n', end - begin);
+          if (!eol)
+            eol = end;
+          parseLine(begin, eol, chunk);
+          begin = eol + 1;
+        }
+      }
+
+      // Merging //////////////////////////////////////////////////////////////
+
+      //! the whole file, with all indices absolute
+      struct Scene
+      {
+        std::vector<vec3f>  v;
+        std::vector<vec2f>  vt;
+        std::vector<vec3f>  vn;
+        std::vector<Corner> corners;
+        //! first corner of each face, plus the end of the last face
+        std::vector<size_t> faceBegin;
+        std::vector<Event>  events;
+
+        size_t numFaces() const { return faceBegin.size() - 1; }
+      };
+
+      static void parseFile(const MappedFile &file, Scene &scene)
+      {
+        const char *data = (const char *)file.base;
+        const size_t size = file.size;
+        const size_t numChunks = std::max(size_t(1), size / CHUNK_SIZE);
+
+        // chunk boundaries, moved to the beginning of the next line
+        std::vector<size_t> chunkBegin(numChunks + 1, size);
+        chunkBegin[0] = 0;
+        for (size_t i = 1; i < numChunks; i++) {
+          size_t pos = std::max(i * size / numChunks, chunkBegin[i-1]);
+          const char *eol = (const char *)memchr(data + pos, '\n', size - pos);
+          chunkBegin[i] = eol ? eol - data + 1 : size;
+        }
+
+        std::vector<Chunk> chunks(numChunks);
+        tasking::parallel_for(numChunks, [&](size_t i) {
+          parseChunk(data + chunkBegin[i], data + chunkBegin[i+1], chunks[i]);
+        });
+
+        // prefix sums over the per chunk counts
+        struct Offsets { size_t v, vt, vn, corners, faces; };
+        std::vector<Offsets> offsets(numChunks + 1);
+        offsets[0] = {0, 0, 0, 0, 0};
+        for (size_t i = 0; i < numChunks; i++) {
+          const auto &c = chunks[i];
+          const auto &o = offsets[i];
+          offsets[i+1] = {o.v + c.v.size(), o.vt + c.vt.size(),
+                          o.vn + c.vn.size(), o.corners + c.corners.size(),
+                          o.faces + c.faceSize.size()};
+        }
+
+        for (size_t i = 0; i < numChunks; i++) {
+          for (auto &e : chunks[i].events) {
+            e.face += offsets[i].faces;
+            scene.events.push_back(std::move(e));
+          }
+        }
+
+        const auto &total = offsets[numChunks];
+        scene.v.resize(total.v);
+        scene.vt.resize(total.vt);
+        scene.vn.resize(total.vn);
+        scene.corners.resize(total.corners);
+        scene.faceBegin.resize(total.faces + 1);
+        scene.faceBegin[total.faces] = total.corners;
+
+        tasking::parallel_for(numChunks, [&](size_t i) {
+          auto &c = chunks[i];
+          const auto &o = offsets[i];
+
+          std::copy(c.v.begin(), c.v.end(), scene.v.begin() + o.v);
+          std::copy(c.vt.begin(), c.vt.end(), scene.vt.begin() + o.vt);
+          std::copy(c.vn.begin(), c.vn.end(), scene.vn.begin() + o.vn);
+
+          for (const auto &r : c.relative) {
+            const size_t base[3] = {o.v, o.vt, o.vn};
+            const int64_t index = int64_t(base[r.attribute]) + r.index;
+            const int value = index >= 0 && index <= INT_MAX ? int(index) : -1;
+            auto &corner = c.corners[r.corner];
+            (r.attribute == 0 ? corner.v :
+             r.attribute == 1 ? corner.vt : corner.vn) = value;
+          }
+          std::copy(c.corners.begin(), c.corners.end(),
+                    scene.corners.begin() + o.corners);
+
+          size_t corner = o.corners;
+          for (size_t f = 0; f < c.faceSize.size(); f++) {
+            scene.faceBegin[o.faces + f] = corner;
+            corner += c.faceSize[f];
+          }
+
+          c = Chunk();
+        });
 
+      }
+
+      // Building the meshes //////////////////////////////////////////////////
+
+      //! a run of faces becoming one TriangleMesh
+      struct Group
+      {
+        std::string name;
+        size_t      faceBegin;
+        size_t      faceEnd;
+      };
+
+      static std::vector<Group> findGroups(const Scene &scene)
+      {
+        std::vector<Group> groups;
+        Group current {"", 0, 0};
+        for (const auto &e : scene.events) {
+          if (e.type != GROUP)
+            continue;
+          if (e.face > current.faceBegin) {
+            current.faceEnd = e.face;
+            groups.push_back(current);
+          }
+          current = {e.name, e.face, 0};
+        }
+        if (scene.numFaces() > current.faceBegin) {
+          current.faceEnd = scene.numFaces();
+          groups.push_back(current);
+        }
+        return groups;
+      }
+
+      /*! load all 'mtllib's and assign the 'usemtl' materials to the
+          faces (-1 for none) */
+      static std::vector<int>
+      assignMaterials(const Scene &scene, const std::string &containingPath,
+                      std::vector<tinyobj::material_t> &materials)
+      {
+        std::map<std::string, int> materialIDs;
+        tinyobj::MaterialFileReader readMaterials(containingPath);
+        std::string err;
+
+        for (const auto &e : scene.events) {
+          if (e.type != MATERIAL_LIB)
+            continue;
+          std::stringstream libs(e.name);
+          std::string lib;
+          while (libs >> lib)
+            readMaterials(lib, &materials, &materialIDs, &err);
+        }
+
+        std::vector<int> faceMaterial(scene.numFaces(), -1);
+        int material = -1;
+        size_t begin = 0;
+        auto assign = [&](size_t end) {
+          if (material != -1)
+            std::fill(&faceMaterial[begin], &faceMaterial[end], material);
+        };
+
+        for (const auto &e : scene.events) {
+          if (e.type != USE_MATERIAL)
+            continue;
+          assign(e.face);
+          auto it = materialIDs.find(e.name);
+          if (it == materialIDs.end())
+            err += "material '" + e.name + "' not found\n";
+          material = it == materialIDs.end() ? -1 : it->second;
+          begin = e.face;
+        }
+        assign(scene.numFaces());
+
+        if (!err.empty())
+          std::cerr << "#ospsg: obj parsing warning(s)...\n" << err << std::endl;
+
+        return faceMaterial;
+      }
+
+      //! first triangle of each face, plus the total number of triangles
+      static std::vector<size_t> triangleOffsets(const Scene &scene)
+      {
+        const size_t numFaces = scene.numFaces();
+        const size_t numBlocks = (numFaces + FACE_BLOCK_SIZE - 1)
+                                 / FACE_BLOCK_SIZE;
+        std::vector<size_t> blockBegin(numBlocks + 1, 0);
+
+        parallel_in_blocks(numFaces, FACE_BLOCK_SIZE,
+                           [&](size_t begin, size_t end) {
+          size_t n = 0;
+          for (size_t f = begin; f < end; f++)
+            n += scene.faceBegin[f+1] - scene.faceBegin[f] - 2;
+          blockBegin[begin / FACE_BLOCK_SIZE + 1] = n;
+        });
+        for (size_t i = 0; i < numBlocks; i++)
+          blockBegin[i+1] += blockBegin[i];
+
+        std::vector<size_t> triBegin(numFaces + 1);
+        triBegin[numFaces] = blockBegin[numBlocks];
+        parallel_in_blocks(numFaces, FACE_BLOCK_SIZE,
+                           [&](size_t begin, size_t end) {
+          size_t t = blockBegin[begin / FACE_BLOCK_SIZE];
+          for (size_t f = begin; f < end; f++) {
+            triBegin[f] = t;
+            t += scene.faceBegin[f+1] - scene.faceBegin[f] - 2;
+          }
+        });
+
+        return triBegin;
+      }
+
+      static std::shared_ptr<TriangleMesh>
+      createMesh(const std::string &name, const Scene &scene,
+                 const Group &group, const std::vector<size_t> &triBegin,
+                 const std::vector<int> &faceMaterial)
+      {
+        const size_t t0 = triBegin[group.faceBegin];
+        const size_t numTris = triBegin[group.faceEnd] - t0;
+        if (3 * numTris > size_t(INT_MAX)) {
+          throw std::runtime_error("#ospsg: obj group '" + group.name
+                                   + "' has too many triangles");
+        }
+
+        // normals and texcoords are only used if every corner has them
+        std::atomic<bool> allNormals {true};
+        std::atomic<bool> allTexcoords {true};
+        parallel_in_blocks(scene.faceBegin[group.faceEnd]
+                           - scene.faceBegin[group.faceBegin],
+                           FACE_BLOCK_SIZE,
+                           [&](size_t begin, size_t end) {
+          const Corner *c = &scene.corners[scene.faceBegin[group.faceBegin]];
+          bool n = true, t = true;
+          for (size_t i = begin; i < end; i++) {
+            n &= c[i].vn >= 0 && size_t(c[i].vn) < scene.vn.size();
+            t &= c[i].vt >= 0 && size_t(c[i].vt) < scene.vt.size();
+          }
+          if (!n) allNormals = false;
+          if (!t) allTexcoords = false;
+        });
+
+        auto mesh = createNode(name, "TriangleMesh")->nodeAs<TriangleMesh>();
+
+        auto v  = createNode("vertex", "DataVector3f")->nodeAs<DataVector3f>();
+        auto vi = createNode("index", "DataVector3i")->nodeAs<DataVector3i>();
+        auto vn = createNode("normal", "DataVector3f")->nodeAs<DataVector3f>();
         auto vt =
             createNode("texcoord", "DataVector2f")->nodeAs<DataVector2f>();
-        vt->v.reserve(numSrcIndices);
-
-        for (int i = 0; i < shape.mesh.indices.size(); i += 3) {
-          auto idx0 = shape.mesh.indices[i + 0];
-          auto idx1 = shape.mesh.indices[i + 1];
-          auto idx2 = shape.mesh.indices[i + 2];
-
-          auto prim = vec3i(i + 0, i + 1, i + 2);
-          vi->push_back(prim);
-
-          v->push_back(vec3f(attrib.vertices[idx0.vertex_index * 3 + 0],
-                             attrib.vertices[idx0.vertex_index * 3 + 1],
-                             attrib.vertices[idx0.vertex_index * 3 + 2]));
-          v->push_back(vec3f(attrib.vertices[idx1.vertex_index * 3 + 0],
-                             attrib.vertices[idx1.vertex_index * 3 + 1],
-                             attrib.vertices[idx1.vertex_index * 3 + 2]));
-          v->push_back(vec3f(attrib.vertices[idx2.vertex_index * 3 + 0],
-                             attrib.vertices[idx2.vertex_index * 3 + 1],
-                             attrib.vertices[idx2.vertex_index * 3 + 2]));
-
-          // TODO create missing normals&texcoords if only some faces have them
-          if (!attrib.normals.empty() && idx0.normal_index != -1) {
-            vn->push_back(vec3f(attrib.normals[idx0.normal_index * 3 + 0],
-                                attrib.normals[idx0.normal_index * 3 + 1],
-                                attrib.normals[idx0.normal_index * 3 + 2]));
-            vn->push_back(vec3f(attrib.normals[idx1.normal_index * 3 + 0],
-                                attrib.normals[idx1.normal_index * 3 + 1],
-                                attrib.normals[idx1.normal_index * 3 + 2]));
-            vn->push_back(vec3f(attrib.normals[idx2.normal_index * 3 + 0],
-                                attrib.normals[idx2.normal_index * 3 + 1],
-                                attrib.normals[idx2.normal_index * 3 + 2]));
-          }
+        auto pmids = createNode("prim.materialID",
+                                "DataVector1i")->nodeAs<DataVector1i>();
 
-          if (!attrib.texcoords.empty() && idx0.texcoord_index != -1) {
-            vt->push_back(vec2f(attrib.texcoords[idx0.texcoord_index * 2 + 0],
-                                attrib.texcoords[idx0.texcoord_index * 2 + 1]));
-            vt->push_back(vec2f(attrib.texcoords[idx1.texcoord_index * 2 + 0],
-                                attrib.texcoords[idx1.texcoord_index * 2 + 1]));
-            vt->push_back(vec2f(attrib.texcoords[idx2.texcoord_index * 2 + 0],
-                                attrib.texcoords[idx2.texcoord_index * 2 + 1]));
+        v->v.resize(3 * numTris);
+        vi->v.resize(numTris);
+        pmids->v.resize(numTris);
+        if (allNormals)
+          vn->v.resize(3 * numTris);
+        if (allTexcoords)
+          vt->v.resize(3 * numTris);
+
+        std::atomic<bool> badIndex {false};
+
+        parallel_in_blocks(group.faceEnd - group.faceBegin, FACE_BLOCK_SIZE,
+                           [&](size_t begin, size_t end) {
+          bool bad = false;
+          for (size_t f = group.faceBegin + begin;
+               f < group.faceBegin + end; f++) {
+            const Corner *c = &scene.corners[scene.faceBegin[f]];
+            const size_t numCorners = scene.faceBegin[f+1]
+                                      - scene.faceBegin[f];
+            size_t t = triBegin[f] - t0;
+            for (size_t k = 1; k + 1 < numCorners; k++, t++) {
+              const Corner *tri[3] = {&c[0], &c[k], &c[k+1]};
+              for (int j = 0; j < 3; j++) {
+                const size_t dst = 3 * t + j;
+                const int vIdx = tri[j]->v;
+                if (vIdx >= 0 && size_t(vIdx) < scene.v.size()) {
+                  v->v[dst] = scene.v[vIdx];
+                } else {
+                  v->v[dst] = vec3f(0.f);
+                  bad = true;
+                }
+                if (allNormals)
+                  vn->v[dst] = scene.vn[tri[j]->vn];
+                if (allTexcoords)
+                  vt->v[dst] = scene.vt[tri[j]->vt];
+              }
+              vi->v[t] = vec3i(3 * t + 0, 3 * t + 1, 3 * t + 2);
+              pmids->v[t] = faceMaterial[f];
+            }
           }
+          if (bad)
+            badIndex = true;
+        });
+
+        if (badIndex) {
+          std::cerr << "#ospsg: obj group '" << group.name
+                    << "' references non-existing vertices" << std::endl;
         }
 
         mesh->add(v);
@@ -250,17 +719,49 @@ namespace ospray {
           mesh->add(vn);
         if (!vt->empty())
           mesh->add(vt);
+        mesh->add(pmids);
 
-        auto pmids = createNode("prim.materialID",
-                                "DataVector1i")->nodeAs<DataVector1i>();
+        return mesh;
+      }
 
-        auto numMatIds = shape.mesh.material_ids.size();
-        pmids->v.reserve(numMatIds);
+    } // ::ospray::sg::obj
 
-        for (auto id : shape.mesh.material_ids)
-          pmids->v.push_back(id);
+    void importOBJ(const std::shared_ptr<Node> &world, const FileName &fileName)
+    {
+      obj::Scene scene;
+      {
+        MappedFile file(fileName.str());
+        obj::parseFile(file, scene);
+      }
+
+      if (scene.numFaces() == 0) {
+        std::cerr << "#ospsg: obj file '" << fileName.str() << "' does not"
+                  << " contain any faces, no geometry added to the scene!"
+                  << std::endl;
+        return;
+      }
+
+      auto containingPath = fileName.path().str() + '/';
+
+      std::vector<tinyobj::material_t> materials;
+      const auto faceMaterial =
+          obj::assignMaterials(scene, containingPath, materials);
+      auto sgMaterials = createSgMaterials(materials, containingPath);
+
+      const auto groups   = obj::findGroups(scene);
+      const auto triBegin = obj::triangleOffsets(scene);
+
+      std::string base_name = fileName.name() + '_';
+      int shapeId           = 0;
+
+#if !USE_INSTANCES
+      auto objInstance = createNode("instance", "Instance");
+      world->add(objInstance);
+#endif
+      for (auto &group : groups) {
+        auto name = base_name + std::to_string(shapeId++) + '_' + group.name;
+        auto mesh = obj::createMesh(name, scene, group, triBegin, faceMaterial);
 
-        mesh->add(pmids);
         mesh->add(sgMaterials);
 
         auto model = createNode(name + "_model", "Model");
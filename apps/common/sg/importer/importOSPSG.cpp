@@ -183,11 +183,6 @@ namespace ospray {
         throw std::runtime_error("ospray::XML error: could not open file for writing '"
                                  + fileName +"'");
       }
-      FILE *fbin = fopen((fileName+".bin").c_str(),"w");
-      if (!file) {
-        throw std::runtime_error("ospray::XML error: could not open file for writing '"
-                                 + fileName +"'");
-      }
       fprintf(file,"<?xml version=\"%s\"?>\n","1.0");
       fprintf(file,"<!-- OSPRay Version 1.2.3 -->\n");
       writeNode(root->name(), root, file, 1);
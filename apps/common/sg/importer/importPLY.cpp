@@ -27,6 +27,10 @@
 #include "sg/geometry/TriangleMesh.h"
 //
 #include "../3rdParty/ply.h"
+// stl
+#include <algorithm>
+#include <atomic>
+#include <sstream>
 
 namespace ospray {
   namespace sg {
@@ -352,13 +356,450 @@ namespace ospray {
           mesh->add(nor);
       }
 
+      // Binary PLY files //////////////////////////////////////////////////////
+
+      /*! Binary PLY files are mapped into memory and read without going
+          through ply.c: vertex properties are copied out of the fixed
+          size vertex records in parallel, faces are read in parallel,
+          too, after their (variable sized) records have been located.
+          ASCII and gzipped files fall back to readFile(). */
+
+      //! records per task
+      static const size_t BLOCK_SIZE = 64 * 1024;
+
+      enum ScalarType { INVALID, INT8, UINT8, INT16, UINT16, INT32, UINT32,
+                        FLOAT32, FLOAT64 };
+
+      static ScalarType scalarType(const std::string &name)
+      {
+        if (name == "char"   || name == "int8")    return INT8;
+        if (name == "uchar"  || name == "uint8")   return UINT8;
+        if (name == "short"  || name == "int16")   return INT16;
+        if (name == "ushort" || name == "uint16")  return UINT16;
+        if (name == "int"    || name == "int32")   return INT32;
+        if (name == "uint"   || name == "uint32")  return UINT32;
+        if (name == "float"  || name == "float32") return FLOAT32;
+        if (name == "double" || name == "float64") return FLOAT64;
+        return INVALID;
+      }
+
+      static size_t sizeOf(ScalarType type)
+      {
+        switch (type) {
+        case INT8:
+        case UINT8:   return 1;
+        case INT16:
+        case UINT16:  return 2;
+        case INT32:
+        case UINT32:
+        case FLOAT32: return 4;
+        case FLOAT64: return 8;
+        default:      return 0;
+        }
+      }
+
+      template <typename T>
+      static inline T load(const unsigned char *ptr, bool swap)
+      {
+        unsigned char bytes[sizeof(T)];
+        memcpy(bytes, ptr, sizeof(T));
+        if (swap)
+          std::reverse(bytes, bytes + sizeof(T));
+        T t;
+        memcpy(&t, bytes, sizeof(T));
+        return t;
+      }
+
+      template <typename T>
+      static inline T loadAs(ScalarType type, const unsigned char *ptr,
+                             bool swap)
+      {
+        switch (type) {
+        case INT8:    return T(load<int8_t>(ptr, swap));
+        case UINT8:   return T(load<uint8_t>(ptr, swap));
+        case INT16:   return T(load<int16_t>(ptr, swap));
+        case UINT16:  return T(load<uint16_t>(ptr, swap));
+        case INT32:   return T(load<int32_t>(ptr, swap));
+        case UINT32:  return T(load<uint32_t>(ptr, swap));
+        case FLOAT32: return T(load<float>(ptr, swap));
+        case FLOAT64: return T(load<double>(ptr, swap));
+        default:      return T(0);
+        }
+      }
+
+      struct Property
+      {
+        std::string name;
+        ScalarType  type {INVALID};      //!< item type for lists
+        ScalarType  countType {INVALID}; //!< INVALID if not a list
+        size_t      offset {0};          //!< in fixed size records only
+
+        bool isList() const { return countType != INVALID; }
+      };
+
+      struct Element
+      {
+        std::string           name;
+        size_t                count {0};
+        std::vector<Property> props;
+
+        //! size of each record, 0 if the records contain lists
+        size_t fixedSize() const
+        {
+          size_t size = 0;
+          for (const auto &p : props) {
+            if (p.isList())
+              return 0;
+            size += sizeOf(p.type);
+          }
+          return size;
+        }
+
+        const Property *find(const std::string &name) const
+        {
+          for (const auto &p : props)
+            if (p.name == name)
+              return &p;
+          return nullptr;
+        }
+
+        //! size of the record at ptr, 0 if it exceeds 'end'
+        size_t recordSize(const unsigned char *ptr, const unsigned char *end,
+                          bool swap) const
+        {
+          const unsigned char *p = ptr;
+          for (const auto &prop : props) {
+            if (prop.isList()) {
+              const size_t countSize = sizeOf(prop.countType);
+              if (size_t(end - p) < countSize)
+                return 0;
+              const int64_t n = loadAs<int64_t>(prop.countType, p, swap);
+              if (n < 0)
+                return 0;
+              p += countSize;
+              if (size_t(end - p) / sizeOf(prop.type) < size_t(n))
+                return 0;
+              p += n * sizeOf(prop.type);
+            } else {
+              if (size_t(end - p) < sizeOf(prop.type))
+                return 0;
+              p += sizeOf(prop.type);
+            }
+          }
+          return p - ptr;
+        }
+      };
+
+      /*! parses the header; returns false for anything but binary files
+          which can be read by readBinaryFile() */
+      static bool parseHeader(const MappedFile &file, bool &swap,
+                              size_t &dataOffset,
+                              std::vector<Element> &elements)
+      {
+        const char *data = (const char *)file.base;
+        const size_t size = file.size;
+
+        size_t pos = 0;
+        bool binary = false;
+        auto nextLine = [&](std::string &line) {
+          const char *eol = (const char *)memchr(data + pos, '\n', size - pos);
+          if (!eol)
+            return false;
+          line = std::string(data + pos, eol);
+          if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+          pos = eol - data + 1;
+          return true;
+        };
+
+        std::string line;
+        if (!nextLine(line) || line != "ply")
+          return false;
+
+        while (nextLine(line)) {
+          std::stringstream ss(line);
+          std::string keyword;
+          ss >> keyword;
+
+          if (keyword == "format") {
+            std::string format;
+            ss >> format;
+            const uint16_t one = 1;
+            const bool littleEndianHost = *(const uint8_t *)&one == 1;
+            if (format == "binary_little_endian") {
+              binary = true;
+              swap = !littleEndianHost;
+            } else if (format == "binary_big_endian") {
+              binary = true;
+              swap = littleEndianHost;
+            } else {
+              return false;
+            }
+          } else if (keyword == "element") {
+            Element e;
+            ss >> e.name >> e.count;
+            elements.push_back(e);
+          } else if (keyword == "property") {
+            if (elements.empty())
+              return false;
+            Property p;
+            std::string type;
+            ss >> type;
+            if (type == "list") {
+              std::string countType, itemType;
+              ss >> countType >> itemType;
+              p.countType = scalarType(countType);
+              p.type = scalarType(itemType);
+              if (p.countType == INVALID)
+                return false;
+            } else {
+              p.type = scalarType(type);
+            }
+            ss >> p.name;
+            if (p.type == INVALID)
+              return false;
+            auto &props = elements.back().props;
+            if (!props.empty() && !props.back().isList())
+              p.offset = props.back().offset + sizeOf(props.back().type);
+            props.push_back(p);
+          } else if (keyword == "end_header") {
+            dataOffset = pos;
+            return binary;
+          }
+        }
+
+        return false;
+      }
+
+      static void readVertices(const unsigned char *ptr, const Element &e,
+                               bool swap, DataVector3f &pos, DataVector3f &nor)
+      {
+        const size_t stride = e.fixedSize();
+        const Property *x = e.find("x"), *y = e.find("y"), *z = e.find("z");
+        if (!x || !y || !z)
+          throw std::runtime_error("#osp:sg:ply: vertices don't have x, y, and z");
+
+        const Property *nx = e.find("nx"), *ny = e.find("ny"),
+                       *nz = e.find("nz");
+        const bool hasNormals = nx && ny && nz;
+
+        pos.v.resize(e.count);
+        if (hasNormals)
+          nor.v.resize(e.count);
+
+        parallel_in_blocks(e.count, BLOCK_SIZE, [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            const unsigned char *r = ptr + i * stride;
+            pos.v[i] = vec3f(loadAs<float>(x->type, r + x->offset, swap),
+                             loadAs<float>(y->type, r + y->offset, swap),
+                             loadAs<float>(z->type, r + z->offset, swap));
+            if (hasNormals) {
+              nor.v[i] = vec3f(loadAs<float>(nx->type, r + nx->offset, swap),
+                               loadAs<float>(ny->type, r + ny->offset, swap),
+                               loadAs<float>(nz->type, r + nz->offset, swap));
+            }
+          }
+        });
+      }
+
+      /*! reads the faces at 'ptr' (triangulated as fans); returns the
+          end of the face element */
+      static const unsigned char *readFaces(const unsigned char *ptr,
+                                            const unsigned char *fileEnd,
+                                            const Element &e, bool swap,
+                                            size_t numVertices,
+                                            DataVector3i &idx)
+      {
+        const Property *indices = e.find("vertex_indices");
+        if (!indices)
+          indices = e.find("vertex_index");
+        if (!indices || !indices->isList())
+          throw std::runtime_error("#osp:sg:ply: faces must have vertex indices");
+
+        const size_t countSize = sizeOf(indices->countType);
+        const size_t itemSize  = sizeOf(indices->type);
+
+        // offset of the index list inside each record, and the record
+        // offsets (only if the faces are not all triangles)
+        size_t listOffset = 0;
+        for (const auto &p : e.props) {
+          if (&p == indices)
+            break;
+          if (p.isList())
+            listOffset = size_t(-1);
+          else if (listOffset != size_t(-1))
+            listOffset += sizeOf(p.type);
+        }
+
+        // fast path: all faces are triangles and there are no other lists,
+        // i.e. the records have a fixed size
+        size_t triStride = 0;
+        if (listOffset != size_t(-1)) {
+          size_t other = 0;
+          bool otherLists = false;
+          for (const auto &p : e.props) {
+            if (&p == indices) continue;
+            otherLists |= p.isList();
+            other += sizeOf(p.type);
+          }
+          if (!otherLists)
+            triStride = other + countSize + 3 * itemSize;
+        }
+
+        std::atomic<bool> allTriangles {triStride != 0};
+        if (allTriangles && size_t(fileEnd - ptr) / triStride < e.count)
+          allTriangles = false;
+        if (allTriangles) {
+          parallel_in_blocks(e.count, BLOCK_SIZE,
+                             [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end && allTriangles; i++) {
+              const unsigned char *r = ptr + i * triStride + listOffset;
+              if (loadAs<int64_t>(indices->countType, r, swap) != 3)
+                allTriangles = false;
+            }
+          });
+        }
+
+        std::vector<const unsigned char *> lists;
+        std::vector<size_t> triBegin;
+        const unsigned char *faceEnd = ptr;
+
+        if (allTriangles) {
+          idx.v.resize(e.count);
+          faceEnd = ptr + e.count * triStride;
+        } else {
+          // locate every record; this is the only sequential pass
+          lists.resize(e.count);
+          triBegin.resize(e.count + 1);
+          size_t numTris = 0;
+          for (size_t i = 0; i < e.count; i++) {
+            const size_t size = e.recordSize(faceEnd, fileEnd, swap);
+            if (size == 0)
+              throw std::runtime_error("#osp:sg:ply: truncated face data");
+            const unsigned char *list = faceEnd;
+            for (const auto &p : e.props) {
+              if (&p == indices)
+                break;
+              list += p.isList()
+                  ? sizeOf(p.countType)
+                    + loadAs<int64_t>(p.countType, list, swap) * sizeOf(p.type)
+                  : sizeOf(p.type);
+            }
+            lists[i] = list;
+            triBegin[i] = numTris;
+            const int64_t n = loadAs<int64_t>(indices->countType, list, swap);
+            numTris += n >= 3 ? n - 2 : 0;
+            faceEnd += size;
+          }
+          triBegin[e.count] = numTris;
+          idx.v.resize(numTris);
+        }
+
+        std::atomic<bool> badIndex {false};
+        parallel_in_blocks(e.count, BLOCK_SIZE, [&](size_t begin, size_t end) {
+          bool bad = false;
+          auto index = [&](const unsigned char *list, int64_t k) {
+            const int64_t i = loadAs<int64_t>(indices->type,
+                                              list + countSize + k * itemSize,
+                                              swap);
+            if (i < 0 || size_t(i) >= numVertices) {
+              bad = true;
+              return 0;
+            }
+            return int(i);
+          };
+
+          for (size_t f = begin; f < end; f++) {
+            if (allTriangles) {
+              const unsigned char *list = ptr + f * triStride + listOffset;
+              idx.v[f] = vec3i(index(list, 0), index(list, 1), index(list, 2));
+            } else {
+              const unsigned char *list = lists[f];
+              const int64_t n = loadAs<int64_t>(indices->countType, list, swap);
+              size_t t = triBegin[f];
+              for (int64_t k = 1; k + 1 < n; k++, t++)
+                idx.v[t] = vec3i(index(list, 0), index(list, k),
+                                 index(list, k + 1));
+            }
+          }
+          if (bad)
+            badIndex = true;
+        });
+
+        if (badIndex) {
+          std::cerr << "#osp:sg:ply: faces reference non-existing vertices"
+                    << std::endl;
+        }
+
+        return faceEnd;
+      }
+
+      /*! returns false if the file is not a binary PLY file */
+      bool readBinaryFile(const std::string &fileName,
+                          std::shared_ptr<sg::TriangleMesh> mesh)
+      {
+        if (fileName.size() > 7
+            && fileName.compare(fileName.size() - 7, 7, ".ply.gz") == 0)
+          return false;
+
+        MappedFile file(fileName);
+
+        bool swap = false;
+        size_t dataOffset = 0;
+        std::vector<Element> elements;
+        if (!parseHeader(file, swap, dataOffset, elements))
+          return false;
+
+        auto pos = createNode("vertex", "DataVector3f")->nodeAs<DataVector3f>();
+        auto nor = createNode("normal", "DataVector3f")->nodeAs<DataVector3f>();
+        auto idx = createNode("index", "DataVector3i")->nodeAs<DataVector3i>();
+
+        const unsigned char *ptr = file.base + dataOffset;
+        const unsigned char *end = file.base + file.size;
+
+        for (const auto &e : elements) {
+          const size_t stride = e.fixedSize();
+          if (e.name == "vertex") {
+            if (stride == 0)
+              return false; // lists in vertices, let ply.c handle this
+            if (size_t(end - ptr) / stride < e.count)
+              throw std::runtime_error("#osp:sg:ply: truncated vertex data");
+            readVertices(ptr, e, swap, *pos, *nor);
+            ptr += e.count * stride;
+          } else if (e.name == "face") {
+            ptr = readFaces(ptr, end, e, swap, pos->v.size(), *idx);
+          } else if (stride != 0) {
+            if (size_t(end - ptr) / stride < e.count)
+              throw std::runtime_error("#osp:sg:ply: truncated file");
+            ptr += e.count * stride;
+          } else {
+            for (size_t i = 0; i < e.count; i++) {
+              const size_t size = e.recordSize(ptr, end, swap);
+              if (size == 0)
+                throw std::runtime_error("#osp:sg:ply: truncated file");
+              ptr += size;
+            }
+          }
+        }
+
+        cout << "num faces : " << idx->v.size() << endl;
+
+        mesh->add(idx);
+        mesh->add(pos);
+        if (!nor->v.empty())
+          mesh->add(nor);
+
+        return true;
+      }
+
     } // ::ospray::sg::ply
 
     void importPLY(std::shared_ptr<Node> &world, const FileName &fileName)
     {
       auto mesh = sg::createNode(fileName.name(),
                                  "TriangleMesh")->nodeAs<TriangleMesh>();
-      ply::readFile(fileName.str(), mesh);
+      if (!ply::readBinaryFile(fileName.str(), mesh))
+        ply::readFile(fileName.str(), mesh);
       world->add(mesh);
     }
 
@@ -18,9 +18,12 @@
 
 #include "AMRVolume.h"
 // ospcommon
-#include "ospcommon/utility/ArrayView.h"
+#include "ospcommon/tasking/parallel_for.h"
 // sg
 #include "sg/importer/Importer.h"
+// stl
+#include <atomic>
+#include <chrono>
 
 namespace ospray {
   namespace sg {
@@ -34,12 +37,13 @@ namespace ospray {
                          std::string("octant"),
                          std::string("finest"),
                          std::string("finestLevel")});
+      // where to cache the volume's acceleration structure, empty to
+      // always rebuild it
+      createChild("accelCacheFile", "string", std::string(""));
     }
 
     AMRVolume::~AMRVolume()
     {
-      for (auto *ptr : brickPtrs)
-        delete [] ptr;
     }
 
     std::string AMRVolume::toString() const
@@ -47,6 +51,31 @@ namespace ospray {
       return "ospray::sg::AMRVolume";
     }
 
+    void AMRVolume::allocateBricks()
+    {
+      size_t numVoxels = 0;
+      for (const auto &bi : brickInfo)
+        numVoxels += bi.size().product();
+
+      brickStorage.reset(new float[numVoxels]);
+      brickPtrs.resize(brickInfo.size());
+
+      float *voxels = brickStorage.get();
+      for (size_t i = 0; i < brickInfo.size(); i++) {
+        brickPtrs[i] = voxels;
+        voxels += brickInfo[i].size().product();
+      }
+    }
+
+    static bool seekTo(FILE *file, size_t offset)
+    {
+#ifdef _WIN32
+      return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+      return fseeko(file, offset, SEEK_SET) == 0;
+#endif
+    }
+
     void AMRVolume::parseRaw2AmrFile(const FileName &fileName,
                                      int BS,
                                      int maxLevel)
@@ -58,49 +87,119 @@ namespace ospray {
                    << std::endl;
       }
 
+      const auto startTime = std::chrono::steady_clock::now();
+
       FileName infoFileName = fileName.str() + std::string(".info");
       FileName dataFileName = fileName.str() + std::string(".data");
 
       FILE *infoFile = fopen(infoFileName.c_str(), "rb");
-      FILE *dataFile = fopen(dataFileName.c_str(), "rb");
 
       if (infoFile == nullptr) {
         throw std::runtime_error(std::string("#osp:sg - ERROR could not open '")
                                  + infoFileName.c_str() + "'");
       }
 
-      if (dataFile == nullptr) {
-        throw std::runtime_error(std::string("#osp:sg - ERROR could not open '")
-                                 + dataFileName.c_str() + "'");
-      }
+      // the .info file is small, read all descriptors in one go
+      fseek(infoFile, 0, SEEK_END);
+      const size_t numFileBricks = ftell(infoFile) / sizeof(BrickInfo);
+      fseek(infoFile, 0, SEEK_SET);
 
-      BrickInfo bi;
-      auto bounds = child("bounds").valueAs<box3f>();
-      auto numCells = BS * BS * BS;
-      while (fread(&bi, sizeof(bi), 1, infoFile)) {
-        utility::ArrayView<float> bd(new float[numCells], numCells);
+      std::vector<BrickInfo> fileBricks(numFileBricks);
+      const size_t numRead = fread(fileBricks.data(), sizeof(BrickInfo),
+                                   numFileBricks, infoFile);
+      fclose(infoFile);
 
-        int nr = fread(bd.data(), sizeof(float), numCells, dataFile);
+      if (numRead != numFileBricks) {
+        throw std::runtime_error(std::string("#osp:sg - ERROR could not read '")
+                                 + infoFileName.c_str() + "'");
+      }
 
-        if (bi.level > maxLevel) {
-          delete [] bd.data();
+      // for each brick we keep, where in the .data file it is
+      const size_t numCells = size_t(BS) * BS * BS;
+      std::vector<size_t> fileBrickID;
+      auto bounds = child("bounds").valueAs<box3f>();
+      for (size_t i = 0; i < numFileBricks; i++) {
+        const BrickInfo &bi = fileBricks[i];
+        if (bi.level > maxLevel)
           continue;
+
+        if (size_t(bi.size().product()) != numCells) {
+          throw std::runtime_error("#osp:sg - ERROR brick size in '"
+                                   + infoFileName.str()
+                                   + "' does not match 'brickSize'");
         }
+
         brickInfo.push_back(bi);
+        fileBrickID.push_back(i);
         bounds.extend((vec3f(bi.box.upper) + vec3f(1.f)) * bi.dt);
+      }
+
+      allocateBricks();
+
+      // bricks that are consecutive in the file are also consecutive in
+      // 'brickStorage', so we read them as runs of up to ~64MB, each run
+      // straight into its final place, and all runs in parallel
+      struct ReadJob
+      {
+        size_t firstBrick;
+        size_t numBricks;
+      };
+
+      const size_t bricksPerJob =
+          std::max(size_t(1), (size_t(64) << 20) / (numCells * sizeof(float)));
+
+      std::vector<ReadJob> jobs;
+      for (size_t i = 0; i < brickInfo.size();) {
+        ReadJob job{i, 1};
+        while (i + job.numBricks < brickInfo.size() &&
+               job.numBricks < bricksPerJob &&
+               fileBrickID[i + job.numBricks] == fileBrickID[i] + job.numBricks)
+          job.numBricks++;
+        jobs.push_back(job);
+        i += job.numBricks;
+      }
+
+      std::vector<range1f> jobRanges(jobs.size());
+      std::atomic<bool> readFailed(false);
+
+      tasking::parallel_for(jobs.size(), [&](size_t jobID) {
+        const ReadJob &job  = jobs[jobID];
+        const size_t offset = fileBrickID[job.firstBrick] * numCells;
+        const size_t numValues = job.numBricks * numCells;
+        float *values = brickPtrs[job.firstBrick];
 
-        assert(nr == numCells);
-        for (const auto &c : bd)
-          valueRange.extend(c);
-        brickPtrs.push_back(bd);
+        FILE *dataFile = fopen(dataFileName.c_str(), "rb");
+        if (dataFile == nullptr ||
+            !seekTo(dataFile, offset * sizeof(float)) ||
+            fread(values, sizeof(float), numValues, dataFile) != numValues) {
+          readFailed = true;
+        } else {
+          for (size_t i = 0; i < numValues; i++)
+            jobRanges[jobID].extend(values[i]);
+        }
+
+        if (dataFile)
+          fclose(dataFile);
+      });
+
+      if (readFailed) {
+        throw std::runtime_error(std::string("#osp:sg - ERROR could not read '")
+                                 + dataFileName.c_str() + "'");
       }
 
+      for (const auto &r : jobRanges)
+        valueRange.extend(r);
+
       child("bounds") = bounds;
-      ospLogF(1) << "read file; found " << brickInfo.size() << " bricks"
-                 << std::endl;
 
-      fclose(infoFile);
-      fclose(dataFile);
+      const double seconds = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - startTime).count();
+      const double megaBytes =
+          brickInfo.size() * numCells * sizeof(float) / (1024.0 * 1024.0);
+      ospLogF(1) << "#osp:sg: read " << brickInfo.size() << " amr bricks ("
+                 << megaBytes << "MB) from '" << fileName.str() << "' in "
+                 << seconds << "s, " << megaBytes / seconds << " MB/s"
+                 << std::endl;
     }
 
     void AMRVolume::preCommit(RenderContext &ctx)
@@ -181,6 +280,12 @@ namespace ospray {
           int BS = atoi(BSs.c_str());
           parseRaw2AmrFile(realFN, BS);
         }
+
+        // caching the built accel is opt-in, as the data's directory may
+        // be read-only or shared: 'accelCache' names the cache file
+        const std::string accelCache = node.getProp("accelCache");
+        if (!accelCache.empty())
+          child("accelCacheFile") = accelCache;
       } else
         throw std::runtime_error("no filename set in xml node...");
 
@@ -71,6 +71,14 @@ namespace ospray {
       std::vector<OSPData> brickData;
       std::vector<BrickInfo> brickInfo;
       std::vector<float *> brickPtrs;
+
+      /*! allocate one buffer for the voxels of all 'brickInfo's and
+          point 'brickPtrs' into it, so loaders can write each brick
+          straight into the memory the bricks get shared from */
+      void allocateBricks();
+
+      //! backing store for all bricks in 'brickPtrs'
+      std::unique_ptr<float[]> brickStorage;
     };
 
 #ifdef OSPRAY_APPS_SG_CHOMBO
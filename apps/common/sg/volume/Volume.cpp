@@ -18,6 +18,7 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <sstream>
 #include "Volume.h"
 #include "sg/common/World.h"
 
@@ -498,5 +499,317 @@ namespace ospray {
 
     OSP_REGISTER_SG_NODE(RichtmyerMeshkov);
 
+
+    // =======================================================
+    // time series volume class
+    // =======================================================
+
+    TimeSeriesVolume::TimeSeriesVolume()
+    {
+      createChild("timeStep", "int", 0);
+      // number of time steps held in memory, read when the first time
+      // step gets loaded
+      createChild("prefetchDepth", "int", 3);
+      // rate at which displayed time steps changed, over the last few
+      // switches
+      createChild("timeStepsPerSecond", "float", 0.f);
+    }
+
+    TimeSeriesVolume::~TimeSeriesVolume()
+    {
+      stopLoaders();
+
+      for (auto &slot : slots) {
+        if (slot.volume)
+          ospRelease(slot.volume);
+        if (slot.voxelData)
+          ospRelease(slot.voxelData);
+      }
+    }
+
+    std::string TimeSeriesVolume::toString() const
+    {
+      return "ospray::sg::TimeSeriesVolume";
+    }
+
+    //! \brief Initialize this node's value from given XML node
+    void TimeSeriesVolume::setFromXML(const xml::Node &node,
+                                      const unsigned char *binBasePtr)
+    {
+      voxelType = node.getProp("voxelType");
+      if (voxelType == "uint8") voxelType = "uchar";
+      dimensions = toVec3i(node.getProp("dimensions").c_str());
+
+      if (unsupportedVoxelType(voxelType)) {
+        THROW_SG_ERROR("unknown TimeSeriesVolume.voxelType '"+voxelType+"'");
+      }
+
+      // either an explicit list of files, or a printf-style pattern
+      // that gets the time step index
+      std::stringstream list(node.getProp("fileNames"));
+      std::string name;
+      while (list >> name)
+        fileNames.push_back(name);
+
+      const std::string pattern = node.getProp("fileName");
+      if (fileNames.empty() && !pattern.empty()) {
+        const std::string first = node.getProp("firstTimeStep");
+        const int firstTimeStep = first.empty() ? 0 : std::stoi(first);
+        const int numTimeSteps  = std::stoi(node.getProp("numTimeSteps"));
+        for (int i = 0; i < numTimeSteps; i++) {
+          char buf[1024];
+          snprintf(buf, sizeof(buf), pattern.c_str(), firstTimeStep + i);
+          fileNames.push_back(buf);
+        }
+      }
+
+      if (fileNames.empty()) {
+        THROW_SG_ERROR("sg::TimeSeriesVolume: no 'fileNames', or 'fileName'"
+                       " and 'numTimeSteps' specified");
+      }
+
+      const std::string prefetchDepth = node.getProp("prefetchDepth");
+      if (!prefetchDepth.empty())
+        child("prefetchDepth") = std::stoi(prefetchDepth);
+
+      fileNameOfCorrespondingXmlDoc = node.doc->fileName;
+
+      std::cout << "#osp:sg: created TimeSeriesVolume from XML file, "
+                << fileNames.size() << " time steps of dimensions "
+                << dimensions << std::endl;
+    }
+
+    void TimeSeriesVolume::preCommit(RenderContext &ctx)
+    {
+      if (slots.empty())
+        startLoaders();
+
+      const int numTimeSteps = fileNames.size();
+      const int timeStep =
+          clamp(child("timeStep").valueAs<int>(), 0, numTimeSteps - 1);
+
+      // switch to the requested time step, waiting for it only if the
+      // loaders did not get to it yet
+      int slotID = -1;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        requestedTimeStep = timeStep;
+        // nothing renders while we're committing, so the loaders may
+        // recycle the previously displayed slot if they have to
+        displayedSlot = -1;
+        requestChanged.notify_all();
+
+        while (true) {
+          slotID = -1;
+          for (int i = 0; i < slots.size(); i++) {
+            if (slots[i].timeStep == timeStep)
+              slotID = i;
+          }
+          if (slotID >= 0 && slots[slotID].ready)
+            break;
+          slotLoaded.wait(lock);
+        }
+
+        if (!slots[slotID].error.empty())
+          THROW_SG_ERROR(slots[slotID].error);
+
+        displayedSlot = slotID;
+        requestChanged.notify_all();
+      }
+
+      Slot &slot = slots[slotID];
+
+      if (valueAs<OSPVolume>() != slot.volume) {
+        const bool firstTimeStep = !valueAs<OSPVolume>();
+        setValue(slot.volume);
+
+        // all parameters have to be set on the new volume
+        for (auto &c : properties.children)
+          c.second->markAsModified();
+
+        ospSetObject(isosurfacesGeometry, "volume", slot.volume);
+
+        child("voxelRange") = slot.voxelRange;
+        if (firstTimeStep) {
+          child("transferFunction")["valueRange"] = slot.voxelRange;
+          child("isosurface").setMinMax(slot.voxelRange.x,
+                                        slot.voxelRange.y);
+        }
+
+        switchTimes.push_back(getSysTime());
+        if (switchTimes.size() > 16)
+          switchTimes.pop_front();
+        if (switchTimes.size() > 1) {
+          child("timeStepsPerSecond") = float((switchTimes.size() - 1) /
+              (switchTimes.back() - switchTimes.front()));
+        }
+      }
+
+      if (child("isosurfaceEnabled").valueAs<bool>() == true) {
+        OSPData isovaluesData = ospNewData(1, OSP_FLOAT,
+          &child("isosurface").valueAs<float>());
+        ospSetData(isosurfacesGeometry, "isovalues", isovaluesData);
+        ospCommit(isosurfacesGeometry);
+      }
+    }
+
+    void TimeSeriesVolume::startLoaders()
+    {
+      if (dimensions.x <= 0 || dimensions.y <= 0 || dimensions.z <= 0) {
+        throw std::runtime_error("TimeSeriesVolume::render(): "
+                                 "invalid volume dimensions");
+      }
+
+      const OSPDataType ospVoxelType = typeForString(voxelType);
+      const size_t numVoxels = (size_t)dimensions.x * (size_t)dimensions.y
+                               * (size_t)dimensions.z;
+
+      // we need one slot beyond the displayed one to prefetch into
+      const int numSlots = std::max(2, child("prefetchDepth").valueAs<int>());
+      slots.resize(numSlots);
+
+      // all OSPRay objects get created here, the loaders only ever
+      // touch the voxels of the slots they are loading into
+      for (auto &slot : slots) {
+        slot.voxels.reset(new uint8_t[numVoxels * sizeOf(ospVoxelType)]);
+        slot.voxelData = ospNewData(numVoxels, ospVoxelType,
+                                    slot.voxels.get(), OSP_DATA_SHARED_BUFFER);
+        slot.volume = ospNewVolume("shared_structured_volume");
+        if (!slot.volume)
+          THROW_SG_ERROR("could not allocate volume");
+        ospSetString(slot.volume, "voxelType", voxelType.c_str());
+        ospSetVec3i(slot.volume, "dimensions", (const osp::vec3i&)dimensions);
+        ospSetData(slot.volume, "voxelData", slot.voxelData);
+      }
+
+      isosurfacesGeometry = ospNewGeometry("isosurfaces");
+
+      requestedTimeStep = clamp(child("timeStep").valueAs<int>(),
+                                0, int(fileNames.size()) - 1);
+
+      for (int i = 0; i < numSlots - 1; ++i)
+        loaders.push_back(std::thread([&](){ loaderThread(); }));
+    }
+
+    void TimeSeriesVolume::stopLoaders()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+        requestChanged.notify_all();
+      }
+
+      for (auto &t : loaders)
+        t.join();
+      loaders.clear();
+    }
+
+    int TimeSeriesVolume::nextSlotToLoad()
+    {
+      const int numTimeSteps = fileNames.size();
+      const int numSlots     = slots.size();
+
+      auto wanted = [&](int timeStep) {
+        return (timeStep - requestedTimeStep + numTimeSteps) % numTimeSteps
+               < numSlots;
+      };
+
+      for (int i = 0; i < std::min(numSlots, numTimeSteps); i++) {
+        const int timeStep = (requestedTimeStep + i) % numTimeSteps;
+
+        bool present = false;
+        for (const auto &slot : slots)
+          present |= slot.timeStep == timeStep;
+        if (present)
+          continue;
+
+        // recycle a slot that's neither displayed, nor busy, nor holding
+        // a time step we're going to need soon
+        for (int s = 0; s < numSlots; s++) {
+          Slot &slot = slots[s];
+          if (s == displayedSlot || slot.loading ||
+              (slot.timeStep >= 0 && wanted(slot.timeStep)))
+            continue;
+
+          slot.timeStep = timeStep;
+          slot.loading  = true;
+          slot.ready    = false;
+          return s;
+        }
+
+        return -1;
+      }
+
+      return -1;
+    }
+
+    void TimeSeriesVolume::loaderThread()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (!quit) {
+        const int slotID = nextSlotToLoad();
+        if (slotID < 0) {
+          requestChanged.wait(lock);
+          continue;
+        }
+
+        Slot &slot = slots[slotID];
+        const int timeStep = slot.timeStep;
+
+        lock.unlock();
+        loadTimeStep(slot, timeStep);
+        lock.lock();
+
+        slot.loading = false;
+        slot.ready   = true;
+        slotLoaded.notify_all();
+      }
+    }
+
+    void TimeSeriesVolume::loadTimeStep(Slot &slot, int timeStep) const
+    {
+      const double startTime = getSysTime();
+
+      const FileName realFileName =
+          fileNameOfCorrespondingXmlDoc.path() + fileNames[timeStep];
+
+      const OSPDataType ospVoxelType = typeForString(voxelType);
+      const size_t voxelSize = sizeOf(ospVoxelType);
+      const size_t nVoxels = (size_t)dimensions.x * (size_t)dimensions.y
+                             * (size_t)dimensions.z;
+
+      slot.error.clear();
+      slot.voxelRange = vec2f(std::numeric_limits<float>::infinity(),
+                              -std::numeric_limits<float>::infinity());
+
+      FILE *file = fopen(realFileName.c_str(), "rb");
+      if (!file) {
+        slot.error = "TimeSeriesVolume: could not open file '"
+                     + realFileName.str() + "'";
+        return;
+      }
+
+      const size_t numRead = fread(slot.voxels.get(), voxelSize, nVoxels, file);
+      fclose(file);
+
+      if (numRead != nVoxels) {
+        slot.error = "TimeSeriesVolume: read incomplete data from '"
+                     + realFileName.str() + "' (truncated file or wrong"
+                     " format?!)";
+        return;
+      }
+
+      extendVoxelRange(slot.voxelRange, ospVoxelType,
+                       slot.voxels.get(), nVoxels);
+
+      const double seconds = getSysTime() - startTime;
+      ospLogF(1) << "#osp:sg: loaded time step " << timeStep << " in "
+                 << seconds << "s ("
+                 << nVoxels * voxelSize / (1024.0 * 1024.0) / seconds
+                 << " MB/s)" << std::endl;
+    }
+
+    OSP_REGISTER_SG_NODE(TimeSeriesVolume);
+
   } // ::ospray::sg
 } // ::ospray
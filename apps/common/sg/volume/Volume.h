@@ -19,6 +19,10 @@
 // sg
 #include "../common/Renderable.h"
 #include "../transferFunction/TransferFunction.h"
+// stl
+#include <condition_variable>
+#include <deque>
+#include <thread>
 
 namespace ospray {
   namespace sg {
@@ -119,5 +123,77 @@ namespace ospray {
       void loaderThread(LoaderState &state);
     };
 
+    /*! a time series of structured volumes, one raw file per time step
+        (all of the same dimensions and voxel type). 'prefetchDepth'
+        time steps are kept in a ring buffer: while the current one
+        renders, background threads load the ones following it, and the
+        node switches to the requested 'timeStep' when it gets committed
+        (ie, in between two frames) */
+    struct OSPSG_INTERFACE TimeSeriesVolume : public StructuredVolume
+    {
+      TimeSeriesVolume();
+      ~TimeSeriesVolume();
+
+      std::string toString() const override;
+
+      //! \brief Initialize this node's value from given XML node
+      void setFromXML(const xml::Node &node,
+                      const unsigned char *binBasePtr) override;
+
+      void preCommit(RenderContext &ctx) override;
+
+      //! \brief file name of the xml doc when the node was loaded from xml
+      /*! \detailed we need this to properly resolve relative file names */
+      FileName fileNameOfCorrespondingXmlDoc;
+
+      //! one file per time step, in order
+      std::vector<std::string> fileNames;
+
+    private:
+
+      //! \brief one entry of the ring buffer
+      struct Slot
+      {
+        int timeStep {-1};
+        bool loading {false};
+        bool ready {false};
+        std::string error;
+
+        std::unique_ptr<uint8_t[]> voxels;
+        vec2f voxelRange;
+
+        //! shares 'voxels', so there is no copy into a bricked layout
+        OSPVolume volume {nullptr};
+        OSPData voxelData {nullptr};
+      };
+
+      //! \brief allocate the ring buffer and launch the loader threads
+      void startLoaders();
+      void stopLoaders();
+
+      //! \brief worker thread function for loading time steps
+      void loaderThread();
+
+      /*! \brief pick a slot for the next not yet loaded time step after
+          the requested one, or return -1 if there is nothing to do (must
+          hold 'mutex') */
+      int nextSlotToLoad();
+
+      void loadTimeStep(Slot &slot, int timeStep) const;
+
+      std::vector<Slot> slots;
+      std::vector<std::thread> loaders;
+
+      std::mutex mutex;
+      std::condition_variable requestChanged;
+      std::condition_variable slotLoaded;
+      int requestedTimeStep {0};
+      int displayedSlot {-1};
+      bool quit {false};
+
+      //! when the last few time step switches happened
+      std::deque<double> switchTimes;
+    };
+
   } // ::ospray::sg
 } // ::ospray
@@ -0,0 +1,86 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file ospConvertScene.cpp converts any scene the ospray::sg importers
+    can read (.obj, .ply, .osp, .osx, RIVL .xml, .xyz, points:// urls,
+    ...) into an .ospb binary scene, which loads by mapping the file
+    instead of parsing it */
+
+#include "common/sg/SceneGraph.h"
+#include "common/sg/importer/Importer.h"
+// stl
+#include <chrono>
+#include <iostream>
+
+using namespace ospray;
+using namespace std::chrono;
+
+static void printUsage(const char *prog)
+{
+  std::cout << "usage: " << prog << " <input scene> <output.ospb>\n"
+            << "\n"
+            << "converts a scene readable by the ospray::sg importers into"
+            << " an .ospb binary\nscene; the converted scene is loaded once"
+            << " again to report the load time\n";
+}
+
+int main(int ac, const char **av)
+{
+  int init_error = ospInit(&ac, av);
+  if (init_error != OSP_NO_ERROR) {
+    std::cerr << "FATAL ERROR DURING INITIALIZATION!" << std::endl;
+    return init_error;
+  }
+
+  if (ac != 3) {
+    printUsage(av[0]);
+    return 1;
+  }
+
+  const FileName input  = av[1];
+  const std::string output = av[2];
+
+  try {
+    auto scene = sg::createNode(input.name(), "Node");
+
+    auto start = steady_clock::now();
+    if (!sg::importFileByExtension(scene, input)) {
+      std::cerr << "could not import '" << input.str() << "'" << std::endl;
+      return 1;
+    }
+    auto imported = steady_clock::now();
+
+    sg::writeBinaryScene(scene, output);
+    auto written = steady_clock::now();
+
+    auto loaded = sg::createNode(input.name(), "Node");
+    sg::loadBinaryScene(loaded, output);
+    auto reloaded = steady_clock::now();
+
+    std::cout << "imported '" << input.str() << "' in "
+              << duration<double>(imported - start).count() << "s\n"
+              << "wrote '" << output << "' in "
+              << duration<double>(written - imported).count() << "s\n"
+              << "loading '" << output << "' takes "
+              << duration<double>(reloaded - written).count() << "s"
+              << std::endl;
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
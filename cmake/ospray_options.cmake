@@ -98,7 +98,18 @@ OSPRAY_CONFIGURE_TASKING_SYSTEM()
 OPTION(OSPRAY_USE_EMBREE_STREAMS "Enable use of Embree's stream intersection")
 MARK_AS_ADVANCED(OSPRAY_USE_EMBREE_STREAMS) # feature not implemented yet
 
-SET(OSPRAY_TILE_SIZE 64 CACHE STRING "Tile size")
+OPTION(OSPRAY_ENABLE_TRACING
+       "Compile in trace markers (see the 'traceFile' device parameter)")
+MARK_AS_ADVANCED(OSPRAY_ENABLE_TRACING)
+IF (OSPRAY_ENABLE_TRACING)
+  ADD_DEFINITIONS(-DOSPRAY_ENABLE_TRACING)
+ENDIF()
+
+OPTION(OSPRAY_ENABLE_RAY_STATS
+       "Count every traced/shadow ray and volume sample (see ospGetFrameStats)")
+MARK_AS_ADVANCED(OSPRAY_ENABLE_RAY_STATS)
+
+SET(OSPRAY_TILE_SIZE 64 CACHE STRING "(Maximum) tile size, smaller tiles can be chosen at runtime")
 SET_PROPERTY(CACHE OSPRAY_TILE_SIZE PROPERTY STRINGS 8 16 32 64 128 256 512)
 MARK_AS_ADVANCED(OSPRAY_TILE_SIZE)
 
@@ -14,7 +14,9 @@
 // limitations under the License.                                           //
 // ======================================================================== //
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <thread>
 
 #include "MPIBcastFabric.h"
@@ -36,26 +38,44 @@ namespace mpicommon {
 #endif
   }
 
+  MPIBcastFabric::BlockHeader MPIBcastFabric::readHeader()
+  {
+    BlockHeader header;
+    // Get the size of the bcast being sent to us. This is non-blocking
+    // (as is the rest of the transfer) to avoid locking out the
+    // send/recv threads while we wait for the sender to show up.
+    MPI_Request request;
+    MPI_CALL(Ibcast(&header, sizeof(header), MPI_BYTE, recvRank,
+                    group.comm, &request));
+    waitForBcast(request);
+    return header;
+  }
+
   /*! receive some block of data - whatever the sender has sent -
     and give us size and pointer to this data */
   size_t MPIBcastFabric::read(void *&mem)
   {
-    uint32_t sz32 = 0;
-    // Get the size of the bcast being sent to us. Only this part must be non-blocking,
-    // after getting the size we know everyone will enter the blocking barrier and the
-    // blocking bcast where the buffer is sent out.
-    MPI_Request request;
-    MPI_CALL(Ibcast(&sz32, 1, MPI_INT, recvRank, group.comm, &request));
-
-    // Now do non-blocking test to see when this bcast is satisfied to avoid
-    // locking out the send/recv threads
-    waitForBcast(request);
+    const BlockHeader header = readHeader();
 
     // TODO: Maybe at some point we should dump the buffer if it gets really large
-    buffer.resize(sz32);
+    buffer.resize(header.size);
     mem = buffer.data();
-    MPI_CALL(Bcast(mem, sz32, MPI_BYTE, recvRank, group.comm));
-    return sz32;
+    bcastPayload(mem, header.size, header.chunkSize, recvRank);
+    return header.size;
+  }
+
+  size_t MPIBcastFabric::readInto(void *dst, size_t dstSize, void *&mem)
+  {
+    const BlockHeader header = readHeader();
+
+    if (header.size <= dstSize) {
+      mem = dst;
+    } else {
+      buffer.resize(header.size);
+      mem = buffer.data();
+    }
+    bcastPayload(mem, header.size, header.chunkSize, recvRank);
+    return header.size;
   }
 
   /*! send exact number of bytes - the fabric can do that through
@@ -63,32 +83,58 @@ namespace mpicommon {
     delivered */
   void MPIBcastFabric::send(void *mem, size_t size)
   {
-    assert(size < (1LL<<30));
-    uint32_t sz32 = size;
+    assert(chunkSize > 0 && chunkSize <= size_t(std::numeric_limits<int>::max()));
 
-    // Send the size of the bcast we're sending. Only this part must be non-blocking,
-    // after getting the size we know everyone will enter the blocking barrier and the
-    // blocking bcast where the buffer is sent out.
-    MPI_Request request;
-    MPI_CALL(Ibcast(&sz32, 1, MPI_INT, sendRank, group.comm, &request));
+    BlockHeader header;
+    header.size      = size;
+    header.chunkSize = chunkSize;
 
-    // Now do non-blocking test to see when this bcast is satisfied to avoid
-    // locking out the send/recv threads
+    MPI_Request request;
+    MPI_CALL(Ibcast(&header, sizeof(header), MPI_BYTE, sendRank,
+                    group.comm, &request));
     waitForBcast(request);
 
-    MPI_CALL(Bcast(mem, sz32, MPI_BYTE, sendRank, group.comm));
+    bcastPayload(mem, size, chunkSize, sendRank);
+  }
+
+  void MPIBcastFabric::bcastPayload(void *mem, size_t size,
+                                    size_t chunkSize, int root)
+  {
+    if (size == 0)
+      return;
+
+    // MPI matches non-blocking collectives on a communicator in the
+    // order they were issued, so sender and receivers only have to
+    // agree on the chunking, which the header takes care of
+    byte_t *ptr = (byte_t*)mem;
+    const size_t numChunks = (size + chunkSize - 1) / chunkSize;
+    std::vector<MPI_Request> inFlight(std::min(numChunks,
+                                               size_t(maxChunksInFlight)),
+                                      MPI_REQUEST_NULL);
+
+    for (size_t i = 0; i < numChunks; ++i) {
+      MPI_Request &request = inFlight[i % inFlight.size()];
+      waitForBcast(request);
+
+      const size_t begin = i * chunkSize;
+      const int    count = std::min(chunkSize, size - begin);
+      MPI_CALL(Ibcast(ptr + begin, count, MPI_BYTE, root,
+                      group.comm, &request));
+    }
+
+    for (auto &request : inFlight)
+      waitForBcast(request);
   }
 
   void MPIBcastFabric::waitForBcast(MPI_Request &request)
   {
     for(;;) {
-      int size_bcast_done;
-      MPI_CALL(Test(&request, &size_bcast_done, MPI_STATUS_IGNORE));
-      if (size_bcast_done)
+      int bcast_done;
+      MPI_CALL(Test(&request, &bcast_done, MPI_STATUS_IGNORE));
+      if (bcast_done)
         break;
       std::this_thread::sleep_for(std::chrono::nanoseconds(250));
     }
-    group.barrier();
   }
 
 } // ::mpicommon
@@ -26,6 +26,12 @@ namespace mpicommon {
   /*! a specific fabric based on MPI. Note that in the case of an
    *  MPIBcastFabric using an intercommunicator the send rank must
    *  be MPI_ROOT and the recv rank must be 0.
+   *
+   *  Each block is announced by a small header carrying its 64-bit
+   *  size and the chunk size used for it; the payload then follows
+   *  as a pipeline of non-blocking broadcasts of at most 'chunkSize'
+   *  bytes each, with up to 'maxChunksInFlight' of them outstanding
+   *  at a time. There are no barriers between (or within) blocks.
    */
   class OSPRAY_MPI_INTERFACE MPIBcastFabric : public networking::Fabric
   {
@@ -43,8 +49,29 @@ namespace mpicommon {
       and give us size and pointer to this data */
     virtual size_t read(void *&mem) override;
 
+    /*! receive the next block straight into 'dst' if it fits */
+    virtual size_t readInto(void *dst, size_t dstSize, void *&mem) override;
+
+    /*! max bytes per individual MPI broadcast, the sender's value is
+        the one that is used (it's sent along with each block) */
+    size_t chunkSize {64*1024*1024};
+    /*! max number of chunk broadcasts in flight at the same time */
+    int    maxChunksInFlight {4};
+
   private:
-    // wait for Bcast with non-blocking test, and barrier
+    struct BlockHeader
+    {
+      uint64_t size;
+      uint64_t chunkSize;
+    };
+
+    // receive the header of the next block
+    BlockHeader readHeader();
+
+    // (pipelined) broadcast of a block's payload from 'root'
+    void bcastPayload(void *mem, size_t size, size_t chunkSize, int root);
+
+    // wait for a non-blocking broadcast, without hogging the MPI lock
     void waitForBcast(MPI_Request &);
 
     std::vector<byte_t> buffer;
@@ -15,6 +15,8 @@
 // ======================================================================== //
 
 #include "MPICommon.h"
+#include "ospcommon/malloc.h"
+#include "ospcommon/utility/Trace.h"
 
 namespace mpicommon {
 
@@ -97,7 +99,7 @@ namespace mpicommon {
   /*! create a new message with given amount of bytes in storage */
   Message::Message(size_t size) : size(size)
   {
-    data = (ospcommon::byte_t*)malloc(size);
+    data = (ospcommon::byte_t*)ospcommon::alignedMalloc(size);
   }
 
   /*! create a new message with given amount of storage, and copy
@@ -124,7 +126,7 @@ namespace mpicommon {
   /*! destruct message and free allocated memory */
   Message::~Message()
   {
-    free(data);
+    ospcommon::alignedFree(data);
   }
 
   bool Message::isValid() const
@@ -151,6 +153,10 @@ namespace mpicommon {
     MPI_CALL(Comm_dup(MPI_COMM_WORLD, &world.comm));
     MPI_CALL(Comm_rank(world.comm, &world.rank));
     MPI_CALL(Comm_size(world.comm, &world.size));
+
+    // one trace file per rank, see the 'traceFile' device parameter
+    ospcommon::trace::setProcess(world.rank,
+                                 "rank " + std::to_string(world.rank));
     return !initialized;
   }
 
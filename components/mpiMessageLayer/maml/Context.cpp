@@ -21,6 +21,7 @@
 #include "ospcommon/tasking/async.h"
 #include "ospcommon/tasking/tasking_system_handle.h"
 #include "ospcommon/utility/getEnvVar.h"
+#include "ospcommon/utility/Trace.h"
 
 using ospcommon::AsyncLoop;
 using ospcommon::make_unique;
@@ -85,6 +86,7 @@ namespace maml {
       auto incomingMessages = inbox.consume();
 
       for (auto &message : incomingMessages) {
+        OSPRAY_TRACE_SCOPE_ARG("maml::handleIncoming", "bytes", message->size);
         auto *handler = handlers[message->comm];
         handler->incoming(message);
       }
@@ -95,6 +97,7 @@ namespace maml {
   {
     if (!outbox.empty()) {
       auto outgoingMessages = outbox.consume();
+      OSPRAY_TRACE_SCOPE_ARG("maml::send", "messages", outgoingMessages.size());
 
       for (auto &msg : outgoingMessages) {
         MPI_Request request;
@@ -118,6 +121,7 @@ namespace maml {
                       comm, &hasIncoming, &status));
 
       if (hasIncoming) {
+        OSPRAY_TRACE_SCOPE("maml::recv");
         int size;
         MPI_CALL(Get_count(&status, MPI_BYTE, &size));
 
@@ -138,6 +142,7 @@ namespace maml {
   void Context::waitOnSomeSendRequests()
   {
     if (!pendingSends.empty()) {
+      OSPRAY_TRACE_SCOPE_ARG("maml::testSends", "pending", pendingSends.size());
       int numDone = 0;
       int *done = STACK_BUFFER(int, pendingSends.size());
 
@@ -163,6 +168,7 @@ namespace maml {
   void Context::waitOnSomeRecvRequests()
   {
     if (!pendingRecvs.empty()) {
+      OSPRAY_TRACE_SCOPE_ARG("maml::waitRecvs", "pending", pendingRecvs.size());
       int numDone = 0;
       int *done = STACK_BUFFER(int, pendingRecvs.size());
 
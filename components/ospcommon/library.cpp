@@ -85,14 +85,15 @@ namespace ospcommon {
 
   LibraryRepository* LibraryRepository::getInstance()
   {
-    if (instance == nullptr)
-      instance = new LibraryRepository;
+    static std::once_flag created;
+    std::call_once(created, [](){ instance = new LibraryRepository; });
 
     return instance;
   }
 
   void LibraryRepository::add(const std::string& name)
   {
+    std::lock_guard<std::mutex> lock(mutex);
     if (repo.find(name) != repo.end())
       return; // lib already loaded.
 
@@ -101,6 +102,7 @@ namespace ospcommon {
 
   void* LibraryRepository::getSymbol(const std::string& name) const
   {
+    std::lock_guard<std::mutex> lock(mutex);
     void *sym = nullptr;
     for (auto lib = repo.cbegin(); sym == nullptr && lib != repo.end(); ++lib)
       sym = lib->second->getSymbol(name);
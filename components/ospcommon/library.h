@@ -17,6 +17,7 @@
 #include "common.h"
 // std
 #include <map>
+#include <mutex>
 #include <string>
 
 namespace ospcommon {
@@ -51,6 +52,8 @@ namespace ospcommon {
       static LibraryRepository* instance;
       LibraryRepository();
       std::map<std::string, Library*> repo;
+      //! modules may be loaded while other threads look up symbols
+      mutable std::mutex mutex;
   };
 }
 
@@ -160,25 +160,418 @@ namespace ospcommon
 ////////////////////////////////////////////////////////////////////////////////
 /// All Platforms
 ////////////////////////////////////////////////////////////////////////////////
-  
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+# include <sys/mman.h>
+#endif
+
 namespace ospcommon
 {
-  void* alignedMalloc(size_t size, size_t align) 
+  /* Every alignedMalloc() allocation is preceded by a header that tells
+     alignedFree() where the memory came from:
+
+       [ ... | AllocationHeader | user memory ... ]
+                                ^ aligned to 'align' (at least 64)
+
+     - ALLOC_POOLED: a block of one of the power-of-two size classes,
+       recycled through a thread-local free list (and a shared pool)
+     - ALLOC_HUGE:   a separate mapping, 2MB aligned and backed by huge
+       pages
+     - ALLOC_SYSTEM: everything else, straight from _mm_malloc()
+  */
+
+  enum AllocationKind { ALLOC_SYSTEM, ALLOC_POOLED, ALLOC_HUGE };
+
+  struct AllocationHeader
+  {
+    void    *base;     //!< what to give back to the system
+    size_t   size;     //!< bytes requested by the user
+    size_t   mapped;   //!< bytes of the mapping (ALLOC_HUGE only)
+    int32_t  kind;
+    int32_t  sizeClass;
+  };
+
+  static const size_t HEADER_SPACE   = 64;
+  static const size_t HUGE_PAGE_SIZE = 2*1024*1024;
+
+  // pooled size classes are 2^MIN_CLASS_BITS .. 2^MAX_CLASS_BITS bytes,
+  // header included
+  static const int MIN_CLASS_BITS = 7;
+  static const int MAX_CLASS_BITS = 20;
+  static const int NUM_CLASSES    = MAX_CLASS_BITS - MIN_CLASS_BITS + 1;
+
+  // bytes per size class a thread keeps for itself, and bytes the shared
+  // pool holds on to before blocks are given back to the system
+  static const size_t THREAD_CACHE_BYTES = 512*1024;
+  static const size_t SHARED_POOL_BYTES  = 64*1024*1024;
+
+  static inline AllocationHeader *headerOf(void *ptr)
+  {
+    return (AllocationHeader*)((char*)ptr - sizeof(AllocationHeader));
+  }
+
+  // Configuration and statistics /////////////////////////////////////////////
+
+  // read on every allocation, thus no lock
+  static std::atomic<int>    g_hugePages {HUGE_PAGES_OFF};
+  static std::atomic<size_t> g_hugePageThreshold {4*1024*1024};
+  static std::atomic<bool>   g_usePools {false};
+
+  static std::atomic<size_t> g_bytesInUse {0};
+  static std::atomic<size_t> g_peakBytesInUse {0};
+  static std::atomic<size_t> g_numAllocations {0};
+  static std::atomic<size_t> g_numFrees {0};
+  static std::atomic<size_t> g_numPoolHits {0};
+  static std::atomic<size_t> g_bytesPooled {0};
+  static std::atomic<size_t> g_numHugePageAllocations {0};
+  static std::atomic<size_t> g_hugePageBytesInUse {0};
+
+  static void releaseSharedPool();
+
+  void setAllocatorConfig(const AllocatorConfig &config)
+  {
+    g_hugePages         = config.hugePages;
+    g_hugePageThreshold = config.hugePageThreshold;
+    g_usePools          = config.usePools;
+    if (!config.usePools)
+      releaseSharedPool();
+  }
+
+  AllocatorConfig allocatorConfig()
+  {
+    AllocatorConfig config;
+    config.hugePages         = (HugePageMode)g_hugePages.load();
+    config.hugePageThreshold = g_hugePageThreshold;
+    config.usePools          = g_usePools;
+    return config;
+  }
+
+  AllocationStats allocationStats()
+  {
+    AllocationStats stats;
+    stats.bytesInUse             = g_bytesInUse;
+    stats.peakBytesInUse         = g_peakBytesInUse;
+    stats.numAllocations         = g_numAllocations;
+    stats.numFrees               = g_numFrees;
+    stats.numPoolHits            = g_numPoolHits;
+    stats.bytesPooled            = g_bytesPooled;
+    stats.numHugePageAllocations = g_numHugePageAllocations;
+    stats.hugePageBytesInUse     = g_hugePageBytesInUse;
+    return stats;
+  }
+
+  static inline void countAllocation(size_t size)
+  {
+    g_numAllocations.fetch_add(1, std::memory_order_relaxed);
+    const size_t inUse =
+      g_bytesInUse.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = g_peakBytesInUse.load(std::memory_order_relaxed);
+    while (inUse > peak &&
+           !g_peakBytesInUse.compare_exchange_weak(peak, inUse,
+                                                   std::memory_order_relaxed));
+  }
+
+  static inline void countFree(size_t size)
+  {
+    g_numFrees.fetch_add(1, std::memory_order_relaxed);
+    g_bytesInUse.fetch_sub(size, std::memory_order_relaxed);
+  }
+
+  // Size-class pools /////////////////////////////////////////////////////////
+
+  /*! blocks nobody's thread cache wants right now */
+  struct SharedPool
+  {
+    std::mutex mutex;
+    std::vector<void*> blocks[NUM_CLASSES];
+  };
+
+  static SharedPool &sharedPool()
+  {
+    // never destroyed, thread caches may still flush into it at exit
+    static SharedPool *pool = new SharedPool;
+    return *pool;
+  }
+
+  /*! per-thread free lists, linked through the first word of the
+      blocks; trivially destructible so that it stays usable even while
+      other thread_local objects get destroyed */
+  struct ThreadCache
+  {
+    void     *head[NUM_CLASSES];
+    uint32_t  count[NUM_CLASSES];
+    bool      registered;
+    bool      exited;
+  };
+
+  static thread_local ThreadCache t_cache;
+
+  static inline size_t classSize(int c)
+  {
+    return size_t(1) << (c + MIN_CLASS_BITS);
+  }
+
+  static inline size_t maxCachedBlocks(int c)
+  {
+    return std::max(size_t(2), THREAD_CACHE_BYTES / classSize(c));
+  }
+
+  static inline void *popBlock(ThreadCache &cache, int c)
+  {
+    void *block = cache.head[c];
+    cache.head[c] = *(void**)block;
+    cache.count[c]--;
+    return block;
+  }
+
+  static inline void pushBlock(ThreadCache &cache, int c, void *block)
+  {
+    *(void**)block = cache.head[c];
+    cache.head[c] = block;
+    cache.count[c]++;
+  }
+
+  /*! move 'n' blocks of class 'c' from the thread cache to the shared
+      pool, giving them back to the system if the shared pool is full (or
+      pools got disabled) */
+  static void releaseBlocks(ThreadCache &cache, int c, size_t n)
+  {
+    std::vector<void*> toFree;
+    {
+      SharedPool &pool = sharedPool();
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      for (size_t i = 0; i < n && cache.head[c]; i++) {
+        void *block = popBlock(cache, c);
+        if (!g_usePools.load(std::memory_order_relaxed) ||
+            g_bytesPooled.load(std::memory_order_relaxed) >
+            SHARED_POOL_BYTES) {
+          g_bytesPooled.fetch_sub(classSize(c), std::memory_order_relaxed);
+          toFree.push_back(block);
+        } else {
+          pool.blocks[c].push_back(block);
+        }
+      }
+    }
+    for (auto *block : toFree)
+      _mm_free(block);
+  }
+
+  /*! gives all blocks of the shared pool back to the system; blocks in
+      the thread caches stay there until they get reused */
+  static void releaseSharedPool()
+  {
+    std::vector<void*> toFree;
+    {
+      SharedPool &pool = sharedPool();
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      for (int c = 0; c < NUM_CLASSES; c++) {
+        g_bytesPooled.fetch_sub(pool.blocks[c].size() * classSize(c),
+                                std::memory_order_relaxed);
+        toFree.insert(toFree.end(),
+                      pool.blocks[c].begin(), pool.blocks[c].end());
+        pool.blocks[c].clear();
+      }
+    }
+    for (auto *block : toFree)
+      _mm_free(block);
+  }
+
+  /*! returns the blocks of an exiting thread to the shared pool */
+  struct ThreadCacheFlusher
+  {
+    ~ThreadCacheFlusher()
+    {
+      for (int c = 0; c < NUM_CLASSES; c++)
+        releaseBlocks(t_cache, c, t_cache.count[c]);
+      t_cache.exited = true;
+    }
+  };
+
+  static thread_local ThreadCacheFlusher t_cacheFlusher;
+
+  static void *allocatePooled(int c)
+  {
+    ThreadCache &cache = t_cache;
+    if (!cache.registered && !cache.exited) {
+      // odr-use the flusher, so that it gets constructed (and thus
+      // destroyed at thread exit)
+      (void)&t_cacheFlusher;
+      cache.registered = true;
+    }
+
+    if (!cache.head[c] && !cache.exited) {
+      // refill half a cache's worth of blocks from the shared pool
+      SharedPool &pool = sharedPool();
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      auto &blocks = pool.blocks[c];
+      const size_t n = std::min(blocks.size(), maxCachedBlocks(c) / 2 + 1);
+      for (size_t i = 0; i < n; i++) {
+        pushBlock(cache, c, blocks.back());
+        blocks.pop_back();
+      }
+    }
+
+    if (cache.head[c]) {
+      g_numPoolHits.fetch_add(1, std::memory_order_relaxed);
+      g_bytesPooled.fetch_sub(classSize(c), std::memory_order_relaxed);
+      return popBlock(cache, c);
+    }
+
+    void *block = _mm_malloc(classSize(c), HEADER_SPACE);
+    if (!block) throw std::bad_alloc();
+    return block;
+  }
+
+  static void freePooled(void *block, int c)
+  {
+    if (!g_usePools.load(std::memory_order_relaxed)) {
+      // pools got disabled since, don't hold on to the memory
+      _mm_free(block);
+      return;
+    }
+
+    g_bytesPooled.fetch_add(classSize(c), std::memory_order_relaxed);
+
+    ThreadCache &cache = t_cache;
+    if (cache.exited) {
+      // called from some static/thread_local destructor after our cache
+      // got flushed; no point in caching anything anymore
+      pushBlock(cache, c, block);
+      releaseBlocks(cache, c, 1);
+      return;
+    }
+
+    pushBlock(cache, c, block);
+    if (cache.count[c] > maxCachedBlocks(c))
+      releaseBlocks(cache, c, cache.count[c] / 2);
+  }
+
+  // Huge pages ///////////////////////////////////////////////////////////////
+
+  /*! map 'bytes' (a multiple of HUGE_PAGE_SIZE) backed by huge pages;
+      returns nullptr if that is not possible on this system */
+  static void *mapHugePages(size_t bytes, HugePageMode mode)
+  {
+#ifdef __linux__
+# ifdef MAP_HUGETLB
+    if (mode == HUGE_PAGES_EXPLICIT) {
+      void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (ptr != MAP_FAILED)
+        return ptr;
+      // no (or not enough) huge pages reserved, try transparent ones
+    }
+# endif
+    // over-allocate to be able to cut out a 2MB aligned range, such that
+    // transparent huge pages can back all of it
+    const size_t mapped = bytes + HUGE_PAGE_SIZE;
+    char *ptr = (char*)mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+      return nullptr;
+
+    char *aligned = (char*)ALIGN_PTR(ptr, HUGE_PAGE_SIZE);
+    if (aligned > ptr)
+      munmap(ptr, aligned - ptr);
+    const size_t tail = (ptr + mapped) - (aligned + bytes);
+    if (tail > 0)
+      munmap(aligned + bytes, tail);
+
+# ifdef MADV_HUGEPAGE
+    madvise(aligned, bytes, MADV_HUGEPAGE);
+# endif
+    return aligned;
+#else
+    (void)bytes;
+    (void)mode;
+    return nullptr;
+#endif
+  }
+
+  static void unmapHugePages(void *ptr, size_t bytes)
+  {
+#ifdef __linux__
+    munmap(ptr, bytes);
+#else
+    (void)ptr;
+    (void)bytes;
+#endif
+  }
+
+  // alignedMalloc/alignedFree ////////////////////////////////////////////////
+
+  void* alignedMalloc(size_t size, size_t align)
   {
     assert((align & (align-1)) == 0);
-//#if defined(TASKING_TBB) // FIXME: have to disable this for now as the TBB allocator itself seems to access some uninitialized value when using valgrind
-//    return scalable_aligned_malloc(size,align);
-//#else
-    return _mm_malloc(size,align);
-//#endif
-  }
-  
-  void alignedFree(void* ptr) 
-  {
-//#if defined(TASKING_TBB)
-//    scalable_aligned_free(ptr);
-//#else
-    _mm_free(ptr);
-//#endif
+    const size_t offset = std::max(align, HEADER_SPACE);
+    const AllocatorConfig config = allocatorConfig();
+
+    AllocationHeader header;
+    header.size      = size;
+    header.mapped    = 0;
+    header.sizeClass = -1;
+
+    char *ptr = nullptr;
+    const size_t total = offset + size;
+
+    if (config.usePools && offset == HEADER_SPACE &&
+        total <= classSize(NUM_CLASSES-1)) {
+      int c = 0;
+      while (classSize(c) < total)
+        c++;
+      header.kind      = ALLOC_POOLED;
+      header.sizeClass = c;
+      header.base      = allocatePooled(c);
+      ptr = (char*)header.base + offset;
+    } else if (config.hugePages != HUGE_PAGES_OFF &&
+               size >= config.hugePageThreshold) {
+      const size_t mapped =
+        (total + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+      header.base = mapHugePages(mapped, config.hugePages);
+      if (header.base) {
+        header.kind   = ALLOC_HUGE;
+        header.mapped = mapped;
+        ptr = (char*)header.base + offset;
+        g_numHugePageAllocations.fetch_add(1, std::memory_order_relaxed);
+        g_hugePageBytesInUse.fetch_add(size, std::memory_order_relaxed);
+      }
+    }
+
+    if (!ptr) {
+      header.kind = ALLOC_SYSTEM;
+      header.base = _mm_malloc(total, offset);
+      if (!header.base) throw std::bad_alloc();
+      ptr = (char*)header.base + offset;
+    }
+
+    *headerOf(ptr) = header;
+    countAllocation(size);
+    return ptr;
+  }
+
+  void alignedFree(void* ptr)
+  {
+    if (!ptr)
+      return;
+
+    const AllocationHeader header = *headerOf(ptr);
+    countFree(header.size);
+
+    switch (header.kind) {
+    case ALLOC_POOLED:
+      freePooled(header.base, header.sizeClass);
+      break;
+    case ALLOC_HUGE:
+      g_hugePageBytesInUse.fetch_sub(header.size, std::memory_order_relaxed);
+      unmapHugePages(header.base, header.mapped);
+      break;
+    default:
+      _mm_free(header.base);
+    }
   }
 }
@@ -23,10 +23,58 @@ namespace ospcommon
 #define ALIGN_PTR(ptr,alignment) \
   ((((size_t)ptr)+alignment-1)&((size_t)-(ssize_t)alignment))
 
-  /*! aligned allocation */
+  /*! aligned allocation; small allocations are served from thread-local
+      pools, large ones may be backed by huge pages (see
+      AllocatorConfig). memory returned by alignedMalloc() must only be
+      released with alignedFree() */
   OSPCOMMON_INTERFACE void* alignedMalloc(size_t size, size_t align = 64);
   OSPCOMMON_INTERFACE void alignedFree(void* ptr);
 
+  /*! how large allocations are backed */
+  typedef enum {
+    HUGE_PAGES_OFF,         //!< regular pages
+    HUGE_PAGES_TRANSPARENT, //!< 2MB aligned, advise transparent huge pages
+    HUGE_PAGES_EXPLICIT     //!< MAP_HUGETLB, falling back to transparent
+  } HugePageMode;
+
+  /*! configuration of the alignedMalloc() backend; changing it only
+      affects allocations made afterwards. pools and huge pages are off
+      by default */
+  struct AllocatorConfig
+  {
+    HugePageMode hugePages {HUGE_PAGES_OFF};
+    /*! allocations of at least this many bytes use huge pages */
+    size_t hugePageThreshold {4*1024*1024};
+    /*! serve small allocations from thread-local size-class pools; each
+        thread keeps about 9MB of freed blocks and all threads share up
+        to 64MB more. none of it is given back to the system while pools
+        are enabled; disabling them frees the shared pool, and the thread
+        caches once their threads exit. recycled blocks are already
+        touched, i.e., they keep their NUMA placement */
+    bool usePools {false};
+  };
+
+  OSPCOMMON_INTERFACE void setAllocatorConfig(const AllocatorConfig &config);
+  OSPCOMMON_INTERFACE AllocatorConfig allocatorConfig();
+
+  /*! counters of the alignedMalloc() backend, all in bytes or calls
+      since program start */
+  struct AllocationStats
+  {
+    size_t bytesInUse {0};     //!< requested bytes currently allocated
+    size_t peakBytesInUse {0}; //!< maximum of bytesInUse so far
+    size_t numAllocations {0};
+    size_t numFrees {0};
+    /*! allocations served from a pool without going to the system */
+    size_t numPoolHits {0};
+    /*! bytes sitting unused in the pools */
+    size_t bytesPooled {0};
+    size_t numHugePageAllocations {0};
+    size_t hugePageBytesInUse {0};
+  };
+
+  OSPCOMMON_INTERFACE AllocationStats allocationStats();
+
   template<typename T>
    __forceinline T* alignedMalloc(size_t nElements, size_t align = 64)
   {
@@ -19,8 +19,12 @@
 namespace ospcommon {
   namespace networking {
 
-    BufferedReadStream::BufferedReadStream(Fabric &fabric)
-      : fabric(fabric), buffer(nullptr), numAvailable(0)
+    BufferedReadStream::BufferedReadStream(Fabric &fabric,
+                                           size_t directReadThreshold)
+      : fabric(fabric),
+        buffer(nullptr),
+        numAvailable(0),
+        directReadThreshold(directReadThreshold)
     {
     }
 
@@ -39,7 +43,20 @@ namespace ospcommon {
         if (numWeCanDeliver == 0) {
           // read some more ... we HAVE to fulfill this 'read()'
           // request, so have to read here
-          numAvailable = fabric.get().read((void*&)buffer);
+          if (numStillMissing >= directReadThreshold) {
+            // large request: let the fabric put the next block right
+            // where it belongs if it fits
+            numAvailable = fabric.get().readInto(writePtr, numStillMissing,
+                                                 (void*&)buffer);
+            if (buffer == writePtr) {
+              numStillMissing -= numAvailable;
+              writePtr        += numAvailable;
+              buffer          += numAvailable;
+              numAvailable     = 0;
+            }
+          } else {
+            numAvailable = fabric.get().read((void*&)buffer);
+          }
           continue;
         }
         
@@ -67,6 +84,13 @@ namespace ospcommon {
 
     void BufferedWriteStream::write(void *mem, size_t size)
     {
+      if (size >= maxBufferSize) {
+        // no point in copying large blocks into the buffer first
+        flush();
+        fabric.get().send(mem, size);
+        return;
+      }
+
       size_t stillToWrite = size;
       uint8_t *readPtr = (uint8_t*)mem;
       while (stillToWrite) {
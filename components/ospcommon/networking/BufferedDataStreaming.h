@@ -26,9 +26,13 @@ namespace ospcommon {
        size) from a block of data that it queries from a fabric. if
        the internal buffer isn't big enough to fulfill the request,
        the next block will automatically get read from the fabric */
+    /* read requests of at least 'directReadThreshold' bytes that
+       can't be served from the current block are received straight
+       into the destination memory (see Fabric::readInto) */
     struct OSPCOMMON_INTERFACE BufferedReadStream : public ReadStream
     {
-      BufferedReadStream(Fabric &fabric);
+      BufferedReadStream(Fabric &fabric,
+                         size_t directReadThreshold = 1LL*1024*1024);
       ~BufferedReadStream() = default;
 
       void read(void *mem, size_t size) override;
@@ -38,13 +42,15 @@ namespace ospcommon {
       std::reference_wrapper<Fabric> fabric;
       ospcommon::byte_t *buffer;
       size_t numAvailable;
+      size_t directReadThreshold;
     };
 
     /*! maintains an internal buffer of a given size, and buffers
       all write ops preferably into this buffer; this internal
       buffer gets flushed either when the user explicitly calls
       flush(), or when the maximum size of the buffer gets
-      reached */
+      reached. writes that are at least as large as the buffer get
+      sent straight from the user's memory, without an extra copy */
     struct OSPCOMMON_INTERFACE BufferedWriteStream : public WriteStream
     {
       BufferedWriteStream(Fabric &fabric, size_t maxBufferSize = 1LL*1024*1024);
@@ -33,6 +33,18 @@ namespace ospcommon {
       /*! receive some block of data - whatever the sender has sent -
         and give us size and pointer to this data */
       virtual size_t read(void *&mem) = 0;
+
+      /*! receive the next block of data, preferably straight into
+        'dst': if the block is no larger than 'dstSize' bytes it is
+        written to 'dst' (and 'mem' set to 'dst'), otherwise this
+        behaves like read(). fabrics that can't receive into user
+        memory simply use read() */
+      virtual size_t readInto(void *dst, size_t dstSize, void *&mem)
+      {
+        (void)dst;
+        (void)dstSize;
+        return read(mem);
+      }
     };
 
   } // ::ospcommon::networking
@@ -0,0 +1,223 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "numa.h"
+#include "sysinfo.h"
+// stl
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+# include <sched.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+namespace ospcommon {
+  namespace numa {
+
+    /*! node -> cpus of that node, read once from sysfs */
+    struct Topology
+    {
+      Topology()
+      {
+#ifdef __linux__
+        const std::string online = "/sys/devices/system/node/online";
+        for (int node : parseList(readLine(online))) {
+          const std::string cpuList = "/sys/devices/system/node/node"
+            + std::to_string(node) + "/cpulist";
+          const std::vector<int> cpus = parseList(readLine(cpuList));
+          if (cpus.empty())
+            continue; // memory-only node
+          maxNodeID = std::max(maxNodeID, node);
+          nodeIDs.push_back(node);
+          for (int cpu : cpus) {
+            if (cpu >= (int)cpuToNode.size())
+              cpuToNode.resize(cpu + 1, 0);
+            cpuToNode[cpu] = (int)nodeIDs.size() - 1;
+            orderedCPUs.push_back(cpu);
+          }
+        }
+#endif
+        if (nodeIDs.empty()) {
+          nodeIDs = {0};
+          maxNodeID = 0;
+          orderedCPUs.clear();
+          cpuToNode.clear();
+          const int numCPUs = std::max(1u, std::thread::hardware_concurrency());
+          for (int i = 0; i < numCPUs; i++) {
+            orderedCPUs.push_back(i);
+            cpuToNode.push_back(0);
+          }
+        }
+      }
+
+      static std::string readLine(const std::string &fileName)
+      {
+        std::ifstream in(fileName);
+        std::string line;
+        std::getline(in, line);
+        return line;
+      }
+
+      /*! parse a sysfs list such as "0-3,8-11" */
+      static std::vector<int> parseList(const std::string &list)
+      {
+        std::vector<int> result;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+          if (range.empty())
+            continue;
+          const size_t dash = range.find('-');
+          const int begin = std::stoi(range.substr(0, dash));
+          const int end   = dash == std::string::npos ?
+                            begin : std::stoi(range.substr(dash + 1));
+          for (int i = begin; i <= end; i++)
+            result.push_back(i);
+        }
+        return result;
+      }
+
+      std::vector<int> nodeIDs;     //!< OS node IDs, indexed by our node index
+      std::vector<int> cpuToNode;   //!< logical cpu -> our node index
+      std::vector<int> orderedCPUs; //!< all cpus, node by node
+      int maxNodeID {0};
+    };
+
+    static const Topology &topology()
+    {
+      static Topology topo;
+      return topo;
+    }
+
+    static std::atomic<int> g_mode {NONE};
+
+    Mode parseMode(const std::string &mode)
+    {
+      if (mode == "interleave")
+        return INTERLEAVE;
+      else if (mode == "local")
+        return LOCAL;
+      else if (mode.empty() || mode == "none" || mode == "0")
+        return NONE;
+      throw std::runtime_error("unknown NUMA mode '" + mode + "' (must be "
+                               "'none', 'interleave' or 'local')");
+    }
+
+    void setMode(Mode mode)
+    {
+      g_mode = mode;
+    }
+
+    Mode mode()
+    {
+      return (Mode)g_mode.load();
+    }
+
+    int numNodes()
+    {
+      return (int)topology().nodeIDs.size();
+    }
+
+    int nodeOfCPU(int cpu)
+    {
+      const auto &cpuToNode = topology().cpuToNode;
+      return (cpu >= 0 && cpu < (int)cpuToNode.size()) ? cpuToNode[cpu] : 0;
+    }
+
+    int currentNode()
+    {
+#ifdef __linux__
+      if (numNodes() > 1)
+        return nodeOfCPU(sched_getcpu());
+#endif
+      return 0;
+    }
+
+    const std::vector<int> &cpusByNode()
+    {
+      return topology().orderedCPUs;
+    }
+
+#ifdef __linux__
+    /*! apply a memory policy to all pages fully inside the given range */
+    static void bindPages(void *ptr, size_t numBytes, int policy,
+                          const std::vector<int> &nodes)
+    {
+# ifdef SYS_mbind
+      const size_t pageMask = ~size_t(PAGE_SIZE - 1);
+      const size_t begin = ((size_t)ptr + PAGE_SIZE - 1) & pageMask;
+      const size_t end   = ((size_t)ptr + numBytes) & pageMask;
+      if (end <= begin)
+        return;
+
+      const auto &topo = topology();
+      const size_t bitsPerWord = 8 * sizeof(unsigned long);
+      std::vector<unsigned long> mask(topo.maxNodeID / bitsPerWord + 2, 0ul);
+      for (int n : nodes) {
+        const int id = topo.nodeIDs[n];
+        mask[id / bitsPerWord] |= 1ul << (id % bitsPerWord);
+      }
+
+      if (syscall(SYS_mbind, (void*)begin, end - begin, policy, mask.data(),
+                  mask.size() * bitsPerWord, 0) != 0) {
+        static std::once_flag warned;
+        std::call_once(warned, [](){
+          WARNING("mbind() failed, NUMA placement hints will be ignored");
+        });
+      }
+# endif
+    }
+
+    // from <linux/mempolicy.h>, which is not always installed
+    static const int OSP_MPOL_PREFERRED  = 1;
+    static const int OSP_MPOL_INTERLEAVE = 3;
+#endif
+
+    void interleave(void *ptr, size_t numBytes)
+    {
+#ifdef __linux__
+      if (numNodes() < 2)
+        return;
+      std::vector<int> nodes(numNodes());
+      for (int i = 0; i < numNodes(); i++)
+        nodes[i] = i;
+      bindPages(ptr, numBytes, OSP_MPOL_INTERLEAVE, nodes);
+#endif
+    }
+
+    void placeOnNode(void *ptr, size_t numBytes, int node)
+    {
+#ifdef __linux__
+      if (numNodes() < 2 || node < 0 || node >= numNodes())
+        return;
+      bindPages(ptr, numBytes, OSP_MPOL_PREFERRED, {node});
+#endif
+    }
+
+    void distribute(void *ptr, size_t numBytes)
+    {
+      if (ptr && mode() != NONE)
+        interleave(ptr, numBytes);
+    }
+
+  } // ::ospcommon::numa
+} // ::ospcommon
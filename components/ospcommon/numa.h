@@ -0,0 +1,82 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "common.h"
+// stl
+#include <vector>
+
+/*! \file numa.h helpers for placing large buffers on NUMA systems.
+
+    The topology is read from /sys/devices/system/node, and pages are
+    placed with the mbind() syscall, so there is no dependency on
+    libnuma. On all other platforms (or single node machines) everything
+    in here degenerates to a no-op on a single node.
+*/
+
+namespace ospcommon {
+  namespace numa {
+
+    /*! how large buffers get placed on the nodes of the machine */
+    typedef enum {
+      NONE,       //!< leave placement to the OS (first touch)
+      INTERLEAVE, //!< interleave all large buffers page by page
+      LOCAL       //!< like INTERLEAVE, but framebuffer tiles are kept
+                  //!  on (and rendered by) a fixed node
+    } Mode;
+
+    /*! parse a mode from "none", "interleave" or "local" */
+    OSPCOMMON_INTERFACE Mode parseMode(const std::string &mode);
+
+    /*! set/get the placement mode used by distribute() and friends */
+    OSPCOMMON_INTERFACE void setMode(Mode mode);
+    OSPCOMMON_INTERFACE Mode mode();
+
+    /*! number of NUMA nodes in the system (at least 1) */
+    OSPCOMMON_INTERFACE int numNodes();
+
+    /*! the node the given logical cpu belongs to */
+    OSPCOMMON_INTERFACE int nodeOfCPU(int cpu);
+
+    /*! the node the calling thread currently runs on */
+    OSPCOMMON_INTERFACE int currentNode();
+
+    /*! all logical cpus, ordered node by node; used to pin threads such
+        that consecutive thread IDs share a node */
+    OSPCOMMON_INTERFACE const std::vector<int> &cpusByNode();
+
+    /*! interleave the (not yet touched) pages of the given buffer over
+        all nodes; only pages fully inside the buffer are affected */
+    OSPCOMMON_INTERFACE void interleave(void *ptr, size_t numBytes);
+
+    /*! prefer the given node for the (not yet touched) pages of the
+        given buffer */
+    OSPCOMMON_INTERFACE void placeOnNode(void *ptr, size_t numBytes, int node);
+
+    /*! interleave a freshly allocated large buffer if a NUMA mode is
+        active, do nothing otherwise */
+    OSPCOMMON_INTERFACE void distribute(void *ptr, size_t numBytes);
+
+    /*! which node owns item 'i' of 'n' items that are split into
+        'numNodes' contiguous, equally sized ranges */
+    inline int blockNode(size_t i, size_t n, int numNodes)
+    {
+      return n == 0 ? 0 : int((i * numNodes) / n);
+    }
+
+  } // ::ospcommon::numa
+} // ::ospcommon
@@ -20,6 +20,10 @@
 //stl
 #include <thread>
 #include <vector>
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+#endif
 
 namespace ospcommon {
   namespace tasking {
@@ -196,6 +200,22 @@ namespace ospcommon {
         return static_cast<int>(TaskSys::global.threads.size());
       }
 
+      void pinThreadsTaskSystemInternal(const std::vector<int> &cpus)
+      {
+#ifdef __linux__
+        if (cpus.empty())
+          return;
+        auto &threads = TaskSys::global.threads;
+        for (size_t t = 0; t < threads.size(); t++) {
+          cpu_set_t cset;
+          CPU_ZERO(&cset);
+          CPU_SET(cpus[(t + 1) % cpus.size()], &cset);
+          pthread_setaffinity_np(threads[t].native_handle(),
+                                 sizeof(cset), &cset);
+        }
+#endif
+      }
+
       void scheduleTaskInternal(Task *task,
                                 int numJobs,
                                 ScheduleOrder order)
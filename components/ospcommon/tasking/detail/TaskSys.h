@@ -21,6 +21,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <vector>
 
 namespace ospcommon {
   namespace tasking {
@@ -91,6 +92,11 @@ namespace ospcommon {
 
       int OSPCOMMON_INTERFACE numThreadsTaskSystemInternal();
 
+      /*! pin worker thread 't' to logical cpu 'cpus[(t+1) % cpus.size()]'
+          (slot 0 is left for the thread that calls wait()) */
+      void OSPCOMMON_INTERFACE
+      pinThreadsTaskSystemInternal(const std::vector<int> &cpus);
+
       //! schedule the given task with the given number of sub-jobs.
       void scheduleTaskInternal(Task *task,
                                 int numJobs,
@@ -20,6 +20,7 @@
 #if defined(OSPRAY_TASKING_TBB)
 # include <tbb/task_arena.h>
 # include <tbb/task_scheduler_init.h>
+# include <tbb/task_scheduler_observer.h>
 #elif defined(OSPRAY_TASKING_CILK)
 # include <cilk/cilk_api.h>
 #elif defined(OSPRAY_TASKING_OMP)
@@ -28,10 +29,13 @@
 # include "TaskSys.h"
 #endif
 
+#include <atomic>
 #include <thread>
 
 #include "../../intrinsics.h"
 #include "../../common.h"
+#include "../../numa.h"
+#include "../../thread.h"
 
 namespace ospcommon {
   namespace tasking {
@@ -120,5 +124,49 @@ namespace ospcommon {
 #endif
     }
 
+#if defined(OSPRAY_TASKING_TBB)
+    /*! pins every TBB worker to the next cpu in node order when it enters
+        the scheduler */
+    struct PinningObserver : public tbb::task_scheduler_observer
+    {
+      PinningObserver() { observe(true); }
+      ~PinningObserver() { observe(false); }
+
+      void on_scheduler_entry(bool isWorker) override
+      {
+        if (!isWorker)
+          return;
+        const auto &cpus = numa::cpusByNode();
+        setAffinity(cpus[nextCPU++ % cpus.size()]);
+      }
+
+      // cpu 0 of the list is taken by the master thread
+      std::atomic<size_t> nextCPU {1};
+    };
+
+    static std::unique_ptr<PinningObserver> g_pinning_observer;
+#endif
+
+    void pinTaskingThreads()
+    {
+      const auto &cpus = numa::cpusByNode();
+      if (cpus.empty())
+        return;
+
+#if defined(OSPRAY_TASKING_TBB)
+      setAffinity(cpus[0]);
+      if (!g_pinning_observer.get())
+        g_pinning_observer = make_unique<PinningObserver>();
+#elif defined(OSPRAY_TASKING_OMP)
+      #pragma omp parallel
+      {
+        setAffinity(cpus[omp_get_thread_num() % cpus.size()]);
+      }
+#elif defined(OSPRAY_TASKING_INTERNAL)
+      setAffinity(cpus[0]);
+      detail::pinThreadsTaskSystemInternal(cpus);
+#endif
+    }
+
   } // ::ospcommon::tasking
 } // ::ospcommon
@@ -25,5 +25,9 @@ namespace ospcommon {
     int  OSPCOMMON_INTERFACE numTaskingThreads();
     void OSPCOMMON_INTERFACE deAffinitizeCores();
 
+    /*! pin the tasking threads (including the calling thread) to
+        individual logical cpus, filling up one NUMA node after the other */
+    void OSPCOMMON_INTERFACE pinTaskingThreads();
+
   } // ::ospcommon::tasking
 } // ::ospcommon
@@ -0,0 +1,256 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "Trace.h"
+// stl
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace ospcommon {
+  namespace trace {
+
+    std::atomic<bool> detail::enabled {false};
+
+    /*! ring buffer of one thread; only the owning thread writes 'events'
+        and 'count', readers only look at events older than 'count' */
+    struct ThreadBuffer
+    {
+      ThreadBuffer(size_t capacity, int threadID)
+        : events(new Event[capacity]), capacity(capacity), threadID(threadID)
+      {}
+
+      std::unique_ptr<Event[]> events;
+      const size_t capacity;
+      const int threadID;
+
+      //! total number of events ever recorded into this buffer
+      std::atomic<uint64_t> count {0};
+      //! events before this index were dropped by clear()
+      std::atomic<uint64_t> firstValid {0};
+    };
+
+    /*! all thread buffers ever created; buffers outlive their threads,
+        so that events of finished threads can still be written */
+    struct Registry
+    {
+      std::mutex mutex;
+      std::vector<ThreadBuffer*> buffers;
+      size_t bufferSize {1 << 16};
+
+      int processID {0};
+      std::string processName {"ospray"};
+      bool processSet {false};
+
+      std::string exitFileName;
+    };
+
+    // NOTE: intentionally leaked, threads may still record while static
+    //       objects get destroyed at exit
+    static Registry &registry()
+    {
+      static Registry *r = new Registry;
+      return *r;
+    }
+
+    static const auto epoch = std::chrono::steady_clock::now();
+
+    static thread_local ThreadBuffer *threadBuffer = nullptr;
+
+    static ThreadBuffer *createThreadBuffer()
+    {
+      auto &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      auto *buffer = new ThreadBuffer(r.bufferSize, (int)r.buffers.size());
+      r.buffers.push_back(buffer);
+      return buffer;
+    }
+
+    void setEnabled(bool enabled)
+    {
+      detail::enabled = enabled;
+    }
+
+    void setBufferSize(size_t numEvents)
+    {
+      auto &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      r.bufferSize = std::max(size_t(1), numEvents);
+    }
+
+    void setProcess(int id, const std::string &name)
+    {
+      auto &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      r.processID   = id;
+      r.processName = name;
+      r.processSet  = true;
+    }
+
+    uint64_t now()
+    {
+      using namespace std::chrono;
+      return duration_cast<nanoseconds>(steady_clock::now() - epoch).count();
+    }
+
+    void record(const Event &event)
+    {
+      if (!threadBuffer)
+        threadBuffer = createThreadBuffer();
+
+      auto &b = *threadBuffer;
+      const uint64_t i = b.count.load(std::memory_order_relaxed);
+      b.events[i % b.capacity] = event;
+      b.count.store(i + 1, std::memory_order_release);
+    }
+
+    void clear()
+    {
+      auto &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      for (auto *b : r.buffers)
+        b->firstValid = b->count.load(std::memory_order_acquire);
+    }
+
+    /*! copy the still valid events of a buffer; events which the owning
+        thread may have overwritten while copying are dropped */
+    static std::vector<Event> snapshot(const ThreadBuffer &b)
+    {
+      auto oldest = [&](uint64_t count) {
+        return std::max(b.firstValid.load(),
+                        count > b.capacity ? count - b.capacity : 0);
+      };
+
+      const uint64_t end   = b.count.load(std::memory_order_acquire);
+      const uint64_t begin = oldest(end);
+
+      std::vector<Event> events;
+      events.reserve(end - begin);
+      for (uint64_t i = begin; i < end; i++)
+        events.push_back(b.events[i % b.capacity]);
+
+      const uint64_t stillValid = oldest(b.count.load(std::memory_order_acquire));
+      if (stillValid > begin) {
+        const size_t numLost = std::min(size_t(stillValid - begin),
+                                        events.size());
+        events.erase(events.begin(), events.begin() + numLost);
+      }
+
+      return events;
+    }
+
+    static void writeEscaped(FILE *file, const char *str)
+    {
+      fputc('"', file);
+      for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+          fputc('\\', file);
+        fputc(*str, file);
+      }
+      fputc('"', file);
+    }
+
+    void writeChromeTrace(const std::string &fileName)
+    {
+      auto &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+
+      FILE *file = fopen(fileName.c_str(), "w");
+      if (!file)
+        throw std::runtime_error("could not open trace file '" + fileName + "'");
+
+      const int pid = r.processID;
+
+      fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+      fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                    "\"tid\":0,\"args\":{\"name\":", pid);
+      writeEscaped(file, r.processName.c_str());
+      fprintf(file, "}}");
+
+      for (const auto *b : r.buffers) {
+        const int tid = b->threadID;
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                      "\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                pid, tid, tid);
+
+        for (const auto &e : snapshot(*b)) {
+          fprintf(file, ",\n{\"name\":");
+          writeEscaped(file, e.name);
+          if (e.end == e.begin) {
+            fprintf(file, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f",
+                    e.begin * 1e-3);
+          } else {
+            fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                    e.begin * 1e-3, (e.end - e.begin) * 1e-3);
+          }
+          fprintf(file, ",\"pid\":%d,\"tid\":%d", pid, tid);
+          if (e.argName) {
+            fprintf(file, ",\"args\":{");
+            writeEscaped(file, e.argName);
+            fprintf(file, ":%lld}", (long long)e.arg);
+          }
+          fputc('}', file);
+        }
+      }
+
+      fprintf(file, "\n]}\n");
+      fclose(file);
+    }
+
+    static void writeExitTrace()
+    {
+      auto &r = registry();
+      std::string fileName;
+      {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        fileName = r.exitFileName;
+        if (r.processSet) {
+          const size_t slash = fileName.find_last_of("/\\");
+          size_t dot = fileName.find_last_of('.');
+          if (dot == std::string::npos ||
+              (slash != std::string::npos && dot < slash)) {
+            dot = fileName.size();
+          }
+          fileName.insert(dot, "." + std::to_string(r.processID));
+        }
+      }
+
+      try {
+        writeChromeTrace(fileName);
+      } catch (const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+      }
+    }
+
+    void writeChromeTraceAtExit(const std::string &fileName)
+    {
+      auto &r = registry();
+      {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.exitFileName = fileName;
+      }
+
+      static std::once_flag registered;
+      std::call_once(registered, [](){ std::atexit(writeExitTrace); });
+    }
+
+  } // ::ospcommon::trace
+} // ::ospcommon
@@ -0,0 +1,160 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "../common.h"
+// stl
+#include <atomic>
+#include <string>
+
+/*! \file Trace.h lightweight scoped trace markers for hot code paths.
+
+    Markers are only compiled in if OSPRAY_ENABLE_TRACING is defined
+    (CMake option of the same name), otherwise the OSPRAY_TRACE_* macros
+    expand to nothing. When compiled in, recording additionally has to
+    be switched on at runtime with trace::setEnabled(true) (see the
+    'traceFile' device parameter); a disabled marker costs one relaxed
+    atomic load.
+
+    Each thread records into its own fixed size ring buffer, which only
+    that thread ever writes to, so recording takes no locks; once a
+    buffer is full the oldest events get overwritten. The recorded
+    events can be written as Chrome trace JSON, which can be loaded into
+    chrome://tracing or https://ui.perfetto.dev.
+
+    Event and argument names must be string literals (or otherwise
+    outlive the trace), only the pointer is stored.
+*/
+
+namespace ospcommon {
+  namespace trace {
+
+    /*! one recorded "complete" event (or an instant event if begin==end) */
+    struct Event
+    {
+      const char *name    {nullptr};
+      const char *argName {nullptr}; //!< nullptr if the event has no arg
+      int64_t     arg     {0};
+      uint64_t    begin   {0};       //!< ns since the trace epoch
+      uint64_t    end     {0};
+    };
+
+    /*! switch recording on/off; does not clear already recorded events */
+    OSPCOMMON_INTERFACE void setEnabled(bool enabled);
+
+    /*! set the number of events each thread's ring buffer can hold;
+        only affects threads which did not record anything yet */
+    OSPCOMMON_INTERFACE void setBufferSize(size_t numEvents);
+
+    /*! identify this process in the written traces (e.g. the MPI rank) */
+    OSPCOMMON_INTERFACE void setProcess(int id, const std::string &name);
+
+    /*! ns since the trace epoch (when ospcommon was loaded) */
+    OSPCOMMON_INTERFACE uint64_t now();
+
+    /*! append an event to the calling thread's ring buffer */
+    OSPCOMMON_INTERFACE void record(const Event &event);
+
+    /*! drop all recorded events */
+    OSPCOMMON_INTERFACE void clear();
+
+    /*! write all recorded events as Chrome trace JSON; should be called
+        while no frame is being rendered, events recorded concurrently
+        may or may not be included */
+    OSPCOMMON_INTERFACE void writeChromeTrace(const std::string &fileName);
+
+    /*! write the trace to the given file when the process exits; if
+        setProcess() was called the process ID is inserted before the
+        file extension (i.e. "trace.json" becomes "trace.3.json") */
+    OSPCOMMON_INTERFACE void writeChromeTraceAtExit(const std::string &fileName);
+
+    namespace detail {
+      OSPCOMMON_INTERFACE extern std::atomic<bool> enabled;
+    } // ::ospcommon::trace::detail
+
+    inline bool isEnabled()
+    {
+      return detail::enabled.load(std::memory_order_relaxed);
+    }
+
+    /*! records the lifetime of the object as one event */
+    struct ScopedEvent
+    {
+      ScopedEvent(const char *name)
+      {
+        if (isEnabled()) {
+          event.name  = name;
+          event.begin = now();
+        }
+      }
+
+      ScopedEvent(const char *name, const char *argName, int64_t arg)
+      {
+        if (isEnabled()) {
+          event.name    = name;
+          event.argName = argName;
+          event.arg     = arg;
+          event.begin   = now();
+        }
+      }
+
+      ~ScopedEvent()
+      {
+        if (event.name) {
+          event.end = now();
+          record(event);
+        }
+      }
+
+    private:
+
+      Event event;
+    };
+
+    inline void instant(const char *name)
+    {
+      if (isEnabled()) {
+        Event event;
+        event.name  = name;
+        event.begin = event.end = now();
+        record(event);
+      }
+    }
+
+  } // ::ospcommon::trace
+} // ::ospcommon
+
+#define OSPRAY_TRACE_CONCAT_IMPL(a, b) a##b
+#define OSPRAY_TRACE_CONCAT(a, b) OSPRAY_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef OSPRAY_ENABLE_TRACING
+/*! record the rest of the enclosing scope as event 'name' */
+# define OSPRAY_TRACE_SCOPE(name)                                           \
+  ospcommon::trace::ScopedEvent OSPRAY_TRACE_CONCAT(ospTraceEvent_,         \
+                                                    __LINE__)(name)
+/*! like OSPRAY_TRACE_SCOPE, with one integer argument (e.g. a size) */
+# define OSPRAY_TRACE_SCOPE_ARG(name, argName, arg)                         \
+  ospcommon::trace::ScopedEvent OSPRAY_TRACE_CONCAT(ospTraceEvent_,         \
+                                                    __LINE__)(name, argName,\
+                                                              int64_t(arg))
+/*! record a point in time */
+# define OSPRAY_TRACE_INSTANT(name) ospcommon::trace::instant(name)
+#else
+# define OSPRAY_TRACE_SCOPE(name)
+# define OSPRAY_TRACE_SCOPE_ARG(name, argName, arg)
+# define OSPRAY_TRACE_INSTANT(name)
+#endif
@@ -0,0 +1,91 @@
+#define CATCH_CONFIG_MAIN
+#include "../../testing/catch.hpp"
+
+#include "../Trace.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace ospcommon;
+
+static std::string writeAndRead()
+{
+  const std::string fileName = "test_Trace.json";
+  trace::writeChromeTrace(fileName);
+  std::ifstream in(fileName);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+static size_t countOf(const std::string &str, const std::string &what)
+{
+  size_t count = 0;
+  for (size_t i = str.find(what); i != std::string::npos;
+       i = str.find(what, i + 1)) {
+    count++;
+  }
+  return count;
+}
+
+TEST_CASE("nothing is recorded while disabled", "[]")
+{
+  trace::setEnabled(false);
+  {
+    trace::ScopedEvent event("disabledEvent");
+  }
+  trace::instant("disabledInstant");
+
+  REQUIRE(countOf(writeAndRead(), "disabledEvent") == 0);
+  REQUIRE(countOf(writeAndRead(), "disabledInstant") == 0);
+}
+
+TEST_CASE("scoped and instant events of all threads are written", "[]")
+{
+  trace::setEnabled(true);
+  trace::clear();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([](){
+      for (int i = 0; i < 100; i++) {
+        trace::ScopedEvent event("scopedEvent", "index", i);
+      }
+      trace::instant("instantEvent");
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  const std::string json = writeAndRead();
+  REQUIRE(countOf(json, "\"scopedEvent\"") == 400);
+  REQUIRE(countOf(json, "\"instantEvent\"") == 4);
+  REQUIRE(countOf(json, "\"index\":99") == 4);
+
+  trace::clear();
+  REQUIRE(countOf(writeAndRead(), "\"scopedEvent\"") == 0);
+  trace::setEnabled(false);
+}
+
+TEST_CASE("full ring buffers keep the newest events", "[]")
+{
+  trace::setEnabled(true);
+  trace::setBufferSize(16);
+
+  // a new thread gets a buffer of the new size
+  std::thread([](){
+    for (int i = 0; i < 100; i++)
+      trace::ScopedEvent event("ringEvent", "index", i);
+  }).join();
+
+  const std::string json = writeAndRead();
+  REQUIRE(countOf(json, "\"ringEvent\"") == 16);
+  REQUIRE(countOf(json, "\"index\":83}") == 0);
+  REQUIRE(countOf(json, "\"index\":84}") == 1);
+  REQUIRE(countOf(json, "\"index\":99}") == 1);
+
+  trace::setBufferSize(1 << 16);
+  trace::setEnabled(false);
+}
@@ -0,0 +1,86 @@
+#define CATCH_CONFIG_MAIN
+#include "../../testing/catch.hpp"
+
+#include "../../malloc.h"
+#include "../../tasking/parallel_for.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace ospcommon;
+
+static bool isAligned(void *ptr, size_t align)
+{
+  return (size_t(ptr) & (align - 1)) == 0;
+}
+
+TEST_CASE("alignedMalloc returns aligned, usable memory of all sizes")
+{
+  for (size_t size : {size_t(1), size_t(100), size_t(4096), size_t(300000),
+                      size_t(2*1024*1024), size_t(9*1024*1024)}) {
+    for (size_t align : {size_t(16), size_t(64), size_t(4096)}) {
+      char *ptr = (char*)alignedMalloc(size, align);
+      REQUIRE(ptr != nullptr);
+      REQUIRE(isAligned(ptr, align));
+      std::memset(ptr, 0xab, size);
+      alignedFree(ptr);
+    }
+  }
+
+  alignedFree(nullptr);
+}
+
+TEST_CASE("small allocations get recycled through the pools")
+{
+  AllocatorConfig config = allocatorConfig();
+  config.usePools = true;
+  setAllocatorConfig(config);
+
+  void *first = alignedMalloc(1000);
+  alignedFree(first);
+
+  const size_t hits = allocationStats().numPoolHits;
+  void *second = alignedMalloc(1000);
+  REQUIRE(second == first);
+  REQUIRE(allocationStats().numPoolHits == hits + 1);
+  alignedFree(second);
+}
+
+TEST_CASE("allocation statistics track bytes in use")
+{
+  const AllocationStats before = allocationStats();
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 100; i++)
+    ptrs.push_back(alignedMalloc(1024));
+
+  const AllocationStats during = allocationStats();
+  REQUIRE(during.bytesInUse == before.bytesInUse + 100 * 1024);
+  REQUIRE(during.numAllocations == before.numAllocations + 100);
+  REQUIRE(during.peakBytesInUse >= during.bytesInUse);
+
+  for (auto *ptr : ptrs)
+    alignedFree(ptr);
+
+  const AllocationStats after = allocationStats();
+  REQUIRE(after.bytesInUse == before.bytesInUse);
+  REQUIRE(after.numFrees == before.numFrees + 100);
+}
+
+TEST_CASE("memory can be freed on a different thread than allocated")
+{
+  const int N = 10000;
+  std::vector<void*> ptrs(N);
+  const size_t bytesInUse = allocationStats().bytesInUse;
+
+  tasking::parallel_for(N, [&](int i) {
+    ptrs[i] = alignedMalloc(64 + (i % 16) * 1000);
+    std::memset(ptrs[i], i & 0xff, 64);
+  });
+
+  tasking::parallel_for(N, [&](int i) {
+    alignedFree(ptrs[N - 1 - i]);
+  });
+
+  REQUIRE(allocationStats().bytesInUse == bytesInUse);
+}
@@ -19,6 +19,7 @@
 //ospray
 #include "ospray/camera/Camera.h"
 #include "ospray/common/Data.h"
+#include "ospray/common/FrameStats.h"
 #include "ospray/lights/Light.h"
 #include "ospray/transferFunction/TransferFunction.h"
 //mpiCommon
@@ -158,7 +159,8 @@ namespace ospray {
                                                   hasDepthBuffer,
                                                   hasAccumBuffer,
                                                   hasVarianceBuffer,
-                                                  true);
+                                                  true,
+                                                  tileSize);
       instance->refInc();
 
       handle.assign(instance);
@@ -211,7 +213,9 @@ namespace ospray {
     void MPIDistributedDevice::commit(OSPObject _object)
     {
       auto *object = lookupObject<ManagedObject>(_object);
+      const double start = getSysTime();
       object->commit();
+      addCommitTime(getSysTime() - start);
     }
 
     void MPIDistributedDevice::addGeometry(OSPModel _model,
@@ -239,6 +243,17 @@ namespace ospray {
       return (OSPData)instance;
     }
 
+    OSPData MPIDistributedDevice::newSharedData(size_t nitems,
+                                                OSPDataType format,
+                                                void *init,
+                                                OSPDataDeleter deleter,
+                                                void *userData)
+    {
+      auto *instance = new Data(nitems, format, init, deleter, userData);
+      instance->refInc();
+      return (OSPData)instance;
+    }
+
     void MPIDistributedDevice::setVoidPtr(OSPObject _object,
                                           const char *bufName,
                                           void *v)
@@ -433,11 +448,23 @@ namespace ospray {
       return result;
     }
 
+    OSPFrameStats MPIDistributedDevice::frameBufferGetStats(OSPFrameBuffer _fb)
+    {
+      auto &fb = lookupDistributedObject<FrameBuffer>(_fb);
+      return fb.frameStats;
+    }
+
     void MPIDistributedDevice::release(OSPObject _obj)
     {
       if (!_obj) return;
-      auto *obj = lookupObject<ManagedObject>(_obj);
-      obj->refDec();
+      auto &handle = reinterpret_cast<ObjectHandle&>(_obj);
+      if (handle.defined()) {
+        // drop the application's reference, then the handle's
+        handle.lookup()->refDec();
+        handle.freeObject();
+      } else {
+        ((ManagedObject*)_obj)->refDec();
+      }
     }
 
     void MPIDistributedDevice::setMaterial(OSPGeometry _geometry,
@@ -101,6 +101,11 @@ namespace ospray {
       OSPData newData(size_t nitems, OSPDataType format,
                       void *init, int flags) override;
 
+      /*! create a new data buffer sharing the app's memory */
+      OSPData newSharedData(size_t nitems, OSPDataType format,
+                            void *init, OSPDataDeleter deleter,
+                            void *userData) override;
+
       /*! Copy data into the given volume. */
       int setRegion(OSPVolume object, const void *source,
                     const vec3i &index, const vec3i &count) override;
@@ -174,6 +179,8 @@ namespace ospray {
                         OSPRenderer _renderer,
                         const uint32 fbChannelFlags) override;
 
+      OSPFrameStats frameBufferGetStats(OSPFrameBuffer _fb) override;
+
       /*! load module */
       int loadModule(const char *name) override;
 
@@ -469,7 +469,7 @@ namespace ospray {
                                         const uint32 channels)
     {
       ObjectHandle handle = allocateHandle();
-      work::CreateFrameBuffer work(handle, size, mode, channels);
+      work::CreateFrameBuffer work(handle, size, mode, channels, tileSize);
       processWork(work);
       return (OSPFrameBuffer)(int64)handle;
     }
@@ -513,7 +513,9 @@ namespace ospray {
     {
       const ObjectHandle handle = (const ObjectHandle&)_object;
       work::CommitObject work(handle);
-      processWork(work, true);
+      // commits get the workers going right away, unless we're
+      // recording a command buffer (nobody waits for their result)
+      processWork(work, commandBuffer == nullptr);
     }
 
     /*! add a new geometry to a model */
@@ -542,6 +544,26 @@ namespace ospray {
       return (OSPData)(int64)handle;
     }
 
+    /*! create a new data buffer sharing the app's memory */
+    OSPData MPIOffloadDevice::newSharedData(size_t nitems, OSPDataType format,
+                                            void *init, OSPDataDeleter deleter,
+                                            void *userData)
+    {
+      ObjectHandle handle = allocateHandle();
+
+      // the data is streamed straight out of the app's memory while the
+      // work item gets serialized, so once processWork() returns the
+      // master no longer references it
+      work::NewData work(handle, nitems, format, init,
+                         OSP_DATA_SHARED_BUFFER);
+      processWork(work);
+
+      if (deleter)
+        deleter(userData, init);
+
+      return (OSPData)(int64)handle;
+    }
+
     /*! assign (named) string parameter to an object */
     void MPIOffloadDevice::setVoidPtr(OSPObject _object,
                                       const char *bufName,
@@ -844,8 +866,44 @@ namespace ospray {
       return work.pickResult;
     }
 
+    void MPIOffloadDevice::beginCommandBuffer()
+    {
+      if (!commandBuffer)
+        commandBuffer = make_unique<work::CommandBuffer>();
+    }
+
+    void MPIOffloadDevice::endCommandBuffer()
+    {
+      submitCommandBuffer(true);
+      commandBuffer.reset();
+    }
+
+    void MPIOffloadDevice::submitCommandBuffer(bool flushWriteStream)
+    {
+      if (!commandBuffer || commandBuffer->empty())
+        return;
+
+      // take the buffer out while sending so processWork() doesn't
+      // try to record it into itself
+      auto recorded = std::move(commandBuffer);
+      processWork(*recorded, flushWriteStream);
+      recorded->clear();
+      commandBuffer = std::move(recorded);
+    }
+
     void MPIOffloadDevice::processWork(work::Work &work, bool flushWriteStream)
     {
+      if (commandBuffer) {
+        // calls that have to sync with the workers (or carry bulk data)
+        // go out directly, after everything recorded before them
+        if (!flushWriteStream && work.recordable()) {
+          commandBuffer->record(work);
+          work.runOnMaster();
+          return;
+        }
+        submitCommandBuffer();
+      }
+
       static size_t numWorkSent = 0;
       postStatusMsg(OSPRAY_MPI_VERBOSE_LEVEL)
           << "#osp.mpi.master: processing/sending work item "
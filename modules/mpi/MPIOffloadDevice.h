@@ -106,6 +106,11 @@ namespace ospray {
       OSPData newData(size_t nitems, OSPDataType format,
                       void *init, int flags) override;
 
+      /*! create a new data buffer sharing the app's memory */
+      OSPData newSharedData(size_t nitems, OSPDataType format,
+                            void *init, OSPDataDeleter deleter,
+                            void *userData) override;
+
       /*! Copy data into the given volume. */
       int setRegion(OSPVolume object, const void *source,
                     const vec3i &index, const vec3i &count) override;
@@ -204,12 +209,21 @@ namespace ospray {
       OSPPickResult pick(OSPRenderer renderer,
                          const vec2f &screenPos) override;
 
+      /*! record subsequent API calls into a command buffer */
+      void beginCommandBuffer() override;
+
+      /*! stop recording and send the command buffer to the workers */
+      void endCommandBuffer() override;
+
     private:
 
       void initializeDevice();
 
       void processWork(work::Work &work, bool flushWriteStream = false);
 
+      /*! send what has been recorded so far (if anything) */
+      void submitCommandBuffer(bool flushWriteStream = false);
+
       /*! This only exists to support getting the voxel type for setRegion */
       int getString(OSPObject object, const char *name, char **value);
 
@@ -223,6 +237,9 @@ namespace ospray {
 
       work::WorkTypeRegistry workRegistry;
 
+      /*! work items recorded between begin/endCommandBuffer() */
+      std::unique_ptr<work::CommandBuffer> commandBuffer;
+
       bool initialized {false};
     };
 
@@ -22,6 +22,7 @@
 #include "mpiCommon/MPICommon.h"
 #include "Messaging.h"
 #include "common/Data.h"
+#include "volume/structured/StructuredVolume.h"
 // ispc exports
 #include "DistributedModel_ispc.h"
 
@@ -33,6 +34,144 @@ namespace ospray {
       return api::Device::current->embreeDevice;
     }
 
+    namespace {
+
+      /*! what every rank needs to know about the other ranks' structured
+          volumes to work out the ghost voxel exchange */
+      struct StructuredVolumeInfo
+      {
+        vec3f gridOrigin;
+        vec3f gridSpacing;
+        vec3i dimensions;
+        int rank;
+        int index;
+      };
+
+      /*! inclusive box of voxel indices */
+      using VoxelBox = box_t<int, 3>;
+
+      inline size_t numVoxels(const VoxelBox &b)
+      {
+        return size_t(b.upper.x - b.lower.x + 1)
+          * size_t(b.upper.y - b.lower.y + 1)
+          * size_t(b.upper.z - b.lower.z + 1);
+      }
+
+      /*! voxel box of 'other' in the index space of 'vol', returns false
+          if the two don't share the same grid */
+      bool voxelBoxIn(const StructuredVolumeInfo &vol,
+                      const StructuredVolumeInfo &other,
+                      VoxelBox &box)
+      {
+        const vec3f rel = (other.gridOrigin - vol.gridOrigin)
+          / vol.gridSpacing;
+        const vec3i offset(std::lround(rel.x), std::lround(rel.y),
+                           std::lround(rel.z));
+        for (int i = 0; i < 3; ++i) {
+          if (std::abs(other.gridSpacing[i] - vol.gridSpacing[i])
+              > 1e-5f * vol.gridSpacing[i]
+              || std::abs(rel[i] - offset[i]) > 1e-3f) {
+            return false;
+          }
+        }
+        box = VoxelBox(offset, offset + other.dimensions - vec3i(1));
+        return true;
+      }
+
+      /*! along which axes a volume on the same grid abuts 'vol' on its
+          upper face leaving a one cell gap */
+      vec3i seamAxes(const StructuredVolumeInfo &vol,
+                     const std::vector<StructuredVolumeInfo> &all)
+      {
+        const vec3i hi = vol.dimensions - vec3i(1);
+        vec3i gap(0);
+
+        for (const auto &other : all) {
+          VoxelBox box;
+          if ((other.rank == vol.rank && other.index == vol.index)
+              || !voxelBoxIn(vol, other, box)) {
+            continue;
+          }
+          for (int a = 0; a < 3; ++a) {
+            const int b = (a + 1) % 3;
+            const int c = (a + 2) % 3;
+            if (box.lower[a] == vol.dimensions[a]
+                && box.lower[b] <= hi[b] && box.upper[b] >= 0
+                && box.lower[c] <= hi[c] && box.upper[c] >= 0) {
+              gap[a] = 1;
+            }
+          }
+        }
+        return gap;
+      }
+
+      /*! the seam boxes (in 'vol's voxel index space) covering the gap
+          cells along 'gap'. The x seam includes the xy, xz and xyz edges
+          and corner, the y seam the yz edge, so seams never overlap. */
+      std::vector<VoxelBox> seamBoxes(const StructuredVolumeInfo &vol,
+                                      const vec3i &gap)
+      {
+        const vec3i hi = vol.dimensions - vec3i(1);
+        std::vector<VoxelBox> seams;
+        if (gap.x) {
+          seams.emplace_back(vec3i(hi.x, 0, 0),
+                             vec3i(hi.x + 1, hi.y + gap.y, hi.z + gap.z));
+        }
+        if (gap.y) {
+          seams.emplace_back(vec3i(0, hi.y, 0),
+                             vec3i(hi.x, hi.y + 1, hi.z + gap.z));
+        }
+        if (gap.z) {
+          seams.emplace_back(vec3i(0, 0, hi.z),
+                             vec3i(hi.x, hi.y, hi.z + 1));
+        }
+        return seams;
+      }
+
+      /*! sample 'volume' at the voxels of 'box' ('vol' index space) */
+      void sampleVoxels(Volume *volume,
+                        const StructuredVolumeInfo &vol,
+                        const VoxelBox &box,
+                        std::vector<float> &out)
+      {
+        std::vector<vec3f> coords;
+        coords.reserve(numVoxels(box));
+        for (int z = box.lower.z; z <= box.upper.z; ++z) {
+          for (int y = box.lower.y; y <= box.upper.y; ++y) {
+            for (int x = box.lower.x; x <= box.upper.x; ++x) {
+              coords.push_back(vol.gridOrigin
+                               + vec3f(x, y, z) * vol.gridSpacing);
+            }
+          }
+        }
+        float *samples = nullptr;
+        volume->computeSamples(&samples, coords.data(), coords.size());
+        out.insert(out.end(), samples, samples + coords.size());
+        free(samples);
+      }
+
+      /*! write the voxels of 'piece' into the seam 'seam' */
+      void scatterVoxels(const VoxelBox &seam,
+                         const VoxelBox &piece,
+                         const float *values,
+                         std::vector<float> &seamVoxels)
+      {
+        const vec3i dims = seam.upper - seam.lower + vec3i(1);
+        for (int z = piece.lower.z; z <= piece.upper.z; ++z) {
+          for (int y = piece.lower.y; y <= piece.upper.y; ++y) {
+            for (int x = piece.lower.x; x <= piece.upper.x; ++x) {
+              const vec3i p = vec3i(x, y, z) - seam.lower;
+              seamVoxels[p.x + size_t(dims.x) * (p.y + size_t(dims.y) * p.z)]
+                = *values++;
+            }
+          }
+        }
+      }
+
+      const int GHOST_VOXEL_TAG = 0x6f5;
+
+    } // ::ospray::mpi::<anonymous>
+
     DistributedModel::DistributedModel()
     {
       managedObjectType = OSP_MODEL;
@@ -47,12 +186,15 @@ namespace ospray {
     void DistributedModel::commit()
     {
       othersRegions.clear();
+      myRegions.clear();
+
+      // Drop the seams of the last commit, they're rebuilt below
+      for (const auto &seam : ghostSeams) {
+        volume.erase(std::remove(volume.begin(), volume.end(), seam->volume),
+                     volume.end());
+      }
+      ghostSeams.clear();
 
-      // TODO: We may need to override the ISPC calls made
-      // to the Model or customize the model struct on the ISPC
-      // side. In which case we need some ISPC side inheritence
-      // for the model type. Currently the code is actually identical.
-      Model::commit();
       // Send my bounding boxes to other nodes, recieve theirs for a
       // "full picture" of what geometries live on what nodes
       Data *regionData = getParamData("regions");
@@ -77,6 +219,14 @@ namespace ospray {
         myRegions.push_back(box3f(vec3f(neg_inf), vec3f(pos_inf)));
       }
 
+      exchangeGhostVoxels();
+
+      // TODO: We may need to override the ISPC calls made
+      // to the Model or customize the model struct on the ISPC
+      // side. In which case we need some ISPC side inheritence
+      // for the model type. Currently the code is actually identical.
+      Model::commit();
+
       for (size_t i = 0; i < mpicommon::numGlobalRanks(); ++i) {
         if (i == mpicommon::globalRank()) {
           messaging::bcast(i, myRegions);
@@ -102,5 +252,165 @@ namespace ospray {
       }
     }
 
+    void DistributedModel::exchangeGhostVoxels()
+    {
+      using namespace mpicommon;
+
+      // Share the layout of all structured volumes with everyone
+      std::vector<StructuredVolumeInfo> myVolumes;
+      for (size_t i = 0; i < volume.size(); ++i) {
+        if (!dynamic_cast<StructuredVolume*>(volume[i].ptr))
+          continue;
+        StructuredVolumeInfo info;
+        info.gridOrigin  = volume[i]->getParam3f("gridOrigin", vec3f(0.f));
+        info.gridSpacing = volume[i]->getParam3f("gridSpacing", vec3f(1.f));
+        info.dimensions  = volume[i]->getParam3i("dimensions", vec3i(0));
+        info.rank        = globalRank();
+        info.index       = i;
+        myVolumes.push_back(info);
+      }
+
+      std::vector<StructuredVolumeInfo> allVolumes;
+      for (int i = 0; i < numGlobalRanks(); ++i) {
+        if (i == globalRank()) {
+          messaging::bcast(i, myVolumes);
+          allVolumes.insert(allVolumes.end(),
+                            myVolumes.begin(), myVolumes.end());
+        } else {
+          std::vector<StructuredVolumeInfo> recv;
+          messaging::bcast(i, recv);
+          allVolumes.insert(allVolumes.end(), recv.begin(), recv.end());
+        }
+      }
+
+      // Every rank computes the seams of every volume, so both sides of
+      // each exchange agree on what's sent, in which order, without any
+      // further handshake. The pieces for rank r are appended to one
+      // buffer in (seam volume, seam, source volume) order.
+      std::vector<std::vector<float>> sendBuffers(numGlobalRanks());
+      std::vector<size_t> recvCounts(numGlobalRanks(), 0);
+      std::vector<vec3i> gaps(allVolumes.size());
+      std::vector<std::vector<VoxelBox>> seams(allVolumes.size());
+
+      for (size_t v = 0; v < allVolumes.size(); ++v) {
+        const auto &vol = allVolumes[v];
+        gaps[v] = seamAxes(vol, allVolumes);
+        seams[v] = seamBoxes(vol, gaps[v]);
+        for (const auto &seam : seams[v]) {
+          for (const auto &src : allVolumes) {
+            VoxelBox box;
+            if (src.rank == vol.rank || !voxelBoxIn(vol, src, box))
+              continue;
+            const VoxelBox piece = intersectionOf(seam, box);
+            if (piece.empty())
+              continue;
+            if (src.rank == globalRank()) {
+              sampleVoxels(volume[src.index].ptr, vol, piece,
+                           sendBuffers[vol.rank]);
+            } else if (vol.rank == globalRank()) {
+              recvCounts[src.rank] += numVoxels(piece);
+            }
+          }
+        }
+      }
+
+      const bool asyncWasRunning = messaging::asyncMessagingEnabled();
+      messaging::disableAsyncMessaging();
+
+      std::vector<std::vector<float>> recvBuffers(numGlobalRanks());
+      std::vector<MPI_Request> requests;
+      for (int r = 0; r < numGlobalRanks(); ++r) {
+        if (recvCounts[r] > 0) {
+          recvBuffers[r].resize(recvCounts[r]);
+          requests.push_back(MPI_REQUEST_NULL);
+          MPI_CALL(Irecv(recvBuffers[r].data(), recvCounts[r], MPI_FLOAT, r,
+                         GHOST_VOXEL_TAG, world.comm, &requests.back()));
+        }
+        if (!sendBuffers[r].empty()) {
+          requests.push_back(MPI_REQUEST_NULL);
+          MPI_CALL(Isend(sendBuffers[r].data(), sendBuffers[r].size(),
+                         MPI_FLOAT, r, GHOST_VOXEL_TAG, world.comm,
+                         &requests.back()));
+        }
+      }
+      MPI_CALL(Waitall(requests.size(), requests.data(),
+                       MPI_STATUSES_IGNORE));
+
+      if (asyncWasRunning)
+        messaging::enableAsyncMessaging();
+
+      // Assemble our seams from the received and our own voxels
+      std::vector<size_t> recvOffsets(numGlobalRanks(), 0);
+      for (size_t v = 0; v < allVolumes.size(); ++v) {
+        const auto &vol = allVolumes[v];
+        if (vol.rank != globalRank() || seams[v].empty())
+          continue;
+
+        Volume *source = volume[vol.index].ptr;
+        for (const auto &seam : seams[v]) {
+          std::unique_ptr<GhostSeam> ghost(new GhostSeam);
+          ghost->voxels.resize(numVoxels(seam), 0.f);
+
+          for (const auto &src : allVolumes) {
+            VoxelBox box;
+            if (!voxelBoxIn(vol, src, box))
+              continue;
+            const VoxelBox piece = intersectionOf(seam, box);
+            if (piece.empty())
+              continue;
+            if (src.rank == globalRank()) {
+              std::vector<float> values;
+              sampleVoxels(volume[src.index].ptr, vol, piece, values);
+              scatterVoxels(seam, piece, values.data(), ghost->voxels);
+            } else {
+              scatterVoxels(seam, piece,
+                            recvBuffers[src.rank].data()
+                            + recvOffsets[src.rank],
+                            ghost->voxels);
+              recvOffsets[src.rank] += numVoxels(piece);
+            }
+          }
+
+          const vec3i dims = seam.upper - seam.lower + vec3i(1);
+          Ref<Data> voxelData = new Data(ghost->voxels.size(), OSP_FLOAT,
+                                         ghost->voxels.data(),
+                                         OSP_DATA_SHARED_BUFFER);
+          ghost->volume = Volume::createInstance("shared_structured_volume");
+          ghost->volume->set("voxelType", "float");
+          ghost->volume->set("voxelData", voxelData.ptr);
+          ghost->volume->set("dimensions", dims);
+          ghost->volume->set("gridOrigin", vol.gridOrigin
+                             + vec3f(seam.lower) * vol.gridSpacing);
+          ghost->volume->set("gridSpacing", vol.gridSpacing);
+          ghost->volume->set("transferFunction",
+                             source->getParamObject("transferFunction"));
+          ghost->volume->set("samplingRate",
+                             source->getParam1f("samplingRate", 0.125f));
+          ghost->volume->set("gradientShadingEnabled",
+                             source->getParam1i("gradientShadingEnabled", 0));
+          ghost->volume->commit();
+          volume.push_back(ghost->volume);
+          ghostSeams.push_back(std::move(ghost));
+        }
+
+        // Regions ending on the volume's upper faces grow to cover the seam
+        const vec3f upper = vol.gridOrigin
+          + vec3f(vol.dimensions - vec3i(1)) * vol.gridSpacing;
+        for (int a = 0; a < 3; ++a) {
+          if (!gaps[v][a])
+            continue;
+          for (auto &region : myRegions) {
+            if (std::abs(region.upper[a] - upper[a])
+                < 1e-3f * vol.gridSpacing[a]) {
+              region.upper[a] += vol.gridSpacing[a];
+            }
+          }
+        }
+
+        postStatusMsg(1) << "Rank " << globalRank() << ": added "
+          << seams[v].size() << " ghost seams to volume " << vol.index;
+      }
+    }
+
   } // ::ospray::mpi
 } // ::ospray
@@ -22,6 +22,7 @@
 #include "common/Model.h"
 
 // stl
+#include <memory>
 #include <vector>
 
 // embree
@@ -43,6 +44,26 @@ namespace ospray {
       virtual void commit() override;
 
       std::vector<box3f> myRegions, othersRegions;
+
+    private:
+
+      /*! Structured volumes of neighbouring ranks that sit on the same
+          grid but leave a one cell gap between them (i.e. were loaded
+          without ghost voxels) can't be interpolated across that gap by
+          either rank. For each such gap we fetch the neighbours' boundary
+          voxels and add a thin "seam" volume covering the gap cells to
+          this model, extending our regions to include it. Volumes that
+          already overlap (app-provided ghost voxels) are left alone. */
+      void exchangeGhostVoxels();
+
+      /*! a seam volume, and the voxels it shares with ospray */
+      struct GhostSeam
+      {
+        std::vector<float> voxels;
+        Ref<Volume> volume;
+      };
+
+      std::vector<std::unique_ptr<GhostSeam>> ghostSeams;
     };
 
   } // ::ospray::mpi
@@ -82,6 +82,128 @@ namespace ospray {
 
         registerWorkUnit<CommandFinalize>(registry);
         registerWorkUnit<Pick>(registry);
+
+        registerWorkUnit<CommandBuffer>(registry);
+      }
+
+      // data arrays up to this size get recorded into command buffers,
+      // larger ones are streamed directly from the user's memory
+      static const size_t maxRecordedDataBytes = 64*1024;
+
+      // CommandBuffer streams ////////////////////////////////////////////////
+
+      void CommandBufferWriteStream::write(void *mem, size_t size)
+      {
+        const byte_t *bytes = (const byte_t*)mem;
+        buffer.insert(buffer.end(), bytes, bytes + size);
+      }
+
+      void CommandBufferWriteStream::writeHandle(const ObjectHandle &handle)
+      {
+        // zig-zag encoded varint of the difference to the last handle;
+        // consecutive calls mostly talk about the same or a nearby object
+        const int64 delta = handle.i64 - lastHandle;
+        lastHandle = handle.i64;
+
+        uint64 zz = (uint64(delta) << 1) ^ uint64(delta >> 63);
+        while (zz >= 0x80) {
+          buffer.push_back(byte_t(zz | 0x80));
+          zz >>= 7;
+        }
+        buffer.push_back(byte_t(zz));
+      }
+
+      void CommandBufferReadStream::read(void *mem, size_t size)
+      {
+        if (readPos + size > buffer.size())
+          throw std::runtime_error("#osp.mpi: read past end of command buffer");
+
+        std::memcpy(mem, buffer.data() + readPos, size);
+        readPos += size;
+      }
+
+      void CommandBufferReadStream::readHandle(ObjectHandle &handle)
+      {
+        uint64 zz = 0;
+        for (int shift = 0; ; shift += 7) {
+          byte_t b;
+          read(&b, 1);
+          zz |= uint64(b & 0x7f) << shift;
+          if (!(b & 0x80))
+            break;
+        }
+
+        const int64 delta = int64(zz >> 1) ^ -int64(zz & 1);
+        lastHandle += delta;
+        handle.i64 = lastHandle;
+      }
+
+      // CommandBuffer ////////////////////////////////////////////////////////
+
+      /*! dense index of all registered work types; it is the same on
+        all processes, and much smaller than a type tag */
+      struct WorkTypeIndex
+      {
+        WorkTypeIndex()
+        {
+          WorkTypeRegistry registry;
+          registerOSPWorkItems(registry);
+          for (auto &entry : registry) {
+            indexOf[entry.first] = uint16(create.size());
+            create.push_back(entry.second);
+          }
+        }
+
+        std::map<Work::tag_t, uint16> indexOf;
+        std::vector<CreateWorkFct>    create;
+      };
+
+      static const WorkTypeIndex &workTypeIndex()
+      {
+        static WorkTypeIndex index;
+        return index;
+      }
+
+      void CommandBuffer::record(const Work &work)
+      {
+        if (!recordStream)
+          recordStream = make_unique<CommandBufferWriteStream>(commands);
+
+        const uint16 typeIndex = workTypeIndex().indexOf.at(typeIdOf(work));
+        *recordStream << typeIndex;
+        work.serialize(*recordStream);
+        numCommands++;
+      }
+
+      void CommandBuffer::clear()
+      {
+        numCommands = 0;
+        commands.clear();
+        recordStream.reset();
+      }
+
+      void CommandBuffer::run()
+      {
+        const auto &types = workTypeIndex();
+        CommandBufferReadStream stream(commands);
+
+        for (size_t i = 0; i < numCommands; ++i) {
+          uint16 typeIndex;
+          stream >> typeIndex;
+          auto work = types.create.at(typeIndex)();
+          work->deserialize(stream);
+          work->run();
+        }
+      }
+
+      void CommandBuffer::serialize(WriteStream &b) const
+      {
+        b << numCommands << commands;
+      }
+
+      void CommandBuffer::deserialize(ReadStream &b)
+      {
+        b >> numCommands >> commands;
       }
 
       // SetLoadBalancer //////////////////////////////////////////////////////
@@ -100,7 +222,8 @@ namespace ospray {
       {
         if (useDynamicLoadBalancer) {
           TiledLoadBalancer::instance =
-              make_unique<dynamicLoadBalancer::Slave>(handleID);
+              make_unique<dynamicLoadBalancer::Slave>(handleID,
+                                                      numTilesPreAllocated);
         } else {
           TiledLoadBalancer::instance =
               make_unique<staticLoadBalancer::Slave>();
@@ -111,8 +234,7 @@ namespace ospray {
       {
         if (useDynamicLoadBalancer) {
           TiledLoadBalancer::instance =
-              make_unique<dynamicLoadBalancer::Master>(handleID,
-                                                       numTilesPreAllocated);
+              make_unique<dynamicLoadBalancer::Master>(handleID);
         } else {
           TiledLoadBalancer::instance =
               make_unique<staticLoadBalancer::Master>();
@@ -159,12 +281,12 @@ namespace ospray {
 
       void CommitObject::serialize(WriteStream &b) const
       {
-        b << (int64)handle;
+        b << handle;
       }
 
       void CommitObject::deserialize(ReadStream &b)
       {
-        b >> handle.i64;
+        b >> handle;
       }
 
       // ospNewFrameBuffer ////////////////////////////////////////////////////
@@ -172,11 +294,13 @@ namespace ospray {
       CreateFrameBuffer::CreateFrameBuffer(ObjectHandle handle,
                                            vec2i dimensions,
                                            OSPFrameBufferFormat format,
-                                           uint32 channels)
+                                           uint32 channels,
+                                           vec2i tileSize)
         : handle(handle),
           dimensions(dimensions),
           format(format),
-          channels(channels)
+          channels(channels),
+          tileSize(tileSize)
       {
       }
 
@@ -192,7 +316,8 @@ namespace ospray {
         FrameBuffer *fb
           = new DistributedFrameBuffer(dimensions, handle,
                                        format, hasDepthBuffer,
-                                       hasAccumBuffer, hasVarianceBuffer);
+                                       hasAccumBuffer, hasVarianceBuffer,
+                                       false, tileSize);
         handle.assign(fb);
       }
 
@@ -203,13 +328,13 @@ namespace ospray {
 
       void CreateFrameBuffer::serialize(WriteStream &b) const
       {
-        b << (int64)handle << dimensions << (int32)format << channels;
+        b << handle << dimensions << (int32)format << channels << tileSize;
       }
 
       void CreateFrameBuffer::deserialize(ReadStream &b)
       {
         int32 fmt;
-        b >> handle.i64 >> dimensions >> fmt >> channels;
+        b >> handle >> dimensions >> fmt >> channels >> tileSize;
         format = (OSPFrameBufferFormat)fmt;
       }
 
@@ -340,17 +465,18 @@ namespace ospray {
           format(format),
           flags(flags)
       {
-        if (init && nItems) {
-          auto numBytes = sizeOf(format) * nItems;
+        // NOTE: work items get serialized synchronously in
+        //       MPIOffloadDevice::processWork(), i.e. before the
+        //       ospNewData() call returns, so the user's memory can be
+        //       streamed out directly without an intermediate copy,
+        //       regardless of OSP_DATA_SHARED_BUFFER
+        if (init && nItems)
+          dataView.reset((byte_t*)init, sizeOf(format) * nItems);
+      }
 
-          if (flags & OSP_DATA_SHARED_BUFFER) {
-            dataView.reset((byte_t*)init, numBytes);
-          } else {
-            copiedData.resize(numBytes);
-            std::memcpy(copiedData.data(), init, numBytes);
-            dataView = copiedData;
-          }
-        }
+      bool NewData::recordable() const
+      {
+        return dataView.size() <= maxRecordedDataBytes;
       }
 
       void NewData::run()
@@ -359,7 +485,16 @@ namespace ospray {
         // it), so let's assert that nobody accidentally uses it.
         assert(format != OSP_STRING);
 
-        Data *ospdata = new Data(nItems, format, dataView.data());
+        Data *ospdata = nullptr;
+        if (receivedData) {
+          // hand our buffer over to the data object instead of copying it
+          ospdata = new Data(nItems, format, receivedData.release(),
+                             [](void *, const void *mem) {
+                               alignedFree(const_cast<void*>(mem));
+                             });
+        } else {
+          ospdata = new Data(nItems, format, dataView.data());
+        }
         handle.assign(ospdata);
 
         if (format == OSP_OBJECT ||
@@ -393,15 +528,23 @@ namespace ospray {
 
       void NewData::serialize(WriteStream &b) const
       {
-        b << (int64)handle << nItems << (int32)format << flags << dataView;
+        b << handle << nItems << (int32)format << flags << dataView;
       }
 
       void NewData::deserialize(ReadStream &b)
       {
         int32 fmt;
-        b >> handle.i64 >> nItems >> fmt >> flags >> copiedData;
-        dataView = copiedData;
+        size_t numBytes;
+        b >> handle >> nItems >> fmt >> flags >> numBytes;
         format = (OSPDataType)fmt;
+
+        // read the payload straight into the buffer the final Data
+        // object will use (see run())
+        if (numBytes > 0) {
+          receivedData.reset((byte_t*)alignedMalloc(numBytes+16));
+          b.read(receivedData.get(), numBytes);
+          dataView.reset(receivedData.get(), numBytes);
+        }
       }
 
       // ospNewTexture2d //////////////////////////////////////////////////////
@@ -421,6 +564,11 @@ namespace ospray {
         std::memcpy(data.data(), texture, sz);
       }
 
+      bool NewTexture2d::recordable() const
+      {
+        return data.size() <= maxRecordedDataBytes;
+      }
+
       void NewTexture2d::run()
       {
         Texture2D *texture =
@@ -432,13 +580,13 @@ namespace ospray {
 
       void NewTexture2d::serialize(WriteStream &b) const
       {
-        b << (int64)handle << dimensions << (int32)format << flags << data;
+        b << handle << dimensions << (int32)format << flags << data;
       }
 
       void NewTexture2d::deserialize(ReadStream &b)
       {
         int32 fmt;
-        b >> handle.i64 >> dimensions >> fmt >> flags >> data;
+        b >> handle >> dimensions >> fmt >> flags >> data;
         format = (OSPTextureFormat)fmt;
       }
 
@@ -461,6 +609,11 @@ namespace ospray {
         std::memcpy(data.data(), src, bytes);
       }
 
+      bool SetRegion::recordable() const
+      {
+        return data.size() <= maxRecordedDataBytes;
+      }
+
       void SetRegion::run()
       {
         Volume *volume = (Volume*)handle.lookup();
@@ -475,13 +628,13 @@ namespace ospray {
 
       void SetRegion::serialize(WriteStream &b) const
       {
-        b << (int64)handle << regionStart << regionSize << (int32)type << data;
+        b << handle << regionStart << regionSize << (int32)type << data;
       }
 
       void SetRegion::deserialize(ReadStream &b)
       {
         int32 ty;
-        b >> handle.i64 >> regionStart >> regionSize >> ty >> data;
+        b >> handle >> regionStart >> regionSize >> ty >> data;
         type = (OSPDataType)ty;
       }
 
@@ -505,12 +658,12 @@ namespace ospray {
 
       void ClearFrameBuffer::serialize(WriteStream &b) const
       {
-        b << (int64)handle << channels;
+        b << handle << channels;
       }
 
       void ClearFrameBuffer::deserialize(ReadStream &b)
       {
-        b >> handle.i64 >> channels;
+        b >> handle >> channels;
       }
 
       // ospRenderFrame ///////////////////////////////////////////////////////
@@ -540,12 +693,12 @@ namespace ospray {
 
       void RenderFrame::serialize(WriteStream &b) const
       {
-        b << (int64)fbHandle << (int64)rendererHandle << channels;
+        b << fbHandle << rendererHandle << channels;
       }
 
       void RenderFrame::deserialize(ReadStream &b)
       {
-        b >> fbHandle.i64 >> rendererHandle.i64 >> channels;
+        b >> fbHandle >> rendererHandle >> channels;
       }
 
       // ospAddGeometry ///////////////////////////////////////////////////////
@@ -630,12 +783,12 @@ namespace ospray {
 
       void RemoveParam::serialize(WriteStream &b) const
       {
-        b << (int64)handle << name;
+        b << handle << name;
       }
 
       void RemoveParam::deserialize(ReadStream &b)
       {
-        b >> handle.i64 >> name;
+        b >> handle >> name;
       }
 
       // ospSetPixelOp ////////////////////////////////////////////////////////
@@ -661,12 +814,12 @@ namespace ospray {
 
       void SetPixelOp::serialize(WriteStream &b) const
       {
-        b << (int64)fbHandle << (int64)poHandle;
+        b << fbHandle << poHandle;
       }
 
       void SetPixelOp::deserialize(ReadStream &b)
       {
-        b >> fbHandle.i64 >> poHandle.i64;
+        b >> fbHandle >> poHandle;
       }
 
       // ospRelease ///////////////////////////////////////////////////////////
@@ -682,19 +835,22 @@ namespace ospray {
 
       void CommandRelease::runOnMaster()
       {
-        // master only create some type of objects
-        if( handle.defined())
+        // master only create some type of objects, but all handles are
+        // allocated here
+        if (handle.defined())
           handle.freeObject();
+        else
+          handle.free();
       }
 
       void CommandRelease::serialize(WriteStream &b) const
       {
-        b << (int64)handle;
+        b << handle;
       }
 
       void CommandRelease::deserialize(ReadStream &b)
       {
-        b >> handle.i64;
+        b >> handle;
       }
 
       // ospFinalize //////////////////////////////////////////////////////////
@@ -752,12 +908,12 @@ namespace ospray {
 
       void Pick::serialize(WriteStream &b) const
       {
-        b << (int64)rendererHandle << screenPos;
+        b << rendererHandle << screenPos;
       }
 
       void Pick::deserialize(ReadStream &b)
       {
-        b >> rendererHandle.i64 >> screenPos;
+        b >> rendererHandle >> screenPos;
       }
 
     } // ::ospray::mpi::work
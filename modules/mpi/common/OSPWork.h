@@ -39,6 +39,7 @@
 #include "transferFunction/TransferFunction.h"
 
 #include <map>
+#include <memory>
 
 namespace ospray {
   namespace mpi {
@@ -70,8 +71,65 @@ namespace ospray {
 
         /*! what to do to execute this work item on the master */
         virtual void runOnMaster() {}
+
+        /*! whether this work item may be recorded into a command
+          buffer, bulk data transfers are better sent directly */
+        virtual bool recordable() const { return true; }
+      };
+
+      /*! in-memory write stream that work items get recorded into for
+        command buffers; object handles written to it get delta
+        encoded against the previously written one */
+      struct CommandBufferWriteStream : public WriteStream
+      {
+        CommandBufferWriteStream(std::vector<byte_t> &buffer)
+          : buffer(buffer) {}
+
+        void write(void *mem, size_t size) override;
+        void writeHandle(const ObjectHandle &handle);
+
+        std::vector<byte_t> &buffer;
+        int64 lastHandle {0};
+      };
+
+      /*! in-memory read stream that command buffers get replayed from,
+        counterpart of CommandBufferWriteStream */
+      struct CommandBufferReadStream : public ReadStream
+      {
+        CommandBufferReadStream(const std::vector<byte_t> &buffer)
+          : buffer(buffer) {}
+
+        void read(void *mem, size_t size) override;
+        void readHandle(ObjectHandle &handle);
+
+        const std::vector<byte_t> &buffer;
+        size_t readPos {0};
+        int64  lastHandle {0};
       };
 
+      /*! @{ stream operators for object handles, compact for command
+        buffers and raw int64 everywhere else */
+      inline WriteStream &operator<<(WriteStream &b, const ObjectHandle &h)
+      {
+        auto *cb = dynamic_cast<CommandBufferWriteStream*>(&b);
+        if (cb)
+          cb->writeHandle(h);
+        else
+          b.write((byte_t*)&h.i64, sizeof(h.i64));
+        return b;
+      }
+
+      inline ReadStream &operator>>(ReadStream &b, ObjectHandle &h)
+      {
+        auto *cb = dynamic_cast<CommandBufferReadStream*>(&b);
+        if (cb)
+          cb->readHandle(h);
+        else
+          b.read((byte_t*)&h.i64, sizeof(h.i64));
+        return b;
+      }
+      /*! @} */
+
       using CreateWorkFct    = std::unique_ptr<Work>(*)();
       using WorkTypeRegistry = std::map<Work::tag_t, CreateWorkFct>;
 
@@ -99,6 +157,37 @@ namespace ospray {
 
       void registerOSPWorkItems(WorkTypeRegistry &registry);
 
+      /*! a batch of recorded work items that gets sent (and replayed on
+        the workers) as a single work item. items are stored with a
+        compact type index instead of their full tag, and with delta
+        encoded object handles */
+      struct CommandBuffer : public Work
+      {
+        CommandBuffer() = default;
+
+        /*! append the given work item to this buffer */
+        void record(const Work &work);
+
+        bool empty() const { return numCommands == 0; }
+        void clear();
+
+        /*! replay all recorded work items, in order */
+        void run() override;
+
+        bool recordable() const override { return false; }
+
+        void serialize(WriteStream &b) const override;
+        void deserialize(ReadStream &b) override;
+
+        size_t              numCommands {0};
+        std::vector<byte_t> commands;
+
+      private:
+
+        // stream the recorded items get written to (master only)
+        std::unique_ptr<CommandBufferWriteStream> recordStream;
+      };
+
       /*! this should go into implementation section ... */
       struct SetLoadBalancer :  public Work
       {
@@ -144,12 +233,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)handle << type; }
+        { b << handle << type; }
 
         /*! de-serialize from a buffer that an object of this type ha
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> handle.i64 >> type; }
+        { b >> handle >> type; }
 
         std::string  type;
         ObjectHandle handle;
@@ -188,12 +277,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)rendererHandle << (int64)handle << type; }
+        { b << rendererHandle << handle << type; }
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> rendererHandle.i64 >> handle.i64 >> type; }
+        { b >> rendererHandle >> handle >> type; }
 
         // const static size_t TAG = NewRendererObjectTag<T>::TAG;
         std::string  type;
@@ -214,12 +303,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)rendererHandle << (int64)handle << type; }
+        { b << rendererHandle << handle << type; }
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> rendererHandle.i64 >> handle.i64 >> type; }
+        { b >> rendererHandle >> handle >> type; }
 
         // const static size_t TAG = NewRendererObjectTag<T>::TAG;
         std::string  type;
@@ -244,6 +333,9 @@ namespace ospray {
 
         void run() override;
 
+        /*! only small arrays get recorded into command buffers */
+        bool recordable() const override;
+
         /*! serializes itself on the given serial buffer - will write
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
@@ -257,10 +349,14 @@ namespace ospray {
         size_t       nItems;
         OSPDataType  format;
 
-        std::vector<byte_t>        copiedData;
-        utility::ArrayView<byte_t> dataView;//<-- may point to user data or
-                                            //    'copiedData' member, depending
-                                            //    on flags given on construction
+        utility::ArrayView<byte_t> dataView;//<-- points to user data on the
+                                            //    master, 'receivedData' on
+                                            //    the workers
+
+        /*! aligned buffer the data gets de-serialized into on the
+            workers; ownership gets handed to the Data object in run() */
+        std::unique_ptr<byte_t, decltype(&alignedFree)>
+          receivedData {nullptr, &alignedFree};
 
         int32 flags;
       };
@@ -274,6 +370,9 @@ namespace ospray {
 
         void run() override;
 
+        /*! only small arrays get recorded into command buffers */
+        bool recordable() const override;
+
         /*! serializes itself on the given serial buffer - will write
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
@@ -299,6 +398,9 @@ namespace ospray {
 
         void run() override;
 
+        /*! only small arrays get recorded into command buffers */
+        bool recordable() const override;
+
         /*! serializes itself on the given serial buffer - will write
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
@@ -395,12 +497,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)modelHandle << (int64)objectHandle; }
+        { b << modelHandle << objectHandle; }
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> modelHandle.i64 >> objectHandle.i64; }
+        { b >> modelHandle >> objectHandle; }
 
         ObjectHandle modelHandle;
         ObjectHandle objectHandle;
@@ -421,12 +523,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)modelHandle << (int64)objectHandle; }
+        { b << modelHandle << objectHandle; }
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> modelHandle.i64 >> objectHandle.i64; }
+        { b >> modelHandle >> objectHandle; }
 
         ObjectHandle modelHandle;
         ObjectHandle objectHandle;
@@ -447,12 +549,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)modelHandle << (int64)objectHandle; }
+        { b << modelHandle << objectHandle; }
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> modelHandle.i64 >> objectHandle.i64; }
+        { b >> modelHandle >> objectHandle; }
 
         ObjectHandle modelHandle;
         ObjectHandle objectHandle;
@@ -472,12 +574,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)modelHandle << (int64)objectHandle; }
+        { b << modelHandle << objectHandle; }
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> modelHandle.i64 >> objectHandle.i64; }
+        { b >> modelHandle >> objectHandle; }
 
         ObjectHandle modelHandle;
         ObjectHandle objectHandle;
@@ -487,7 +589,8 @@ namespace ospray {
       {
         CreateFrameBuffer() = default;
         CreateFrameBuffer(ObjectHandle handle, vec2i dimensions,
-                          OSPFrameBufferFormat format, uint32 channels);
+                          OSPFrameBufferFormat format, uint32 channels,
+                          vec2i tileSize);
 
         void run() override;
         void runOnMaster() override;
@@ -505,6 +608,7 @@ namespace ospray {
         vec2i dimensions {-1};
         OSPFrameBufferFormat format;
         uint32 channels;
+        vec2i tileSize {TILE_SIZE};
       };
 
       /*! this should go into implementation section ... */
@@ -541,12 +645,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)handle << name << val; }
+        { b << handle << name << val; }
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> handle.i64 >> name >> val; }
+        { b >> handle >> name >> val; }
 
         ObjectHandle handle;
         std::string name;
@@ -580,12 +684,12 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)handle << (int64)material; }
+        { b << handle << material; }
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> handle.i64 >> material.i64; }
+        { b >> handle >> material; }
 
         ObjectHandle handle;
         ObjectHandle material;
@@ -620,13 +724,13 @@ namespace ospray {
           all data into this buffer in a way that it can afterwards
           un-serialize itself 'on the other side'*/
         void serialize(WriteStream &b) const override
-        { b << (int64)handle << name << (int64)val; }
+        { b << handle << name << val; }
 
 
         /*! de-serialize from a buffer that an object of this type has
           serialized itself in */
         void deserialize(ReadStream &b) override
-        { b >> handle.i64 >> name >> val.i64; }
+        { b >> handle >> name >> val; }
 
         ObjectHandle handle;
         std::string  name;
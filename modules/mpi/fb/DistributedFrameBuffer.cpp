@@ -20,9 +20,12 @@
 
 #include "ospcommon/tasking/parallel_for.h"
 #include "ospcommon/tasking/schedule.h"
+#include "ospcommon/utility/Trace.h"
 
 #include "mpiCommon/MPICommon.h"
 
+#include "ospray/common/FrameStats.h"
+
 #ifdef _WIN32
 #  include <windows.h> // for Sleep
 #endif
@@ -74,30 +77,24 @@ namespace ospray {
       }
   };
 
-  /*! message sent to the master when a tile is finished. TODO:
+  /*! message sent to the master when a tile is finished. only the
+      frame buffer's tileSize.x x tileSize.y pixels are sent (row-major,
+      without the padding to TILE_SIZE), followed by as many depth
+      values if the message has MASTER_TILE_HAS_DEPTH set. TODO:
       compress the color data */
   template <typename FBType>
   struct MasterTileMessage_FB : public MasterTileMessage
   {
     FBType color[TILE_SIZE * TILE_SIZE];
-  };
 
-  template <typename ColorT>
-  struct MasterTileMessage_FB_Depth : public MasterTileMessage_FB<ColorT>
-  {
-    float depth[TILE_SIZE * TILE_SIZE];
+    const float *depth(const vec2i &tileSize) const
+    {
+      return reinterpret_cast<const float*>(color + tileSize.x * tileSize.y);
+    }
   };
-  // TODO: Maybe we want to add a separate MasterTileMessage_FBD
-  // that has an additional depth channel it ships along? If we
-  // only care about colors I don't want to force the added
-  // 4 * TILE_SIZE * TILE_SIZE bytes on the messaging system
-  // since it will add quite a bit of overhead.
 
   using MasterTileMessage_RGBA_I8    = MasterTileMessage_FB<uint32>;
   using MasterTileMessage_RGBA_F32   = MasterTileMessage_FB<vec4f>;
-  using MasterTileMessage_RGBA_I8_Z  = MasterTileMessage_FB_Depth<uint32>;
-  using MasterTileMessage_RGBA_F32   = MasterTileMessage_FB<vec4f>;
-  using MasterTileMessage_RGBA_F32_Z = MasterTileMessage_FB_Depth<vec4f>;
   using MasterTileMessage_NONE       = MasterTileMessage;
 
   /*! It's a real PITA do try and do this using the message structs
@@ -107,37 +104,50 @@ namespace ospray {
   {
     OSPFrameBufferFormat colorFormat;
     bool hasDepth;
+    vec2i tileSize;
     size_t pixelSize;
     MasterTileMessage_NONE *header;
 
+    /*! copies the tileSize.x x tileSize.y pixels of a TILE_SIZE x
+        TILE_SIZE buffer to 'out', without the padding */
+    void copyPixels(const void *in, uint8_t *out, size_t bytesPerPixel)
+    {
+      const uint8_t *input = reinterpret_cast<const uint8_t*>(in);
+      const size_t rowBytes = bytesPerPixel * tileSize.x;
+      for (int y = 0; y < tileSize.y; y++) {
+        std::copy(input, input + rowBytes, out);
+        input += bytesPerPixel * TILE_SIZE;
+        out   += rowBytes;
+      }
+    }
+
   public:
     std::shared_ptr<mpicommon::Message> message;
 
     MasterTileMessageBuilder(OSPFrameBufferFormat fmt, bool hasDepth,
-        vec2i coords, float error)
-      : colorFormat(fmt), hasDepth(hasDepth)
+        const vec2i &tileSize, vec2i coords, float error)
+      : colorFormat(fmt), hasDepth(hasDepth), tileSize(tileSize)
     {
       int command;
-      size_t msgSize = 0;
       switch (colorFormat) {
         case OSP_FB_NONE:
           throw std::runtime_error("Do not use per tile message for FB_NONE!");
         case OSP_FB_RGBA8:
         case OSP_FB_SRGBA:
           command = MASTER_WRITE_TILE_I8;
-          msgSize = sizeof(MasterTileMessage_RGBA_I8);
           pixelSize = sizeof(uint32);
           break;
         case OSP_FB_RGBA32F:
           command = MASTER_WRITE_TILE_F32;
-          msgSize = sizeof(MasterTileMessage_RGBA_F32);
           pixelSize = sizeof(vec4f);
           break;
         default:
           throw std::runtime_error("Unsupported color buffer fmt in DFB!");
       }
+      const size_t numPixels = tileSize.x * tileSize.y;
+      size_t msgSize = sizeof(MasterTileMessage_NONE) + pixelSize * numPixels;
       if (hasDepth) {
-        msgSize += sizeof(float) * TILE_SIZE * TILE_SIZE;
+        msgSize += sizeof(float) * numPixels;
         command = command | MASTER_TILE_HAS_DEPTH;
       }
       message = std::make_shared<mpicommon::Message>(msgSize);
@@ -146,30 +156,90 @@ namespace ospray {
       header->coords = coords;
       header->error = error;
     }
-    void setColor(const vec4f *color) {
+    void setColor(const void *color) {
       if (colorFormat != OSP_FB_NONE) {
-        const uint8_t *input = reinterpret_cast<const uint8_t*>(color);
         uint8_t *out = message->data + sizeof(MasterTileMessage_NONE);
-        std::copy(input, input + pixelSize * TILE_SIZE * TILE_SIZE, out);
+        copyPixels(color, out, pixelSize);
       }
     }
     void setDepth(const float *depth) {
       if (hasDepth) {
-        float *out = reinterpret_cast<float*>(message->data
-                     + sizeof(MasterTileMessage_NONE)
-                     + pixelSize * TILE_SIZE * TILE_SIZE);
-        std::copy(depth, depth + TILE_SIZE * TILE_SIZE, out);
+        uint8_t *out = message->data + sizeof(MasterTileMessage_NONE)
+                       + pixelSize * tileSize.x * tileSize.y;
+        copyPixels(depth, out, sizeof(float));
       }
     }
   };
 
   /*! message sent from one node's instance to another, to tell that
-      instance to write that tile */
+      instance to write that tile. only the rows covered by the tile's
+      region are sent, as r, g, b, a and -- if the receiving tile needs
+      depth -- z channel following this header */
   struct WriteTileMessage : public TileMessage
   {
     // TODO: add compression of pixels during transmission
-    vec2i coords; // XXX redundant: it's also in tile.region.lower
-    ospray::Tile tile;
+    vec2i    coords; // XXX redundant: it's also in region.lower
+    region2i region;
+    vec2i    fbSize;
+    vec2f    rcp_fbSize;
+    int32    generation;
+    int32    children;
+    int32    accumID;
+    int32    hasDepth;
+
+    static size_t size(const ospray::Tile &tile, bool hasDepth)
+    {
+      return sizeof(WriteTileMessage)
+        + (hasDepth ? 5 : 4) * channelSize(tile.region);
+    }
+
+    static size_t channelSize(const region2i &region)
+    {
+      return region.size().y * TILE_SIZE * sizeof(float);
+    }
+
+    float *channel(int i)
+    {
+      return (float*)((byte_t*)(this + 1) + i * channelSize(region));
+    }
+
+    void pack(const ospray::Tile &tile)
+    {
+      region     = tile.region;
+      fbSize     = tile.fbSize;
+      rcp_fbSize = tile.rcp_fbSize;
+      generation = tile.generation;
+      children   = tile.children;
+      accumID    = tile.accumID;
+
+      const size_t bytes = channelSize(region);
+      memcpy(channel(0), tile.r, bytes);
+      memcpy(channel(1), tile.g, bytes);
+      memcpy(channel(2), tile.b, bytes);
+      memcpy(channel(3), tile.a, bytes);
+      if (hasDepth)
+        memcpy(channel(4), tile.z, bytes);
+    }
+
+    void unpack(ospray::Tile &tile)
+    {
+      tile.region     = region;
+      tile.fbSize     = fbSize;
+      tile.rcp_fbSize = rcp_fbSize;
+      tile.generation = generation;
+      tile.children   = children;
+      tile.accumID    = accumID;
+
+      const size_t bytes = channelSize(region);
+      memcpy(tile.r, channel(0), bytes);
+      memcpy(tile.g, channel(1), bytes);
+      memcpy(tile.b, channel(2), bytes);
+      memcpy(tile.a, channel(3), bytes);
+      if (hasDepth)
+        memcpy(tile.z, channel(4), bytes);
+      else
+        std::fill(tile.z, tile.z + bytes / sizeof(float), inf);
+    }
   };
 
   // DistributedTileError definitions /////////////////////////////////////////
@@ -195,10 +265,11 @@ namespace ospray {
                               bool hasDepthBuffer,
                               bool hasAccumBuffer,
                               bool hasVarianceBuffer,
-                              bool masterIsAWorker)
+                              bool masterIsAWorker,
+                              const vec2i &tileSize)
     : MessageHandler(myId),
       FrameBuffer(numPixels,colorBufferFormat,hasDepthBuffer,
-                  hasAccumBuffer,hasVarianceBuffer),
+                  hasAccumBuffer,hasVarianceBuffer,tileSize),
       tileErrorRegion(hasVarianceBuffer ? getNumTiles() : vec2i(0)),
       localFBonMaster(nullptr),
       frameMode(WRITE_MULTIPLE),
@@ -207,7 +278,8 @@ namespace ospray {
       masterIsAWorker(masterIsAWorker)
   {
     this->ispcEquivalent = ispc::DFB_create(this);
-    ispc::DFB_set(getIE(), numPixels.x, numPixels.y, colorBufferFormat);
+    ispc::DFB_set(getIE(), numPixels.x, numPixels.y, colorBufferFormat,
+                  tileSize.x, tileSize.y);
 
     createTiles();
 
@@ -230,7 +302,9 @@ namespace ospray {
                                                colorBufferFormat,
                                                hasDepthBuffer,
                                                false,
-                                               false);
+                                               false,
+                                               nullptr,
+                                               tileSize);
       }
     }
   }
@@ -244,6 +318,8 @@ namespace ospray {
 
   void DFB::startNewFrame(const float errorThreshold)
   {
+    OSPRAY_TRACE_SCOPE("DFB::startNewFrame");
+
     std::vector<std::shared_ptr<mpicommon::Message>> delayedMessage;
 
     {
@@ -356,8 +432,8 @@ namespace ospray {
   {
     size_t tileID = 0;
     vec2i numPixels = getNumPixels();
-    for (int y = 0; y < numPixels.y; y += TILE_SIZE) {
-      for (int x = 0; x < numPixels.x; x += TILE_SIZE, tileID++) {
+    for (int y = 0; y < numPixels.y; y += tileSize.y) {
+      for (int x = 0; x < numPixels.x; x += tileSize.x, tileID++) {
         const size_t ownerID = ownerIDFromTileID(tileID);
         const vec2i tileStart(x, y);
         if (ownerID == size_t(mpicommon::globalRank())) {
@@ -416,8 +492,11 @@ namespace ospray {
 
   void DFB::waitUntilFinished()
   {
+    OSPRAY_TRACE_SCOPE("DFB::waitUntilFinished");
+    const double start = getSysTime();
     std::unique_lock<std::mutex> lock(mutex);
     frameDoneCond.wait(lock, [&]{return frameIsDone;});
+    addRenderCount(RC_COMPOSITE_NS, uint64((getSysTime() - start) * 1e9));
   }
 
 void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
@@ -441,7 +520,9 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
     auto *tileDesc = this->getTileDescFor(msg->coords);
     // TODO: compress/decompress tile data
     TileData *td = (TileData*)tileDesc;
-    td->process(msg->tile);
+    std::unique_ptr<ospray::Tile> tile(new ospray::Tile);
+    msg->unpack(*tile);
+    td->process(*tile);
   }
 
   void DFB::tileIsCompleted(TileData *tile)
@@ -449,15 +530,18 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
     DBG(printf("rank %i: tilecompleted %i,%i\n",mpicommon::globalRank(),
                tile->begin.x,tile->begin.y));
 
+    OSPRAY_TRACE_SCOPE("DFB::tileIsCompleted");
+
     if (pixelOp) {
-      pixelOp->postAccum(tile->final);
+      OSPRAY_TRACE_SCOPE("PixelOp::postAccum");
+      pixelOp->postAccum(*tile->final);
     }
 
     auto msg = [&]{
       MasterTileMessageBuilder msg(colorBufferFormat, hasDepthBuffer,
-                                   tile->begin, tile->error);
+                                   getTileSize(), tile->begin, tile->error);
       msg.setColor(tile->color);
-      msg.setDepth(tile->final.z);
+      msg.setDepth(tile->final->z);
       return msg;
     };
 
@@ -466,7 +550,7 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
     if (mpicommon::IamAWorker()) {
       if(colorBufferFormat == OSP_FB_NONE) {
         SCOPED_LOCK(tileErrorsMutex);
-        tileIDs.push_back(tile->begin/TILE_SIZE);
+        tileIDs.push_back(tile->begin/getTileSize());
         tileErrors.push_back(tile->error);
       }
       else
@@ -513,7 +597,7 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
 
   size_t DFB::getTileIDof(const vec2i &c) const
   {
-    return (c.x/TILE_SIZE) + (c.y/TILE_SIZE)*numTiles.x;
+    return (c.x/tileSize.x) + (c.y/tileSize.y)*numTiles.x;
   }
 
   std::string DFB::toString() const
@@ -539,6 +623,7 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
   void DFB::scheduleProcessing(const std::shared_ptr<mpicommon::Message> &message)
   {
       tasking::schedule([=]() {
+        OSPRAY_TRACE_SCOPE_ARG("DFB::processMessage", "bytes", message->size);
         auto *msg = (TileMessage*)message->data;
         if (msg->command & MASTER_WRITE_TILE_I8) {
           this->processMessage((MasterTileMessage_RGBA_I8*)msg);
@@ -556,6 +641,8 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
 
   void DFB::sendAllTilesDoneMessage()
   {
+      OSPRAY_TRACE_SCOPE("DFB::sendAllTilesDoneMessage");
+
       auto msg = std::make_shared<mpicommon::Message>
               (AllTilesDoneMessage::size(tileErrors.size()));
 
@@ -582,6 +669,7 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
   void DFB::closeCurrentFrame()
   {
     DBG(printf("rank %i CLOSES frame\n", mpicommon::globalRank()));
+    OSPRAY_TRACE_INSTANT("DFB::closeCurrentFrame");
 
     if (mpicommon::IamTheMaster() && !masterIsAWorker) {
       /* do nothing */
@@ -605,14 +693,17 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
 
     if (!tileDesc->mine()) {
       // NOT my tile...
-      WriteTileMessage msgPayload;
-      msgPayload.coords = tile.region.lower;
+      OSPRAY_TRACE_SCOPE_ARG("DFB::sendTile", "owner", tileDesc->ownerID);
+      // depth is only needed for compositing, or to fill a depth buffer
+      const bool sendDepth = hasDepthBuffer || frameMode != WRITE_MULTIPLE;
+      auto msg = std::make_shared<mpicommon::Message>(
+          WriteTileMessage::size(tile, sendDepth));
+      auto *msgPayload = new (msg->data) WriteTileMessage;
+      msgPayload->command = WORKER_WRITE_TILE;
+      msgPayload->coords = tile.region.lower;
+      msgPayload->hasDepth = sendDepth;
       // TODO: compress pixels before sending ...
-      memcpy(&msgPayload.tile, &tile, sizeof(ospray::Tile));
-      msgPayload.command = WORKER_WRITE_TILE;
-
-      auto msg = std::make_shared<mpicommon::Message>(&msgPayload,
-                                                      sizeof(msgPayload));
+      msgPayload->pack(tile);
 
       int dstRank = tileDesc->ownerID;
       DBG(printf("rank %i: send tile %i,%i to %i\n",mpicommon::globalRank(),
@@ -621,6 +712,7 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
     } else {
       if (!frameIsActive)
         throw std::runtime_error("#dfb: cannot setTile if frame is inactive!");
+      OSPRAY_TRACE_SCOPE("DFB::processTile");
       TileData *td = (TileData*)tileDesc;
       td->process(tile);
     }
@@ -641,26 +733,26 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
         TileData *td = this->myTiles[taskIndex];
         assert(td);
         const auto bytes = TILE_SIZE * TILE_SIZE * sizeof(float);
-        if (hasAccumBuffer && (fbChannelFlags & OSP_FB_ACCUM)) {
-          memset(td->accum.r, 0, bytes);
-          memset(td->accum.g, 0, bytes);
-          memset(td->accum.b, 0, bytes);
-          memset(td->accum.a, 0, bytes);
-          for (int i = 0; i < TILE_SIZE*TILE_SIZE; i++) td->accum.z[i] = inf;
-          if (hasVarianceBuffer) { // clearing ACCUM also clears VARIANCE
-            memset(td->variance.r, 0, bytes);
-            memset(td->variance.g, 0, bytes);
-            memset(td->variance.b, 0, bytes);
-            memset(td->variance.a, 0, bytes);
+        if (td->accum && (fbChannelFlags & OSP_FB_ACCUM)) {
+          memset(td->accum->r, 0, bytes);
+          memset(td->accum->g, 0, bytes);
+          memset(td->accum->b, 0, bytes);
+          memset(td->accum->a, 0, bytes);
+          for (int i = 0; i < TILE_SIZE*TILE_SIZE; i++) td->accum->z[i] = inf;
+          if (td->variance) { // clearing ACCUM also clears VARIANCE
+            memset(td->variance->r, 0, bytes);
+            memset(td->variance->g, 0, bytes);
+            memset(td->variance->b, 0, bytes);
+            memset(td->variance->a, 0, bytes);
           }
         }
         if (hasDepthBuffer && (fbChannelFlags & OSP_FB_DEPTH))
-          for (int i = 0; i < TILE_SIZE*TILE_SIZE; i++) td->final.z[i] = inf;
+          for (int i = 0; i < TILE_SIZE*TILE_SIZE; i++) td->final->z[i] = inf;
         if (fbChannelFlags & OSP_FB_COLOR) {
-          memset(td->final.r, 0, bytes);
-          memset(td->final.g, 0, bytes);
-          memset(td->final.b, 0, bytes);
-          memset(td->final.a, 0, bytes);
+          memset(td->final->r, 0, bytes);
+          memset(td->final->g, 0, bytes);
+          memset(td->final->b, 0, bytes);
+          memset(td->final->a, 0, bytes);
         }
       });
     }
@@ -685,12 +777,14 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
 
   void DFB::beginFrame()
   {
+    OSPRAY_TRACE_SCOPE("DFB::beginFrame");
     mpi::messaging::enableAsyncMessaging();
     FrameBuffer::beginFrame();
   }
 
   float DFB::endFrame(const float errorThreshold)
   {
+    OSPRAY_TRACE_SCOPE("DFB::endFrame");
     mpi::messaging::disableAsyncMessaging();
     memset(tileInstances, 0, sizeof(int32)*getTotalTiles()); // XXX needed?
     if (mpicommon::IamTheMaster()) // only refine on master
@@ -31,8 +31,6 @@ namespace ospray {
   struct MasterTileMessage;
   template <typename FBType>
   struct MasterTileMessage_FB;
-  template <typename ColorT>
-  struct MasterTileMessage_FB_Depth;
   struct WriteTileMessage;
 
   /*! color buffer and depth buffer on master */
@@ -76,7 +74,8 @@ namespace ospray {
                            bool hasDepthBuffer,
                            bool hasAccumBuffer,
                            bool hasVarianceBuffer,
-                           bool masterIsAWorker = false);
+                           bool masterIsAWorker = false,
+                           const vec2i &tileSize = vec2i(TILE_SIZE));
 
     ~DistributedFrameBuffer();
 
@@ -268,35 +267,34 @@ namespace ospray {
   DistributedFrameBuffer::processMessage(MasterTileMessage_FB<FBType> *msg)
   {
     if (hasVarianceBuffer) {
-      const vec2i tileID = msg->coords/TILE_SIZE;
+      const vec2i tileID = msg->coords/tileSize;
       if (msg->error < (float)inf)
         tileErrorRegion.update(tileID, msg->error);
     }
 
     vec2i numPixels = getNumPixels();
 
-    MasterTileMessage_FB_Depth<FBType> *depth = nullptr;
-    if (msg->command & MASTER_TILE_HAS_DEPTH) {
-      depth = reinterpret_cast<MasterTileMessage_FB_Depth<FBType>*>(msg);
-    }
+    const float *depth = nullptr;
+    if (msg->command & MASTER_TILE_HAS_DEPTH)
+      depth = msg->depth(tileSize);
 
     FBType *color = reinterpret_cast<FBType*>(localFBonMaster->colorBuffer);
-    for (int iy = 0; iy < TILE_SIZE; iy++) {
+    for (int iy = 0; iy < tileSize.y; iy++) {
       int iiy = iy + msg->coords.y;
       if (iiy >= numPixels.y) {
         continue;
       }
 
-      for (int ix = 0; ix < TILE_SIZE; ix++) {
+      for (int ix = 0; ix < tileSize.x; ix++) {
         int iix = ix + msg->coords.x;
         if (iix >= numPixels.x) {
           continue;
         }
 
-        color[iix + iiy * numPixels.x] = msg->color[ix + iy * TILE_SIZE];
+        color[iix + iiy * numPixels.x] = msg->color[ix + iy * tileSize.x];
         if (depth) {
           localFBonMaster->depthBuffer[iix + iiy * numPixels.x]
-            = depth->depth[ix + iy * TILE_SIZE];
+            = depth[ix + iy * tileSize.x];
         }
       }
     }
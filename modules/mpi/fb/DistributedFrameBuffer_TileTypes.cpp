@@ -29,8 +29,32 @@ namespace ospray {
 
   TileData::TileData(DFB *dfb, const vec2i &begin,
                      size_t tileID, size_t ownerID)
-    : TileDesc(dfb,begin,tileID,ownerID)
-  {}
+    : TileDesc(dfb,begin,tileID,ownerID),
+      final(make_unique<ospray::Tile>())
+  {
+    if (dfb->hasAccumBuffer) {
+      accum = make_unique<ospray::Tile>();
+      if (dfb->hasVarianceBuffer)
+        variance = make_unique<ospray::Tile>();
+    }
+
+    switch (dfb->colorBufferFormat) {
+      case OSP_FB_RGBA8:
+      case OSP_FB_SRGBA:
+        color = alignedMalloc(sizeof(uint32)*TILE_SIZE*TILE_SIZE);
+        break;
+      case OSP_FB_RGBA32F:
+        color = alignedMalloc(sizeof(vec4f)*TILE_SIZE*TILE_SIZE);
+        break;
+      default:
+        break;
+    }
+  }
+
+  TileData::~TileData()
+  {
+    alignedFree(color);
+  }
 
   AlphaBlendTile_simple::AlphaBlendTile_simple(DistributedFrameBuffer *dfb,
                                                const vec2i &begin,
@@ -71,10 +95,10 @@ namespace ospray {
         DFB_accumulate = &ispc::DFB_accumulate_SRGBA;
     }
     error = DFB_accumulate((ispc::VaryingTile*)&tile
-        , (ispc::VaryingTile*)&final
-        , (ispc::VaryingTile*)&accum
-        , (ispc::VaryingTile*)&variance
-        , &color
+        , (ispc::VaryingTile*)final.get()
+        , (ispc::VaryingTile*)accum.get()
+        , (ispc::VaryingTile*)variance.get()
+        , color
         , dfb->hasAccumBuffer
         , dfb->hasVarianceBuffer
         );
@@ -88,9 +112,9 @@ namespace ospray {
     memcpy(&addTile->tile,&tile,sizeof(tile));
     computeSortOrder(addTile);
 
-    this->final.region = tile.region;
-    this->final.fbSize = tile.fbSize;
-    this->final.rcp_fbSize = tile.rcp_fbSize;
+    this->final->region = tile.region;
+    this->final->fbSize = tile.fbSize;
+    this->final->rcp_fbSize = tile.rcp_fbSize;
 
     {
       SCOPED_LOCK(mutex);
@@ -123,9 +147,9 @@ namespace ospray {
         ispc::DFB_sortAndBlendFragments((ispc::VaryingTile **)tileArray,
                                         bufferedTile.size());
 
-        this->final.region = tile.region;
-        this->final.fbSize = tile.fbSize;
-        this->final.rcp_fbSize = tile.rcp_fbSize;
+        this->final->region = tile.region;
+        this->final->fbSize = tile.fbSize;
+        this->final->rcp_fbSize = tile.rcp_fbSize;
         accumulate(bufferedTile[0]->tile);
         dfb->tileIsCompleted(this);
         for (auto &tile : bufferedTile)
@@ -141,14 +165,23 @@ namespace ospray {
     instances = dfb->tileInstances[tileID];
     writeOnceTile = instances <= 1;
     tileBuffered = false;
+
+    // multiple instances of a tile get accumulated (and their variance
+    // estimated) even if the frame buffer itself has no such buffers
+    if (!writeOnceTile) {
+      if (!accum)
+        accum = make_unique<ospray::Tile>();
+      if (!variance)
+        variance = make_unique<ospray::Tile>();
+    }
   }
 
   void WriteMultipleTile::process(const ospray::Tile &tile)
   {
     if (writeOnceTile) {
-      final.region = tile.region;
-      final.fbSize = tile.fbSize;
-      final.rcp_fbSize = tile.rcp_fbSize;
+      final->region = tile.region;
+      final->fbSize = tile.fbSize;
+      final->rcp_fbSize = tile.rcp_fbSize;
       accumulate(tile);
       dfb->tileIsCompleted(this);
       return;
@@ -157,25 +190,28 @@ namespace ospray {
     bool done = false;
 
     if (tile.accumID == 0) {
-      final.region = tile.region;
-      final.fbSize = tile.fbSize;
-      final.rcp_fbSize = tile.rcp_fbSize;
+      final->region = tile.region;
+      final->fbSize = tile.fbSize;
+      final->rcp_fbSize = tile.rcp_fbSize;
 
       const auto bytes = tile.region.size().y * (TILE_SIZE * sizeof(float));
-      memcpy(accum.z, tile.z, bytes);
-      memcpy(final.z, tile.z, bytes);
+      if (accum)
+        memcpy(accum->z, tile.z, bytes);
+      memcpy(final->z, tile.z, bytes);
     }
 
     {
       SCOPED_LOCK(mutex);
       maxAccumID = std::max(maxAccumID, tile.accumID);
       if (!tileBuffered && (tile.accumID & 1) == 0) {
-        memcpy(&bufferedTile, &tile, sizeof(ospray::Tile));
+        if (!bufferedTile)
+          bufferedTile = make_unique<ospray::Tile>();
+        memcpy(bufferedTile.get(), &tile, sizeof(ospray::Tile));
         tileBuffered = true;
       } else
         ispc::DFB_accumulate_only((ispc::VaryingTile*)&tile
-            , (ispc::VaryingTile*)&this->accum
-            , (ispc::VaryingTile*)&this->variance
+            , (ispc::VaryingTile*)this->accum.get()
+            , (ispc::VaryingTile*)this->variance.get()
             );
       done = --instances == 0;
     }
@@ -198,27 +234,27 @@ namespace ospray {
         // estimate variance now, when accum buffer is also one (the buffered)
         // tile short
         const float prevErr = DFB_calcerror((ispc::vec2i&)sz
-            , (ispc::VaryingTile*)&accum
-            , (ispc::VaryingTile*)&variance
+            , (ispc::VaryingTile*)accum.get()
+            , (ispc::VaryingTile*)variance.get()
             , maxAccumID - 1
             );
 
         // use maxAccumID for correct normalization
         // this is OK, because both accumIDs are even
-        bufferedTile.accumID = maxAccumID;
-        accumulate(bufferedTile);
+        bufferedTile->accumID = maxAccumID;
+        accumulate(*bufferedTile);
         error = prevErr;
       } else {
-        ispc::DFB_accumulate_only((ispc::VaryingTile*)&bufferedTile
-            , (ispc::VaryingTile*)&this->accum
-            , (ispc::VaryingTile*)&this->variance
+        ispc::DFB_accumulate_only((ispc::VaryingTile*)bufferedTile.get()
+            , (ispc::VaryingTile*)this->accum.get()
+            , (ispc::VaryingTile*)this->variance.get()
             );
         error = DFB_readout((ispc::vec2i&)sz
-            , (ispc::VaryingTile*)&accum
-            , (ispc::VaryingTile*)&variance
+            , (ispc::VaryingTile*)accum.get()
+            , (ispc::VaryingTile*)variance.get()
             , maxAccumID
-            , (ispc::VaryingTile*)&final
-            , &color
+            , (ispc::VaryingTile*)final.get()
+            , color
             );
       }
 
@@ -232,7 +268,8 @@ namespace ospray {
                                  size_t ownerID,
                                  size_t numWorkers)
     : TileData(dfb,begin,tileID,ownerID),
-      numWorkers(numWorkers)
+      numWorkers(numWorkers),
+      compositedTileData(make_unique<ospray::Tile>())
   {}
 
   void ZCompositeTile::newFrame()
@@ -247,16 +284,16 @@ namespace ospray {
     {
       SCOPED_LOCK(mutex);
       if (numPartsComposited == 0)
-        memcpy(&compositedTileData, &tile, sizeof(tile));
+        memcpy(compositedTileData.get(), &tile, sizeof(tile));
       else
         ispc::DFB_zComposite((ispc::VaryingTile*)&tile,
-                             (ispc::VaryingTile*)&this->compositedTileData);
+                             (ispc::VaryingTile*)compositedTileData.get());
 
       done = (++numPartsComposited == numWorkers);
     }
 
     if (done) {
-      accumulate(this->compositedTileData);
+      accumulate(*compositedTileData);
       dfb->tileIsCompleted(this);
     }
   }
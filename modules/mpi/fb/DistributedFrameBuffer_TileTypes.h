@@ -18,6 +18,7 @@
 
 #include "fb/Tile.h"
 
+#include <memory>
 #include <vector>
 
 namespace ospray {
@@ -49,10 +50,11 @@ namespace ospray {
 
   // -------------------------------------------------------
   /*! base class for a dfb tile. the only thing that all tiles have
-      in common is depth, and RGBA-float accumulated data. Note we
-      do not have a RGBA-I8 color field, because typically that'll
-      be done by the postop and send-to-master op, and not stored in
-      the DFB tile itself */
+      in common is depth, and RGBA-float accumulated data. Only the
+      channels the frame buffer actually has are allocated: 'accum'
+      and 'variance' are nullptr without ACCUM resp. VARIANCE buffer,
+      and 'color' holds the colors in the frame buffer's color format
+      (and is nullptr for OSP_FB_NONE) */
   struct TileData : public TileDesc
   {
     TileData(DistributedFrameBuffer *dfb,
@@ -60,6 +62,8 @@ namespace ospray {
              size_t tileID,
              size_t ownerID);
 
+    ~TileData() override;
+
     /*! called exactly once at the beginning of each frame */
     virtual void newFrame() = 0;
 
@@ -74,18 +78,16 @@ namespace ospray {
     void accumulate(const ospray::Tile &tile);
 
     float error; // estimated variance of this tile
-    // TODO: dynamically allocate to save memory when no ACCUM or VARIANCE
-    ospray::Tile __aligned(64) accum;
-    ospray::Tile __aligned(64) variance;
+    std::unique_ptr<ospray::Tile> accum;
+    std::unique_ptr<ospray::Tile> variance;
     /* iw: TODO - have to change this. right now, to be able to give
        the 'postaccum' pixel op a readily normalized tile we have to
        create a local copy (the tile stores only the accum value,
        and we cannot change this) */
-    ospray::Tile  __aligned(64) final;
+    std::unique_ptr<ospray::Tile> final;
 
-    //! the rbga32-converted colors
-    // TODO: dynamically allocate to save memory when only uint32 / I8 colors
-    vec4f __aligned(64) color[TILE_SIZE*TILE_SIZE];
+    //! the colors converted to the color buffer format
+    void *color {nullptr};
   };
 
 
@@ -115,8 +117,9 @@ namespace ospray {
     bool writeOnceTile;
     // serialize when multiple instances of this tile arrive at the same time
     std::mutex mutex;
-    // defer accumulation to get correct variance estimate
-    ospray::Tile bufferedTile;
+    // defer accumulation to get correct variance estimate; only
+    // allocated once a tile actually arrives more than once per frame
+    std::unique_ptr<ospray::Tile> bufferedTile;
     bool tileBuffered;
   };
 
@@ -143,7 +146,7 @@ namespace ospray {
     /*! since we do not want to mess up the existing accumulatation
         buffer in the parent tile we temporarily composite into this
         buffer until all the composites have been done. */
-    ospray::Tile compositedTileData;
+    std::unique_ptr<ospray::Tile> compositedTileData;
     std::mutex mutex;
   };
 
@@ -174,6 +177,9 @@ namespace ospray {
         Tiles will get blended with the 'over' operator in
         increasing 'BufferedTile::sortOrder' value */
       float sortOrder;
+
+      static void *operator new(size_t size) { return alignedMalloc(size); }
+      static void operator delete(void *ptr) { alignedFree(ptr); }
     };
 
     std::vector<BufferedTile *> bufferedTile;
@@ -18,20 +18,30 @@
 #include "MPILoadBalancer.h"
 #include "../fb/DistributedFrameBuffer.h"
 // ospray
+#include "ospray/common/FrameStats.h"
 #include "ospray/render/Renderer.h"
 // ospcommon
 #include "ospcommon/tasking/parallel_for.h"
-#include "ospcommon/tasking/schedule.h"
+#include "ospcommon/tasking/tasking_system_handle.h"
 #include "ospcommon/utility/getEnvVar.h"
 // std
 #include <algorithm>
+#include <fstream>
 
 namespace ospray {
   namespace mpi {
 
     using namespace mpicommon;
 
-#define MAX_TILE_SIZE 128
+    /*! hand a rendered tile to the frame buffer, accounting it (and the
+        time spent in setTile()) in the frame stats */
+    static inline void setRenderedTile(FrameBuffer *fb, Tile &tile)
+    {
+      const double start = getSysTime();
+      fb->setTile(tile);
+      addRenderCount(RC_ACCUMULATE_NS, uint64((getSysTime() - start) * 1e9));
+      addRenderCount(RC_TILES_RENDERED, 1);
+    }
 
     namespace staticLoadBalancer {
 
@@ -91,21 +101,22 @@ namespace ospray {
           const vec2i tileId(tile_x, tile_y);
           const int32 accumID = fb->accumID(tileId);
 
-          if (fb->tileError(tileId) <= renderer->errorThreshold)
+          if (fb->tileError(tileId) <= renderer->errorThreshold) {
+            addRenderCount(RC_TILES_SKIPPED, 1);
             return;
+          }
 
-#if TILE_SIZE > MAX_TILE_SIZE
-          auto tilePtr = make_unique<Tile>(tileId, fb->size, accumID);
+          auto tilePtr = make_unique<Tile>(tileId, fb->size, accumID,
+                                           fb->getTileSize());
           auto &tile   = *tilePtr;
-#else
-          Tile __aligned(64) tile(tileId, fb->size, accumID);
-#endif
 
-          tasking::parallel_for(numJobs(renderer->spp, accumID), [&](int tid) {
+          const size_t jobs = numJobs(renderer->spp, accumID,
+                                      fb->getTileSize());
+          tasking::parallel_for(jobs, [&](int tid) {
             renderer->renderTile(perFrameData, tile, tid);
           });
 
-          fb->setTile(tile);
+          setRenderedTile(fb, tile);
         });
 
         dfb->waitUntilFinished();
@@ -141,17 +152,16 @@ namespace ospray {
           const int32 accumID = fb->accumID(tileID);
           const bool tileOwner = (taskIndex % numGlobalRanks()) == globalRank();
 
-          if (dfb->tileError(tileID) <= renderer->errorThreshold)
+          if (dfb->tileError(tileID) <= renderer->errorThreshold) {
+            addRenderCount(RC_TILES_SKIPPED, 1);
             return;
+          }
 
-#if TILE_SIZE > MAX_TILE_SIZE
-          auto tilePtr = make_unique<Tile>(tileID, dfb->size, accumID);
+          auto tilePtr = make_unique<Tile>(tileID, dfb->size, accumID,
+                                           dfb->getTileSize());
           auto &tile   = *tilePtr;
-#else
-          Tile __aligned(64) tile(tileID, dfb->size, accumID);
-#endif
 
-          const int NUM_JOBS = (TILE_SIZE*TILE_SIZE)/RENDERTILE_PIXELS_PER_JOB;
+          const int NUM_JOBS = numJobs(1, accumID, dfb->getTileSize());
           tasking::parallel_for(NUM_JOBS, [&](int tIdx) {
             renderer->renderTile(perFrameData, tile, tIdx);
           });
@@ -164,7 +174,7 @@ namespace ospray {
             tile.children = 0;
           }
 
-          fb->setTile(tile);
+          setRenderedTile(fb, tile);
         });
 
         dfb->waitUntilFinished();
@@ -182,54 +192,46 @@ namespace ospray {
 
     namespace dynamicLoadBalancer {
 
-      // dynamicLoadBalancer::Master definitions ///////////////////////////////
+      // work-stealing messages, exchanged directly between workers
 
-      Master::Master(ObjectHandle handle, int _numPreAllocated)
-        : MessageHandler(handle), numPreAllocated(_numPreAllocated)
+      enum MessageType : int32
       {
-        preferredTiles.resize(worker.size);
-        workerNotified.resize(worker.size);
+        STEAL_REQUEST,
+        STEAL_GRANT,
+        DONE_STEALING
+      };
 
-        // TODO numPreAllocated should be estimated/tuned automatically
-      }
-
-      void Master::incoming(const std::shared_ptr<mpicommon::Message> &msg)
+      struct StealRequest
       {
-        const int requester = *(int*)msg->data;
-        scheduleTile(workerRankFromGlobalRank(requester));
-      }
+        int32 type;
+        int32 frameID;
+        int32 requester; //!< worker rank
+      };
 
-      void Master::scheduleTile(const int worker)
+      /*! followed by 'numTiles' TileTasks */
+      struct StealGrant
       {
-        if (workerNotified[worker])
-          return;
-
-        // choose tile from preferred queue
-        auto queue = preferredTiles.begin() + worker;
-
-        // else look for largest non-empty queue
-        if (queue->empty())
-          queue = std::max_element(preferredTiles.begin(), preferredTiles.end(),
-              [](TileVector a, TileVector b) { return a.size() < b.size(); });
-
-        TileTask task;
-        if (queue->empty()) {
-          workerNotified[worker] = true;
-          task.tilesExhausted = true;
-        } else {
-          task = queue->back();
-          queue->pop_back();
-          task.tilesExhausted = false;
-        }
-
-        auto answer = std::make_shared<mpicommon::Message>(&task, sizeof(task));
-        mpi::messaging::sendTo(globalRankFromWorkerRank(worker), myId, answer);
-      }
+        int32 type;
+        int32 frameID;
+        int32 victim;    //!< worker rank
+        int32 remaining; //!< #tiles the victim kept for itself
+        int32 numTiles;
+      };
+
+      /*! sent to all other workers once we're out of tiles and there's no
+          one left to steal from */
+      struct DoneStealing
+      {
+        int32 type;
+        int32 frameID;
+      };
 
-      void Master::generateTileTasks(DistributedFrameBuffer * const dfb
-          , const float errorThreshold
-          )
+      std::vector<TileVector>
+      generateTileTasks(DistributedFrameBuffer * const dfb,
+                        const float errorThreshold)
       {
+        std::vector<TileVector> tasks(worker.size);
+
         struct ActiveTile {
           float error;
           vec2i id;
@@ -250,15 +252,15 @@ namespace ospray {
             task.accumId = dfb->accumID(tileId);
 
             auto nr = workerRankFromGlobalRank(dfb->ownerIDFromTileID(tileNr));
-            preferredTiles[nr].push_back(task);
+            tasks[nr].push_back(task);
           }
         }
 
         if (activeTiles.empty())
-          return;
+          return tasks;
 
         // sort active tiles, highest error first
-        std::sort(activeTiles.begin(), activeTiles.end(),
+        std::stable_sort(activeTiles.begin(), activeTiles.end(),
             [](ActiveTile a, ActiveTile b) { return a.error > b.error; });
 
         // TODO: estimate variance reduction to avoid duplicating tiles that are
@@ -275,11 +277,25 @@ namespace ospray {
           task.accumId = dfb->accumID(tileId);
           const auto tileNr = tileId.y*dfb->numTiles.x + tileId.x;
           auto nr = workerRankFromGlobalRank(dfb->ownerIDFromTileID(tileNr));
-          preferredTiles[nr].push_back(task);
+          tasks[nr].push_back(task);
 
           if (++it == activeTiles.end())
             it = activeTiles.begin(); // start again from beginning
         }
+
+        return tasks;
+      }
+
+      // dynamicLoadBalancer::Master definitions ///////////////////////////////
+
+      Master::Master(ObjectHandle handle)
+        : MessageHandler(handle)
+      {
+      }
+
+      void Master::incoming(const std::shared_ptr<mpicommon::Message> &)
+      {
+        // tiles are exchanged between the workers only
       }
 
       float Master::renderFrame(Renderer *renderer
@@ -290,18 +306,13 @@ namespace ospray {
         DistributedFrameBuffer *dfb = dynamic_cast<DistributedFrameBuffer*>(fb);
         assert(dfb);
 
-        for(auto&& notified : workerNotified)
-          notified = false;
-
+        // the workers compute the same assignment, we only need the tile
+        // instance counts (synced to the workers in startNewFrame())
         generateTileTasks(dfb, renderer->errorThreshold);
 
         dfb->startNewFrame(renderer->errorThreshold);
         dfb->beginFrame();
 
-        for(int tiles = 0; tiles < numPreAllocated; tiles++)
-          for(int workerID = 0; workerID < worker.size; workerID++)
-            scheduleTile(workerID);
-
         dfb->waitUntilFinished();
 
         return dfb->endFrame(renderer->errorThreshold);
@@ -314,25 +325,41 @@ namespace ospray {
 
       // dynamicLoadBalancer::Slave definitions ////////////////////////////////
 
-      Slave::Slave(ObjectHandle handle) : MessageHandler(handle)
+      Slave::Slave(ObjectHandle handle, int _numPreAllocated)
+        : MessageHandler(handle),
+          numPreAllocated(_numPreAllocated)
       {
+        auto OSPRAY_LOADBALANCER_TIMELINE =
+            utility::getEnvVar<std::string>("OSPRAY_LOADBALANCER_TIMELINE");
+
+        if (OSPRAY_LOADBALANCER_TIMELINE) {
+          timelineFile = OSPRAY_LOADBALANCER_TIMELINE.value() + "."
+                         + std::to_string(worker.rank) + ".csv";
+          // start a fresh file with a header
+          std::ofstream out(timelineFile);
+          out << "rank,frame,event,begin,end,tiles" << std::endl;
+        }
       }
 
       void Slave::incoming(const std::shared_ptr<mpicommon::Message> &msg)
       {
-        auto task = *(TileTask*)msg->data;
-
-        mutex.lock();
-        if (task.tilesExhausted)
-          tilesAvailable = false;
-        else
-          tilesScheduled++;
-        mutex.unlock();
-
-        if (tilesAvailable)
-          tasking::schedule([&,task]{tileTask(task);});
-        else
-          cv.notify_one();
+        switch (*(int32*)msg->data) {
+        case STEAL_REQUEST:
+          handleStealRequest(*msg);
+          break;
+        case STEAL_GRANT:
+          handleStealGrant(*msg);
+          break;
+        case DONE_STEALING:
+          {
+            SCOPED_LOCK(mutex);
+            numDoneStealing[((DoneStealing*)msg->data)->frameID]++;
+          }
+          cv.notify_all();
+          break;
+        default:
+          throw std::runtime_error("#osp:mpi: unknown load balancer message");
+        }
       }
 
       float Slave::renderFrame(Renderer *_renderer
@@ -344,61 +371,238 @@ namespace ospray {
         fb = _fb;
         auto *dfb = dynamic_cast<DistributedFrameBuffer*>(fb);
 
-        tilesAvailable = true;
-        tilesScheduled = 0;
-
         dfb->startNewFrame(renderer->errorThreshold);
+
+        // needs the tile errors synced in startNewFrame()
+        auto tasks = generateTileTasks(dfb, renderer->errorThreshold);
+
+        {
+          SCOPED_LOCK(mutex);
+          frameID++;
+          tiles.assign(tasks[worker.rank].begin(), tasks[worker.rank].end());
+          knownLoad.resize(worker.size);
+          for (int i = 0; i < worker.size; ++i)
+            knownLoad[i] = tasks[i].size();
+          knownLoad[worker.rank] = 0;
+          stealPending = false;
+          victimsLeft = true;
+          timeline.clear();
+          frameStart = std::chrono::high_resolution_clock::now();
+          frameActive = true;
+        }
+
+        // other workers may start stealing from here on
         dfb->beginFrame();
 
         perFrameData = renderer->beginFrame(fb);
-        frameActive = true;
 
-        dfb->waitUntilFinished(); // swap with below?
-        { // wait for render threads to finish
-          std::unique_lock<std::mutex> lock(mutex);
-          cv.wait(lock, [&]{ return tilesScheduled == 0 && !tilesAvailable; });
-        }
-        frameActive = false;
+        do {
+          renderTiles();
+        } while (waitForStolenTiles());
 
+        waitForOthersDoneStealing();
+
+        dfb->waitUntilFinished();
         renderer->endFrame(perFrameData,channelFlags);
 
+        if (!timelineFile.empty())
+          writeTimeline();
+
         return dfb->endFrame(inf); // irrelevant return value on slave, still
                                    // call to stop maml layer
       }
 
+      void Slave::renderTiles()
+      {
+        // a few tiles in flight at once, each rendered in parallel itself
+        tasking::parallel_for(tasking::numTaskingThreads(), [&](int) {
+          TileTask task;
+          while (nextTile(task))
+            renderTile(task);
+        });
+      }
 
-      void Slave::tileTask(const TileTask &task)
+      bool Slave::nextTile(TileTask &task)
       {
-#if TILE_SIZE > MAX_TILE_SIZE
-        auto tilePtr = make_unique<Tile>(task.tileId, fb->size, task.accumId);
-        auto &tile   = *tilePtr;
-#else
-        Tile __aligned(64) tile(task.tileId, fb->size, task.accumId);
-#endif
+        SCOPED_LOCK(mutex);
+        if (tiles.empty())
+          return false;
 
-        while (!frameActive) PRINT(frameActive); // XXX busy wait for valid perFrameData
+        task = tiles.front();
+        tiles.pop_front();
 
-        tasking::parallel_for(numJobs(renderer->spp, task.accumId), [&](int tid) {
+        // ask for more early, to hide the latency of the steal
+        if (tiles.size() <= size_t(numPreAllocated) && !stealPending
+            && victimsLeft) {
+          requestTiles();
+        }
+
+        return true;
+      }
+
+      void Slave::renderTile(const TileTask &task)
+      {
+        const double begin = frameTime();
+
+        auto tilePtr = make_unique<Tile>(task.tileId, fb->size, task.accumId,
+                                         fb->getTileSize());
+        auto &tile   = *tilePtr;
+
+        const size_t jobs = numJobs(renderer->spp, task.accumId,
+                                    fb->getTileSize());
+        tasking::parallel_for(jobs, [&](int tid) {
           renderer->renderTile(perFrameData, tile, tid);
         });
 
-        if (tilesAvailable)
-          requestTile(); // XXX here or after setTile?
+        setRenderedTile(fb, tile);
 
-        fb->setTile(tile);
+        if (!timelineFile.empty()) {
+          SCOPED_LOCK(mutex);
+          timeline.push_back({TimelineEvent::RENDER_TILE,
+                              begin, frameTime(), 1});
+        }
+      }
 
+      bool Slave::requestTiles()
+      {
+        // the most loaded worker we know of, going around the ring starting
+        // at our neighbour to spread the (initially equal) requests
+        int victim  = -1;
+        int maxLoad = 0;
+        for (int i = 1; i < worker.size; ++i) {
+          const int candidate = (worker.rank + i) % worker.size;
+          if (knownLoad[candidate] > maxLoad) {
+            victim  = candidate;
+            maxLoad = knownLoad[candidate];
+          }
+        }
 
-        SCOPED_LOCK(mutex);
-        if (--tilesScheduled == 0)
-          cv.notify_one();
+        if (victim < 0) {
+          victimsLeft = false;
+          return false;
+        }
+
+        StealRequest request{STEAL_REQUEST, frameID, worker.rank};
+        auto msg = std::make_shared<mpicommon::Message>(&request,
+                                                        sizeof(request));
+        mpi::messaging::sendTo(globalRankFromWorkerRank(victim), myId, msg);
+        stealPending = true;
+        return true;
+      }
+
+      bool Slave::waitForStolenTiles()
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        const double begin = frameTime();
+
+        while (tiles.empty()) {
+          if (!stealPending && !requestTiles())
+            break;
+          cv.wait(lock, [&]{ return !stealPending; });
+        }
+
+        if (!timelineFile.empty()) {
+          timeline.push_back({TimelineEvent::STEAL_WAIT,
+                              begin, frameTime(), int32(tiles.size())});
+        }
+
+        return !tiles.empty();
+      }
+
+      void Slave::handleStealRequest(const mpicommon::Message &msg)
+      {
+        const auto &request = *(const StealRequest*)msg.data;
+
+        std::vector<TileTask> granted;
+        int32 remaining = 0;
+        {
+          SCOPED_LOCK(mutex);
+          // requests from another frame (the requester is ahead or behind
+          // of us) get an empty grant, still answer them
+          if (frameActive && request.frameID == frameID) {
+            const size_t numGranted = tiles.size() / 2;
+            granted.assign(tiles.end() - numGranted, tiles.end());
+            tiles.erase(tiles.end() - numGranted, tiles.end());
+            remaining = tiles.size();
+            knownLoad[request.requester] = 0;
+          }
+        }
+
+        const size_t bytes = sizeof(StealGrant)
+                             + granted.size() * sizeof(TileTask);
+        auto answer = std::make_shared<mpicommon::Message>(bytes);
+        auto &grant = *(StealGrant*)answer->data;
+        grant.type      = STEAL_GRANT;
+        grant.frameID   = request.frameID;
+        grant.victim    = worker.rank;
+        grant.remaining = remaining;
+        grant.numTiles  = granted.size();
+        std::copy(granted.begin(), granted.end(),
+                  (TileTask*)(answer->data + sizeof(StealGrant)));
+
+        mpi::messaging::sendTo(globalRankFromWorkerRank(request.requester),
+                               myId, answer);
+      }
+
+      void Slave::handleStealGrant(const mpicommon::Message &msg)
+      {
+        const auto &grant = *(const StealGrant*)msg.data;
+        const auto *granted = (const TileTask*)(msg.data + sizeof(StealGrant));
+
+        {
+          SCOPED_LOCK(mutex);
+          // a grant for an old frame is always empty: the frame could not
+          // have finished with granted tiles still unrendered
+          if (grant.frameID != frameID)
+            return;
+
+          knownLoad[grant.victim] = grant.remaining;
+          tiles.insert(tiles.end(), granted, granted + grant.numTiles);
+          stealPending = false;
+        }
+
+        cv.notify_all();
       }
 
-      void Slave::requestTile()
+      void Slave::waitForOthersDoneStealing()
       {
-        int requester = mpi::globalRank();
-        auto msg =
-            std::make_shared<mpicommon::Message>(&requester, sizeof(requester));
-        mpi::messaging::sendTo(mpi::masterRank(), myId, msg);
+        DoneStealing done{DONE_STEALING, frameID};
+        for (int i = 0; i < worker.size; ++i) {
+          if (i == worker.rank)
+            continue;
+          auto msg = std::make_shared<mpicommon::Message>(&done, sizeof(done));
+          mpi::messaging::sendTo(globalRankFromWorkerRank(i), myId, msg);
+        }
+
+        // keep answering steal requests until nobody will send us any more,
+        // async messaging gets disabled at the end of the frame
+        std::unique_lock<std::mutex> lock(mutex);
+        const double begin = frameTime();
+        cv.wait(lock, [&]{
+          return numDoneStealing[frameID] == worker.size - 1;
+        });
+        numDoneStealing.erase(frameID);
+        frameActive = false;
+
+        if (!timelineFile.empty())
+          timeline.push_back({TimelineEvent::DONE_WAIT, begin, frameTime(), 0});
+      }
+
+      double Slave::frameTime() const
+      {
+        using namespace std::chrono;
+        return duration<double>(high_resolution_clock::now()
+                                - frameStart).count();
+      }
+
+      void Slave::writeTimeline()
+      {
+        static const char *eventName[] = {"render", "steal", "done"};
+        std::ofstream out(timelineFile, std::ios::app);
+        for (const auto &e : timeline) {
+          out << worker.rank << "," << frameID << ","
+              << eventName[e.type] << "," << e.begin << "," << e.end << "," << e.numTiles << "\n";
+        }
       }
 
       std::string Slave::toString() const
@@ -22,7 +22,11 @@
 // ours
 #include "render/LoadBalancer.h"
 #include "mpi/fb/DistributedFrameBuffer.h"
+// std
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <map>
 
 namespace ospray {
   namespace mpi {
@@ -70,52 +74,60 @@ namespace ospray {
     }// ::ospray::mpi::staticLoadBalancer
 
     namespace dynamicLoadBalancer {
-      /*! \brief the 'master' in a tile-based master-slave load balancer
-
-          The dynamic load balancer assigns tiles asynchronously, favouring the
-          same tiles as the DistributedFramebuffer (i.e. round-robin pattern,
-          each client 'i' renderss tiles with 'tileID%numWorkers==i') to avoid
-          transferring a computed tile for accumulation
+      /*! \brief decentralized, work-stealing tile-based load balancer
+
+          Every worker starts with a static partition of the frame's tile
+          tasks, favouring the same tiles as the DistributedFramebuffer
+          (i.e. round-robin pattern, each client 'i' renders tiles with
+          'tileID%numWorkers==i') to avoid transferring a computed tile for
+          accumulation. The partition is computed redundantly on every rank,
+          so no tile assignment passes through the master. Workers running
+          low on tiles steal a batch (half of the remaining tiles) from the
+          worker they believe to be most loaded, peer-to-peer.
       */
 
       struct TileTask {
         vec2i tileId;
         int32 accumId;
-        bool tilesExhausted; // no more tiles available
       };
 
+      using TileVector = std::vector<TileTask>;
+
+      /*! generate this frame's tile tasks for all workers (indexed by worker
+          rank), tiles with higher error are duplicated to make use of
+          otherwise idle workers. Assigns the tasks' accumIDs, so it has to
+          be called exactly once per frame on every rank (including the
+          master) to keep the frame buffer's accumIDs in sync */
+      std::vector<TileVector>
+      generateTileTasks(DistributedFrameBuffer * const dfb,
+                        const float errorThreshold);
+
+      /*! \brief the 'master' of the dynamic load balancer: does not render,
+          only keeps track of the (replicated) tile assignment */
       class Master : public messaging::MessageHandler,
                      public TiledLoadBalancer
       {
       public:
-        Master(ObjectHandle handle, int numPreAllocated = 4);
+        Master(ObjectHandle handle);
         void incoming(const std::shared_ptr<mpicommon::Message> &) override;
         float renderFrame(Renderer *tiledRenderer
             , FrameBuffer *fb
             , const uint32 channelFlags
             ) override;
         std::string toString() const override;
-
-      private:
-        void scheduleTile(const int worker);
-        void generateTileTasks(DistributedFrameBuffer * const dfb
-            , const float errorThreshold
-            );
-
-        typedef std::vector<TileTask> TileVector;
-        std::vector<TileVector> preferredTiles; // per worker default queue
-        std::vector<bool> workerNotified; // worker knows we're done?
-        int numPreAllocated{4};
       };
 
-      /*! \brief the 'slave' in a tile-based master-slave load balancer
+      /*! \brief a worker in the work-stealing load balancer
 
+          Per-frame busy/idle timelines can be exported as CSV by setting
+          OSPRAY_LOADBALANCER_TIMELINE to a file name prefix, each worker
+          appends its events to '<prefix>.<workerRank>.csv'
       */
       class Slave : public messaging::MessageHandler,
                     public TiledLoadBalancer
       {
       public:
-        Slave(ObjectHandle handle);
+        Slave(ObjectHandle handle, int numPreAllocated = 4);
         void incoming(const std::shared_ptr<mpicommon::Message> &) override;
         float renderFrame(Renderer *tiledRenderer
             , FrameBuffer *fb
@@ -124,19 +136,49 @@ namespace ospray {
         std::string toString() const override;
 
       private:
-        void tileTask(const TileTask &task);
-        void requestTile();
+        struct TimelineEvent {
+          enum Type { RENDER_TILE, STEAL_WAIT, DONE_WAIT } type;
+          double begin; // seconds since the start of the frame
+          double end;
+          int32 numTiles; // tiles rendered or received
+        };
+
+        void renderTiles();
+        bool nextTile(TileTask &task);
+        void renderTile(const TileTask &task);
+        //! pick a victim and send it a steal request, mutex must be held
+        bool requestTiles();
+        //! wait for the pending steal, false if there's nobody left
+        bool waitForStolenTiles();
+        void handleStealRequest(const mpicommon::Message &msg);
+        void handleStealGrant(const mpicommon::Message &msg);
+        //! announce we're done, then serve requests until all others are
+        void waitForOthersDoneStealing();
+        double frameTime() const;
+        void writeTimeline();
 
         // "local" state
-        Renderer *renderer;
-        FrameBuffer *fb;
-        void *perFrameData;
+        Renderer *renderer{nullptr};
+        FrameBuffer *fb{nullptr};
+        void *perFrameData{nullptr};
+
+        // request more tiles once we're down to this many
+        int numPreAllocated{4};
 
         std::mutex mutex;
         std::condition_variable cv;
-        int tilesScheduled;
-        bool tilesAvailable;
-        bool frameActive;
+        std::deque<TileTask> tiles; // own tiles from front, steal from back
+        std::vector<int> knownLoad; // last known #tiles per worker
+        int32 frameID{0};
+        bool frameActive{false};
+        bool stealPending{false};
+        bool victimsLeft{true};
+        // #workers done stealing, by frame (others may be one frame ahead)
+        std::map<int32, int> numDoneStealing;
+
+        std::chrono::high_resolution_clock::time_point frameStart;
+        std::vector<TimelineEvent> timeline;
+        std::string timelineFile;
       };
 
     }// ::ospray::mpi::dynamicLoadBalancer
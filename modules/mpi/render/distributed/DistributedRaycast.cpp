@@ -17,13 +17,18 @@
 // ospcommon
 #include "ospcommon/tasking/parallel_for.h"
 #include "common/Data.h"
+#include "common/FrameStats.h"
 // ospray
+#include "camera/Camera.h"
 #include "DistributedRaycast.h"
 #include "../../common/DistributedModel.h"
 #include "../MPILoadBalancer.h"
 #include "../../fb/DistributedFrameBuffer.h"
 // ispc exports
 #include "DistributedRaycast_ispc.h"
+// stl
+#include <atomic>
+#include <vector>
 
 namespace ospray {
   namespace mpi {
@@ -31,11 +36,33 @@ namespace ospray {
     struct RegionInfo
     {
       int currentRegion;
-      bool *regionVisible;
 
-      RegionInfo() : currentRegion(0), regionVisible(nullptr) {}
+      RegionInfo() : currentRegion(0) {}
     };
 
+    /*! conservative range of tiles (inclusive) 'region' projects to, with
+        a pixel of slack for pixel filters and jittered samples */
+    static box2i projectRegion(const Camera *camera,
+                               const box3f &region,
+                               const vec2i &fbSize,
+                               const vec2i &tileSize,
+                               const vec2i &numTiles)
+    {
+      const box2f screen = camera ? camera->projectBox(region)
+                                  : box2f(vec2f(0.f), vec2f(1.f));
+      if (screen.empty())
+        return box2i(empty);
+
+      const vec2f lower = screen.lower * vec2f(fbSize) - vec2f(1.f);
+      const vec2f upper = screen.upper * vec2f(fbSize) + vec2f(1.f);
+      const vec2i lowerTile(std::floor(std::max(lower.x, 0.f) / tileSize.x),
+                            std::floor(std::max(lower.y, 0.f) / tileSize.y));
+      const vec2i upperTile(
+          std::floor(std::min(upper.x, float(fbSize.x - 1)) / tileSize.x),
+          std::floor(std::min(upper.y, float(fbSize.y - 1)) / tileSize.y));
+      return box2i(lowerTile, min(upperTile, numTiles - vec2i(1)));
+    }
+
     // DistributedRaycastRenderer definitions /////////////////////////////////
 
     DistributedRaycastRenderer::DistributedRaycastRenderer()
@@ -57,6 +84,8 @@ namespace ospray {
     {
       using namespace mpicommon;
 
+      FrameStatsScope stats(fb->frameStats);
+
       auto *dfb = dynamic_cast<DistributedFrameBuffer *>(fb);
       dfb->setFrameMode(DistributedFrameBuffer::ALPHA_BLEND);
       dfb->startNewFrame(errorThreshold);
@@ -69,51 +98,74 @@ namespace ospray {
           (ispc::box3f*)distribModel->othersRegions.data(),
           distribModel->othersRegions.size());
 
-      const size_t numRegions = distribModel->myRegions.size()
+      const size_t numMyRegions = distribModel->myRegions.size();
+      const size_t numRegions = numMyRegions
         + distribModel->othersRegions.size();
 
+      // Every rank projects every region with the same camera, so the
+      // tile owners know up front how many regions will send them a tile,
+      // and nobody renders tiles their regions don't touch.
+      const Camera *camera =
+        dynamic_cast<const Camera*>(getParamObject("camera"));
+      const vec2i numTiles = fb->getNumTiles();
+      std::vector<box2i> regionTiles;
+      regionTiles.reserve(numRegions);
+      for (const auto &r : distribModel->myRegions)
+        regionTiles.push_back(projectRegion(camera, r, fb->size,
+                                            fb->getTileSize(), numTiles));
+      for (const auto &r : distribModel->othersRegions)
+        regionTiles.push_back(projectRegion(camera, r, fb->size,
+                                            fb->getTileSize(), numTiles));
+
       auto *perFrameData = beginFrame(dfb);
       // This renderer doesn't use per frame data, since we sneak in some tile
       // info in this pointer.
       assert(!perFrameData);
 
+      std::atomic<size_t> activeTiles(0), renderedRegionTiles(0),
+                          idleTiles(0);
+
       tasking::parallel_for(dfb->getTotalTiles(), [&](int taskIndex) {
-        const size_t numTiles_x = fb->getNumTiles().x;
+        const size_t numTiles_x = numTiles.x;
         const size_t tile_y = taskIndex / numTiles_x;
         const size_t tile_x = taskIndex - tile_y*numTiles_x;
         const vec2i tileID(tile_x, tile_y);
-        const int32 accumID = fb->accumID(tileID);
         const bool tileOwner = (taskIndex % numGlobalRanks()) == globalRank();
 
         if (dfb->tileError(tileID) <= errorThreshold) {
+          addRenderCount(RC_TILES_SKIPPED, 1);
           return;
         }
+        ++activeTiles;
+        // Advance the accumID on idle ranks too, all ranks have to jitter
+        // their samples the same way for the composited tiles to line up
+        const int32 accumID = fb->accumID(tileID);
 
         // The first 0..myRegions.size() - 1 entries are for my regions,
         // the following entries are for other nodes regions
-        RegionInfo regionInfo;
-        regionInfo.regionVisible = STACK_BUFFER(bool, numRegions);
-        std::fill(regionInfo.regionVisible, regionInfo.regionVisible + numRegions, false);
-
-        Tile __aligned(64) tile(tileID, dfb->size, accumID);
-
-        // We use the task of rendering the first region to also fill out the block visiblility list
-        const int NUM_JOBS = (TILE_SIZE * TILE_SIZE) / RENDERTILE_PIXELS_PER_JOB;
-        tasking::parallel_for(NUM_JOBS, [&](int tIdx) {
-          renderTile(&regionInfo, tile, tIdx);
-        });
+        bool *regionVisible = STACK_BUFFER(bool, numRegions);
+        size_t numVisible = 0;
+        bool anyMineVisible = false;
+        for (size_t i = 0; i < numRegions; ++i) {
+          regionVisible[i] = regionTiles[i].contains(tileID);
+          numVisible += regionVisible[i];
+          anyMineVisible |= i < numMyRegions && regionVisible[i];
+        }
 
-        if (regionInfo.regionVisible[0]) {
-          tile.generation = 1;
-          tile.children = 0;
-          fb->setTile(tile);
+        if (!tileOwner && !anyMineVisible) {
+          ++idleTiles;
+          return;
         }
 
+        auto tilePtr = make_unique<Tile>(tileID, dfb->size, accumID,
+                                         dfb->getTileSize());
+        auto &tile   = *tilePtr;
+
         // If we own the tile send the background color and the count of children for the
         // number of regions projecting to it that will be sent.
         if (tileOwner) {
           tile.generation = 0;
-          tile.children = std::count(regionInfo.regionVisible, regionInfo.regionVisible + numRegions, true);
+          tile.children = numVisible;
           std::fill(tile.r, tile.r + TILE_SIZE * TILE_SIZE, bgColor.x);
           std::fill(tile.g, tile.g + TILE_SIZE * TILE_SIZE, bgColor.y);
           std::fill(tile.b, tile.b + TILE_SIZE * TILE_SIZE, bgColor.z);
@@ -122,21 +174,40 @@ namespace ospray {
           fb->setTile(tile);
         }
 
-        // Render the rest of our regions that project to this tile and ship them off
+        // Render our regions that project to this tile and ship them off
+        const int NUM_JOBS = TiledLoadBalancer::numJobs(1, accumID,
+                                                        dfb->getTileSize());
+        RegionInfo regionInfo;
         tile.generation = 1;
         tile.children = 0;
-        for (size_t bid = 1; bid < distribModel->myRegions.size(); ++bid) {
-          if (!regionInfo.regionVisible[bid]) {
+        for (size_t bid = 0; bid < numMyRegions; ++bid) {
+          if (!regionVisible[bid]) {
             continue;
           }
           regionInfo.currentRegion = bid;
           tasking::parallel_for(NUM_JOBS, [&](int tIdx) {
             renderTile(&regionInfo, tile, tIdx);
           });
+          const double start = getSysTime();
           fb->setTile(tile);
+          addRenderCount(RC_ACCUMULATE_NS,
+                         uint64((getSysTime() - start) * 1e9));
+          addRenderCount(RC_TILES_RENDERED, 1);
+          ++renderedRegionTiles;
         }
       });
 
+      cullingStats.activeTiles = activeTiles;
+      cullingStats.idleTiles = idleTiles;
+      cullingStats.renderedRegionTiles = renderedRegionTiles;
+      cullingStats.culledRegionTiles =
+        activeTiles * numMyRegions - renderedRegionTiles;
+      postStatusMsg(2) << "#osp.mpi: rank " << globalRank() << " rendered "
+        << cullingStats.renderedRegionTiles << " region tiles, culled "
+        << cullingStats.culledRegionTiles << " ("
+        << cullingStats.idleTiles << " of " << cullingStats.activeTiles
+        << " tiles not touched at all)";
+
       dfb->waitUntilFinished();
       endFrame(nullptr, channelFlags);
 
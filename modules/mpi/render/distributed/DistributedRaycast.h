@@ -43,6 +43,22 @@ namespace ospray {
       float renderFrame(FrameBuffer *fb, const uint32 fbChannelFlags) override;
 
       std::string toString() const override;
+
+      /*! per-frame statistics of the screen-space region culling, for the
+          last frame this rank rendered */
+      struct CullingStats
+      {
+        //! tiles still being refined this frame
+        size_t activeTiles {0};
+        //! active tiles this rank neither owns nor has regions in
+        size_t idleTiles {0};
+        //! (tile, local region) pairs rendered
+        size_t renderedRegionTiles {0};
+        //! (tile, local region) pairs skipped as the region isn't on the tile
+        size_t culledRegionTiles {0};
+      };
+
+      CullingStats cullingStats;
     };
 
   } // ::ospray::mpi
@@ -0,0 +1,165 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+/*! \file TestLoadBalancerScaling.cpp renders a deliberately unbalanced
+    scene (all geometry in one corner of the image) on the mpi_offload
+    device, once with the static and once with the dynamic (work
+    stealing) load balancer, and reports the average frame time of each.
+    Run it with increasing worker counts to get the scaling, e.g.
+
+    for n in 1 2 4 8; do
+      mpirun -n 1 ./ospLoadBalancerScaling --osp:mpi : \
+             -n $n ./ospray_mpi_worker
+    done
+
+    Set OSPRAY_LOADBALANCER_TIMELINE=<prefix> to also get the workers'
+    busy/idle timelines of the dynamic runs.
+*/
+
+// ospray
+#include "ospray/ospray.h"
+// mpiCommon
+#include "mpiCommon/MPICommon.h"
+// stl
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ospLoadBalancerScaling {
+
+  int numSpheres = 1000000;
+  int numFrames  = 20;
+  int aoSamples  = 4;
+  osp::vec2i imgSize{2048, 1024};
+
+  void parseCommandLine(int ac, const char **av)
+  {
+    for (int i = 1; i < ac; ++i) {
+      const std::string arg = av[i];
+      if (arg == "-s" || arg == "--spheres") {
+        numSpheres = std::atoi(av[++i]);
+      } else if (arg == "-f" || arg == "--frames") {
+        numFrames = std::atoi(av[++i]);
+      } else if (arg == "-ao" || arg == "--ao-samples") {
+        aoSamples = std::atoi(av[++i]);
+      } else if (arg == "-w" || arg == "--width") {
+        imgSize.x = std::atoi(av[++i]);
+      } else if (arg == "-h" || arg == "--height") {
+        imgSize.y = std::atoi(av[++i]);
+      }
+    }
+  }
+
+  /*! a dense cloud of small spheres that only covers the upper left part
+      of the image, so the tiles' cost varies a lot */
+  OSPModel makeScene()
+  {
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> pos(-1.f, 1.f);
+
+    std::vector<float> spheres(4 * numSpheres);
+    for (int i = 0; i < numSpheres; ++i) {
+      spheres[4*i+0] = -2.f + 0.8f * pos(rng);
+      spheres[4*i+1] =  1.f + 0.5f * pos(rng);
+      spheres[4*i+2] =  0.8f * pos(rng);
+      spheres[4*i+3] =  0.f;
+    }
+
+    OSPData data = ospNewData(spheres.size(), OSP_FLOAT, spheres.data());
+    OSPGeometry geom = ospNewGeometry("spheres");
+    ospSetData(geom, "spheres", data);
+    ospSet1f(geom, "radius", 0.01f);
+    ospSet1i(geom, "bytes_per_sphere", 4*sizeof(float));
+    ospCommit(geom);
+
+    OSPModel model = ospNewModel();
+    ospAddGeometry(model, geom);
+    ospCommit(model);
+
+    ospRelease(data);
+    ospRelease(geom);
+
+    return model;
+  }
+
+  double averageFrameTime(bool dynamicLoadBalancer,
+                          OSPRenderer renderer,
+                          OSPFrameBuffer fb)
+  {
+    OSPDevice device = ospGetCurrentDevice();
+    ospDeviceSet1i(device, "dynamicLoadBalancer", dynamicLoadBalancer);
+    ospDeviceCommit(device);
+
+    // warm up (and build the BVH on the workers)
+    ospRenderFrame(fb, renderer, OSP_FB_COLOR);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < numFrames; ++i)
+      ospRenderFrame(fb, renderer, OSP_FB_COLOR);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration<double>(end - start).count() / numFrames;
+  }
+
+  int main(int ac, const char **av)
+  {
+    ospInit(&ac, av);
+    parseCommandLine(ac, av);
+
+    OSPModel model = makeScene();
+
+    OSPCamera camera = ospNewCamera("perspective");
+    ospSet3f(camera, "pos", 0.f, 0.f, 5.f);
+    ospSet3f(camera, "dir", 0.f, 0.f, -1.f);
+    ospSet3f(camera, "up", 0.f, 1.f, 0.f);
+    ospSet1f(camera, "aspect", imgSize.x / float(imgSize.y));
+    ospCommit(camera);
+
+    OSPRenderer renderer = ospNewRenderer("scivis");
+    ospSetObject(renderer, "model", model);
+    ospSetObject(renderer, "camera", camera);
+    ospSet1i(renderer, "aoSamples", aoSamples);
+    ospCommit(renderer);
+
+    OSPFrameBuffer fb = ospNewFrameBuffer(imgSize, OSP_FB_SRGBA, OSP_FB_COLOR);
+
+    const double staticTime  = averageFrameTime(false, renderer, fb);
+    const double dynamicTime = averageFrameTime(true, renderer, fb);
+
+    std::cout << "#osp.mpi: " << mpicommon::numWorkers() << " workers, "
+              << imgSize.x << "x" << imgSize.y << " pixels, "
+              << numFrames << " frames\n"
+              << "  static  : " << staticTime * 1000.0 << " ms/frame\n"
+              << "  dynamic : " << dynamicTime * 1000.0 << " ms/frame ("
+              << staticTime / dynamicTime << "x)" << std::endl;
+
+    ospFreeFrameBuffer(fb);
+    ospRelease(renderer);
+    ospRelease(camera);
+    ospRelease(model);
+
+    return 0;
+  }
+
+} // ::ospLoadBalancerScaling
+
+int main(int ac, const char **av)
+{
+  return ospLoadBalancerScaling::main(ac, av);
+}
@@ -0,0 +1,131 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file TestOffloadApiRate.cpp measures how many (small) API calls per
+    second the mpi_offload device sustains when building a scene of
+    many objects, issuing the calls one by one vs. recording them into
+    a command buffer (ospBeginCommandBuffer/ospEndCommandBuffer).
+
+    run e.g. as
+    'mpirun -n 1 ./ospOffloadApiRate --osp:mpi : -n 4 ./ospray_mpi_worker'
+*/
+
+// ospray
+#include "ospray/ospray.h"
+// stl
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace ospOffloadApiRate {
+
+  int numObjects = 100000;
+
+  void parseCommandLine(int ac, const char **av)
+  {
+    for (int i = 1; i < ac; ++i) {
+      const std::string arg = av[i];
+      if (arg == "-n" || arg == "--num-objects")
+        numObjects = std::atoi(av[++i]);
+    }
+  }
+
+  /*! build a model of 'numObjects' single-sphere geometries, and return
+      the number of API calls that took */
+  size_t buildScene(OSPModel model)
+  {
+    size_t numCalls = 0;
+    float sphere[4] = {0.f, 0.f, 0.f, 0.f};
+
+    for (int i = 0; i < numObjects; ++i) {
+      sphere[0] = float(i);
+      OSPData data = ospNewData(1, OSP_FLOAT4, sphere);
+      OSPGeometry geom = ospNewGeometry("spheres");
+      ospSetData(geom, "spheres", data);
+      ospSet1f(geom, "radius", 0.5f);
+      ospSet1i(geom, "bytes_per_sphere", 4*sizeof(float));
+      ospCommit(geom);
+      ospAddGeometry(model, geom);
+      ospRelease(data);
+      ospRelease(geom);
+      numCalls += 9;
+    }
+
+    return numCalls;
+  }
+
+  /*! time building a scene, including the time until the workers are
+      done with it (rendering a frame syncs with them) */
+  double timeSceneBuild(bool useCommandBuffer, size_t &numCalls)
+  {
+    OSPRenderer renderer = ospNewRenderer("raycast");
+    OSPFrameBuffer fb = ospNewFrameBuffer(osp::vec2i{8, 8}, OSP_FB_SRGBA,
+                                          OSP_FB_COLOR);
+    OSPCamera camera = ospNewCamera("perspective");
+    ospCommit(camera);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (useCommandBuffer)
+      ospBeginCommandBuffer();
+
+    OSPModel model = ospNewModel();
+    numCalls = buildScene(model) + 2;
+    ospCommit(model);
+
+    if (useCommandBuffer)
+      ospEndCommandBuffer();
+
+    ospSetObject(renderer, "model", model);
+    ospSetObject(renderer, "camera", camera);
+    ospCommit(renderer);
+    ospRenderFrame(fb, renderer, OSP_FB_COLOR);
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    ospRelease(model);
+    ospRelease(renderer);
+    ospRelease(camera);
+    ospFreeFrameBuffer(fb);
+
+    return std::chrono::duration<double>(end - start).count();
+  }
+
+  int main(int ac, const char **av)
+  {
+    ospInit(&ac, av);
+    parseCommandLine(ac, av);
+
+    size_t numCalls = 0;
+    const double direct = timeSceneBuild(false, numCalls);
+    const double batched = timeSceneBuild(true, numCalls);
+
+    std::cout << "#osp.mpi: built scene of " << numObjects << " objects ("
+              << numCalls << " API calls)\n"
+              << "  direct         : " << direct << "s, "
+              << numCalls / direct << " calls/s\n"
+              << "  command buffer : " << batched << "s, "
+              << numCalls / batched << " calls/s" << std::endl;
+
+    return 0;
+  }
+
+} // ::ospOffloadApiRate
+
+int main(int ac, const char **av)
+{
+  return ospOffloadApiRate::main(ac, av);
+}
@@ -0,0 +1,164 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file TestOffloadThroughput.cpp measures bulk data throughput from
+    the master to all workers over the same fabric/stream setup the
+    mpi_offload device uses (master talks to the workers through an
+    intercommunicator, workers read data straight into their final
+    buffers).
+
+    run e.g. as 'mpirun -n 9 ./ospOffloadThroughput --size 4096'
+*/
+
+// ospcommon
+#include "ospcommon/malloc.h"
+#include "ospcommon/networking/BufferedDataStreaming.h"
+// mpiCommon
+#include "mpiCommon/MPIBcastFabric.h"
+// stl
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace ospOffloadThroughput {
+
+  using namespace ospcommon;
+  using namespace mpicommon;
+
+  size_t numMegaBytes   = 1024;
+  int    numIterations  = 5;
+  size_t chunkMegaBytes = 64;
+  int    chunksInFlight = 4;
+
+  void parseCommandLine(int ac, const char **av)
+  {
+    for (int i = 1; i < ac; ++i) {
+      const std::string arg = av[i];
+      if (arg == "-s" || arg == "--size") {
+        numMegaBytes = std::atol(av[++i]);
+      } else if (arg == "-i" || arg == "--iterations") {
+        numIterations = std::atoi(av[++i]);
+      } else if (arg == "-c" || arg == "--chunk-size") {
+        chunkMegaBytes = std::atol(av[++i]);
+      } else if (arg == "-f" || arg == "--chunks-in-flight") {
+        chunksInFlight = std::atoi(av[++i]);
+      }
+    }
+  }
+
+  inline byte_t pattern(size_t i)
+  {
+    return byte_t((i * 2654435761u) >> 24);
+  }
+
+  int main(int ac, const char **av)
+  {
+    parseCommandLine(ac, av);
+
+    mpicommon::init(&ac, av);
+
+    if (world.size < 2) {
+      std::cerr << "need at least two ranks (one master, N workers)"
+                << std::endl;
+      MPI_Finalize();
+      return 1;
+    }
+
+    // same topology as the offload device: rank 0 is the master,
+    // everybody else is a worker, connected by an intercommunicator
+    const bool isMaster = world.rank == 0;
+    MPI_Comm localComm, interComm;
+    MPI_CALL(Comm_split(world.comm, isMaster ? 0 : 1, world.rank,
+                        &localComm));
+    MPI_CALL(Intercomm_create(localComm, 0, world.comm, isMaster ? 1 : 0,
+                              1, &interComm));
+    Group remote(interComm);
+
+    MPIBcastFabric fabric(remote, MPI_ROOT, 0);
+    fabric.chunkSize         = chunkMegaBytes * 1024 * 1024;
+    fabric.maxChunksInFlight = chunksInFlight;
+
+    const size_t numBytes = numMegaBytes * 1024 * 1024;
+    byte_t *data = (byte_t*)alignedMalloc(numBytes);
+    if (isMaster) {
+      for (size_t i = 0; i < numBytes; ++i)
+        data[i] = pattern(i);
+    }
+
+    double totalSeconds = 0.0;
+    size_t numErrors = 0;
+
+    for (int it = 0; it < numIterations; ++it) {
+      world.barrier();
+      auto start = std::chrono::high_resolution_clock::now();
+
+      if (isMaster) {
+        networking::BufferedWriteStream stream(fabric);
+        stream << numBytes;
+        stream.write(data, numBytes);
+        stream.flush();
+      } else {
+        networking::BufferedReadStream stream(fabric);
+        size_t incoming = 0;
+        stream >> incoming;
+        stream.read(data, incoming);
+      }
+
+      // the transfer is only done once every worker has all the data
+      world.barrier();
+      auto end = std::chrono::high_resolution_clock::now();
+      totalSeconds += std::chrono::duration<double>(end - start).count();
+
+      if (!isMaster) {
+        for (size_t i = 0; i < numBytes; i += 4093)
+          numErrors += data[i] != pattern(i);
+        std::fill(data, data + numBytes, byte_t(0));
+      }
+    }
+
+    size_t totalErrors = 0;
+    MPI_CALL(Reduce(&numErrors, &totalErrors, 1, MPI_UNSIGNED_LONG, MPI_SUM,
+                    0, world.comm));
+
+    if (isMaster) {
+      const double gb = double(numBytes) * numIterations / (1024.0*1024*1024);
+      std::cout << "#osp.mpi: sent " << numMegaBytes << "MB to "
+                << world.size - 1 << " workers " << numIterations
+                << " times (chunk size " << chunkMegaBytes << "MB, "
+                << chunksInFlight << " in flight)\n"
+                << "  avg time/transfer : "
+                << totalSeconds / numIterations << "s\n"
+                << "  throughput        : "
+                << gb / totalSeconds << " GB/s (per worker)\n"
+                << "  aggregate         : "
+                << gb * (world.size - 1) / totalSeconds << " GB/s\n"
+                << "  errors            : " << totalErrors << std::endl;
+    }
+
+    alignedFree(data);
+    MPI_Comm_free(&interComm);
+    MPI_Comm_free(&localComm);
+    MPI_Finalize();
+
+    return totalErrors == 0 ? 0 : 1;
+  }
+
+} // ::ospOffloadThroughput
+
+int main(int ac, const char **av)
+{
+  return ospOffloadThroughput::main(ac, av);
+}
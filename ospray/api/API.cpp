@@ -376,6 +376,20 @@ OSPRAY_CATCH_BEGIN
 }
 OSPRAY_CATCH_END(nullptr)
 
+extern "C" OSPData ospNewSharedData(size_t nitems, OSPDataType format,
+                                    const void *sharedData,
+                                    OSPDataDeleter deleter, void *userData)
+OSPRAY_CATCH_BEGIN
+{
+  ASSERT_DEVICE();
+  Assert(sharedData != nullptr && "invalid shared data in ospNewSharedData");
+  OSPData data = currentDevice().newSharedData(nitems, format,
+                                               (void*)sharedData,
+                                               deleter, userData);
+  return data;
+}
+OSPRAY_CATCH_END(nullptr)
+
 extern "C" void ospSetData(OSPObject object, const char *bufName, OSPData data)
 OSPRAY_CATCH_BEGIN
 {
@@ -550,6 +564,15 @@ OSPRAY_CATCH_BEGIN
 }
 OSPRAY_CATCH_END(inf)
 
+extern "C" void ospGetFrameStats(OSPFrameBuffer fb, OSPFrameStats *stats)
+OSPRAY_CATCH_BEGIN
+{
+  ASSERT_DEVICE();
+  Assert(stats != nullptr && "invalid stats pointer in ospGetFrameStats");
+  *stats = currentDevice().frameBufferGetStats(fb);
+}
+OSPRAY_CATCH_END()
+
 extern "C" void ospCommit(OSPObject object)
 OSPRAY_CATCH_BEGIN
 {
@@ -567,6 +590,22 @@ OSPRAY_CATCH_BEGIN
 }
 OSPRAY_CATCH_END()
 
+extern "C" void ospBeginCommandBuffer()
+OSPRAY_CATCH_BEGIN
+{
+  ASSERT_DEVICE();
+  currentDevice().beginCommandBuffer();
+}
+OSPRAY_CATCH_END()
+
+extern "C" void ospEndCommandBuffer()
+OSPRAY_CATCH_BEGIN
+{
+  ASSERT_DEVICE();
+  currentDevice().endCommandBuffer();
+}
+OSPRAY_CATCH_END()
+
 extern "C" void ospDeviceSetString(OSPDevice _object,
                                    const char *id,
                                    const char *s)
@@ -623,6 +662,23 @@ OSPRAY_CATCH_BEGIN
 }
 OSPRAY_CATCH_END(nullptr)
 
+extern "C" void ospDeviceGetAllocationStats(OSPDevice object,
+                                            OSPAllocationStats *stats)
+OSPRAY_CATCH_BEGIN
+{
+  auto *device = (Device *)object;
+  const auto allocStats = device->allocationStats();
+  stats->bytesInUse             = allocStats.bytesInUse;
+  stats->peakBytesInUse         = allocStats.peakBytesInUse;
+  stats->numAllocations         = allocStats.numAllocations;
+  stats->numFrees               = allocStats.numFrees;
+  stats->numPoolHits            = allocStats.numPoolHits;
+  stats->bytesPooled            = allocStats.bytesPooled;
+  stats->numHugePageAllocations = allocStats.numHugePageAllocations;
+  stats->hugePageBytesInUse     = allocStats.hugePageBytesInUse;
+}
+OSPRAY_CATCH_END()
+
 extern "C" void ospSetString(OSPObject _object, const char *id, const char *s)
 OSPRAY_CATCH_BEGIN
 {
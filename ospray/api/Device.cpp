@@ -18,13 +18,18 @@
 #include "Device.h"
 #include "common/OSPCommon.h"
 #include "common/Util.h"
+#include "fb/FrameBuffer.h"
 // ospcommon
 #include "ospcommon/utility/getEnvVar.h"
+#include "ospcommon/malloc.h"
+#include "ospcommon/numa.h"
 #include "ospcommon/sysinfo.h"
 #include "ospcommon/tasking/tasking_system_handle.h"
+#include "ospcommon/utility/Trace.h"
 // embree
 #include "embree2/rtcore.h"
 
+#include <cstring>
 #include <map>
 
 namespace ospray {
@@ -132,8 +137,53 @@ namespace ospray {
 
       threadAffinity = getParam1i("setAffinity", threadAffinity);
 
+      auto OSPRAY_NUMA = utility::getEnvVar<std::string>("OSPRAY_NUMA");
+      numa::setMode(numa::parseMode(OSPRAY_NUMA.value_or(
+                                      getParamString("numaMode", "none"))));
+
+      // NUMA placement only pays off if threads stay on their node
+      if (numa::mode() != numa::NONE && threadAffinity == AUTO_DETECT)
+        threadAffinity = AFFINITIZE;
+
+      AllocatorConfig allocConfig = ospcommon::allocatorConfig();
+      auto OSPRAY_HUGE_PAGES = utility::getEnvVar<int>("OSPRAY_HUGE_PAGES");
+      allocConfig.hugePages = (HugePageMode)OSPRAY_HUGE_PAGES.value_or(
+                                getParam1i("hugePages", allocConfig.hugePages));
+      allocConfig.hugePageThreshold =
+        size_t(getParam1i("hugePageThresholdMB",
+                          allocConfig.hugePageThreshold / (1024*1024)))
+        * 1024 * 1024;
+      auto OSPRAY_ALLOCATION_POOLS =
+          utility::getEnvVar<int>("OSPRAY_ALLOCATION_POOLS");
+      allocConfig.usePools = OSPRAY_ALLOCATION_POOLS.value_or(
+                               getParam1i("allocationPools",
+                                          allocConfig.usePools));
+      ospcommon::setAllocatorConfig(allocConfig);
+
+      auto OSPRAY_TRACE_FILE = utility::getEnvVar<std::string>("OSPRAY_TRACE_FILE");
+      const auto traceFile = OSPRAY_TRACE_FILE.value_or(
+                               getParamString("traceFile"));
+      if (!traceFile.empty()) {
+#ifndef OSPRAY_ENABLE_TRACING
+        postStatusMsg() << "#osp: traceFile is set, but OSPRay was built "
+                        << "without OSPRAY_ENABLE_TRACING";
+#endif
+        trace::setBufferSize(getParam1i("traceBufferSize", 1 << 16));
+        trace::writeChromeTraceAtExit(traceFile);
+      }
+      trace::setEnabled(!traceFile.empty());
+
+      auto OSPRAY_TILE_SIZE = utility::getEnvVar<std::string>("OSPRAY_TILE_SIZE");
+      const auto tileSizeParam = OSPRAY_TILE_SIZE.value_or(
+                                   getParamString("tileSize"));
+      if (!tileSizeParam.empty())
+        tileSize = FrameBuffer::parseTileSize(tileSizeParam);
+
       tasking::initTaskingSystem(numThreads);
 
+      if (numa::mode() != numa::NONE && threadAffinity == AFFINITIZE)
+        tasking::pinTaskingThreads();
+
       committed = true;
     }
 
@@ -142,6 +192,18 @@ namespace ospray {
       return committed;
     }
 
+    OSPFrameStats Device::frameBufferGetStats(OSPFrameBuffer)
+    {
+      OSPFrameStats stats;
+      std::memset(&stats, 0, sizeof(stats));
+      return stats;
+    }
+
+    AllocationStats Device::allocationStats() const
+    {
+      return ospcommon::allocationStats();
+    }
+
     bool deviceIsSet()
     {
       return Device::current.ptr != nullptr;
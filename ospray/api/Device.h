@@ -81,6 +81,12 @@ namespace ospray {
       virtual OSPData newData(size_t nitems, OSPDataType format,
                               void *init, int flags) = 0;
 
+      /*! create a new data buffer sharing the app's memory, calling
+          'deleter' once that memory is no longer referenced */
+      virtual OSPData newSharedData(size_t nitems, OSPDataType format,
+                                    void *init, OSPDataDeleter deleter,
+                                    void *userData) = 0;
+
       /*! Copy data into the given volume. */
       virtual int setRegion(OSPVolume object, const void *source,
                             const vec3i &index, const vec3i &count) = 0;
@@ -169,6 +175,10 @@ namespace ospray {
                                 OSPRenderer _renderer,
                                 const uint32 fbChannelFlags) = 0;
 
+      /*! statistics of the last frame rendered into the frame buffer;
+          devices which don't track them return all zeros */
+      virtual OSPFrameStats frameBufferGetStats(OSPFrameBuffer _fb);
+
 
 
       //! release (i.e., reduce refcount of) given object
@@ -212,9 +222,19 @@ namespace ospray {
         NOT_IMPLEMENTED;
       }
 
+      /*! start recording API calls into a command buffer; devices
+          that execute all calls locally have nothing to record */
+      virtual void beginCommandBuffer() {}
+
+      /*! stop recording API calls and submit the recorded ones */
+      virtual void endCommandBuffer() {}
+
       virtual void commit() override;
       bool isCommitted();
 
+      /*! statistics of the allocator backing alignedMalloc() */
+      virtual AllocationStats allocationStats() const;
+
       // Public Data //
 
       // NOTE(jda) - Keep embreeDevice static until runWorker() in MPI mode can
@@ -226,6 +246,10 @@ namespace ospray {
 
       enum OSP_THREAD_AFFINITY {AUTO_DETECT, AFFINITIZE, DEAFFINITIZE};
       int threadAffinity {AUTO_DETECT};
+      /*! size of the tiles of newly created frame buffers, a power of
+          two of at most TILE_SIZE per dimension (param "tileSize" or
+          OSPRAY_TILE_SIZE, as "n" or "WxH") */
+      vec2i tileSize {TILE_SIZE};
       /*! logging level (cmdline: --osp:loglevel \<n\>) */
       // NOTE(jda) - Keep logLevel static because the device factory function
       //             needs to have a valid value for the initial Device creation
@@ -18,6 +18,7 @@
 #include "common/Model.h"
 #include "common/Data.h"
 #include "common/Util.h"
+#include "common/FrameStats.h"
 #include "geometry/TriangleMesh.h"
 #include "render/Renderer.h"
 #include "camera/Camera.h"
@@ -77,11 +78,17 @@ namespace ospray {
       bool hasDepthBuffer    = (channels & OSP_FB_DEPTH) != 0;
       bool hasAccumBuffer    = (channels & OSP_FB_ACCUM) != 0;
       bool hasVarianceBuffer = (channels & OSP_FB_VARIANCE) != 0;
+      bool hasNormalBuffer   = (channels & OSP_FB_NORMAL) != 0;
+      bool hasAlbedoBuffer   = (channels & OSP_FB_ALBEDO) != 0;
 
       FrameBuffer *fb = new LocalFrameBuffer(size,colorBufferFormat,
                                              hasDepthBuffer,
                                              hasAccumBuffer,
-                                             hasVarianceBuffer);
+                                             hasVarianceBuffer,
+                                             nullptr,
+                                             tileSize,
+                                             hasNormalBuffer,
+                                             hasAlbedoBuffer);
       fb->refInc();
       return (OSPFrameBuffer)fb;
     }
@@ -115,6 +122,8 @@ namespace ospray {
       switch (channel) {
       case OSP_FB_COLOR: return fb->mapColorBuffer();
       case OSP_FB_DEPTH: return fb->mapDepthBuffer();
+      case OSP_FB_NORMAL: return fb->mapNormalBuffer();
+      case OSP_FB_ALBEDO: return fb->mapAlbedoBuffer();
       default: return nullptr;
       }
     }
@@ -141,7 +150,9 @@ namespace ospray {
     {
       ManagedObject *object = (ManagedObject *)_object;
       Assert2(object,"null object in LocalDevice::commit()");
+      const double start = getSysTime();
       object->commit();
+      addCommitTime(getSysTime() - start);
     }
 
     /*! add a new geometry to a model */
@@ -215,6 +226,15 @@ namespace ospray {
       return (OSPData)data;
     }
 
+    OSPData LocalDevice::newSharedData(size_t nitems, OSPDataType format,
+                                       void *init, OSPDataDeleter deleter,
+                                       void *userData)
+    {
+      Data *data = new Data(nitems,format,init,deleter,userData);
+      data->refInc();
+      return (OSPData)data;
+    }
+
     /*! assign (named) string parameter to an object */
     void LocalDevice::setString(OSPObject _object,
                                 const char *bufName,
@@ -546,6 +566,13 @@ namespace ospray {
       }
     }
 
+    OSPFrameStats LocalDevice::frameBufferGetStats(OSPFrameBuffer _fb)
+    {
+      FrameBuffer *fb = (FrameBuffer *)_fb;
+      Assert(fb != nullptr && "invalid frame buffer handle");
+      return fb->frameStats;
+    }
+
     //! release (i.e., reduce refcount of) given object
     /*! Note that all objects in ospray are refcounted, so one cannot
       explicitly "delete" any object. Instead, each object is created
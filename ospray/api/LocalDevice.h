@@ -82,6 +82,11 @@ namespace ospray {
       OSPData newData(size_t nitems, OSPDataType format,
                       void *init, int flags) override;
 
+      /*! create a new data buffer sharing the app's memory */
+      OSPData newSharedData(size_t nitems, OSPDataType format,
+                            void *init, OSPDataDeleter deleter,
+                            void *userData) override;
+
       /*! load module */
       int loadModule(const char *name) override;
 
@@ -181,6 +186,8 @@ namespace ospray {
                                OSPRenderer _renderer,
                                const uint32 fbChannelFlags) override;
 
+      OSPFrameStats frameBufferGetStats(OSPFrameBuffer _fb) override;
+
       //! release (i.e., reduce refcount of) given object
       /*! note that all objects in ospray are refcounted, so one cannot
         explicitly "delete" any object. instead, each object is created
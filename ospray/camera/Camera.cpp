@@ -54,5 +54,18 @@ namespace ospray {
         );
   }
 
+  box2f Camera::projectBox(const box3f &) const
+  {
+    return box2f(vec2f(0.f), vec2f(1.f));
+  }
+
+  box2f Camera::imageToScreen(const box2f &image) const
+  {
+    const vec2f size = imageEnd - imageStart;
+    const vec2f a = (image.lower - imageStart) / size;
+    const vec2f b = (image.upper - imageStart) / size;
+    return box2f(min(a, b), max(a, b));
+  }
+
 } // ::ospray
 
@@ -34,6 +34,11 @@ namespace ospray {
 
     static Camera *createInstance(const char *identifier);
 
+    /*! conservative bounds (in [0..1]^2 screen coordinates of the frame)
+        of the projection of box 'b', an empty box if 'b' is certainly not
+        visible. The default covers the whole screen, i.e. never culls. */
+    virtual box2f projectBox(const box3f &b) const;
+
     // Data members //
 
     vec3f  pos;      // position of the camera in world-space
@@ -46,6 +51,12 @@ namespace ospray {
     vec2f  imageEnd; // upper right corner
     float shutterOpen; // start time of camera shutter
     float shutterClose; // end time of camera shutter
+
+  protected:
+
+    /*! map bounds on the image plane (in the camera's [0..1]^2 image
+        coordinates) to screen coordinates, undoing imageStart/imageEnd */
+    box2f imageToScreen(const box2f &image) const;
   };
 
   /*! \brief registers a internal ospray::'ClassName' camera under
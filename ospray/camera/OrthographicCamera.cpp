@@ -51,6 +51,9 @@ namespace ospray {
 
     vec3f pos_00 = pos - 0.5f * pos_du - 0.5f * pos_dv; 
 
+    imageOrigin = pos_00;
+    worldToImage = LinearSpace3f(pos_du, pos_dv, dir).inverse();
+
     ispc::OrthographicCamera_set(getIE(),
                                  (const ispc::vec3f&)dir,
                                  (const ispc::vec3f&)pos_00,
@@ -58,6 +61,23 @@ namespace ospray {
                                  (const ispc::vec3f&)pos_dv);
   }
 
+  box2f OrthographicCamera::projectBox(const box3f &b) const
+  {
+    box2f image = empty;
+    for (int i = 0; i < 8; ++i) {
+      const vec3f corner(i & 1 ? b.upper.x : b.lower.x,
+                         i & 2 ? b.upper.y : b.lower.y,
+                         i & 4 ? b.upper.z : b.lower.z);
+      if (!std::isfinite(corner.x) || !std::isfinite(corner.y)
+          || !std::isfinite(corner.z)) {
+        return Camera::projectBox(b);
+      }
+      const vec3f p = worldToImage * (corner - imageOrigin);
+      image.extend(vec2f(p.x, p.y));
+    }
+    return imageToScreen(image);
+  }
+
   OSP_REGISTER_CAMERA(OrthographicCamera, orthographic);
 
 } // ::ospray
@@ -52,11 +52,17 @@ namespace ospray {
 
     virtual std::string toString() const override;
     virtual void commit() override;
+    virtual box2f projectBox(const box3f &b) const override;
 
     // Data members //
 
     float  height; // size of the camera's image plane in y, in world coordinates
     float  aspect;
+
+  private:
+
+    vec3f imageOrigin;
+    LinearSpace3f worldToImage; // (pos_du, pos_dv, dir)^-1
   };
 
 } // ::ospray
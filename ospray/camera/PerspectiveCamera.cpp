@@ -81,6 +81,9 @@ namespace ospray {
 
     vec3f dir_00 = dir - .5f * dir_du - .5f * dir_dv;
 
+    projectionOrigin = org;
+    worldToImage = LinearSpace3f(dir_du, dir_dv, dir_00).inverse();
+
     float scaledAperture = 0.f;
     // prescale to focal plane
     if (apertureRadius > 0.f) {
@@ -102,6 +105,41 @@ namespace ospray {
         );
   }
 
+  box2f PerspectiveCamera::projectBox(const box3f &b) const
+  {
+    // with depth of field rays don't all start at 'pos', and side by side
+    // stereo puts two images on screen; don't bother culling for either
+    if (apertureRadius > 0.f || stereoMode == OSP_STEREO_SIDE_BY_SIDE)
+      return Camera::projectBox(b);
+
+    box2f image = empty;
+    int numBehind = 0;
+    for (int i = 0; i < 8; ++i) {
+      const vec3f corner(i & 1 ? b.upper.x : b.lower.x,
+                         i & 2 ? b.upper.y : b.lower.y,
+                         i & 4 ? b.upper.z : b.lower.z);
+      if (!std::isfinite(corner.x) || !std::isfinite(corner.y)
+          || !std::isfinite(corner.z)) {
+        return Camera::projectBox(b);
+      }
+      // (u, v, 1) * depth on the image plane
+      const vec3f p = worldToImage * (corner - projectionOrigin);
+      if (p.z <= 0.f) {
+        ++numBehind;
+        continue;
+      }
+      image.extend(vec2f(p.x, p.y) / p.z);
+    }
+
+    if (numBehind == 8)
+      return box2f(empty);
+    // the box straddles the camera plane, it may cover anything
+    if (numBehind > 0)
+      return Camera::projectBox(b);
+
+    return imageToScreen(image);
+  }
+
   OSP_REGISTER_CAMERA(PerspectiveCamera,perspective);
   OSP_REGISTER_CAMERA(PerspectiveCamera,thinlens);
   OSP_REGISTER_CAMERA(PerspectiveCamera,stereo);
@@ -54,6 +54,7 @@ namespace ospray {
     /*! Every derived class should overrride this! */
     virtual std::string toString() const override;
     virtual void commit() override;
+    virtual box2f projectBox(const box3f &b) const override;
 
     // Data members //
 
@@ -70,6 +71,11 @@ namespace ospray {
     } StereoMode;
     StereoMode stereoMode;
     float interpupillaryDistance; // distance between the two cameras (stereo)
+
+  private:
+
+    vec3f projectionOrigin;
+    LinearSpace3f worldToImage; // (dir_du, dir_dv, dir_00)^-1
   };
   
 } // ::ospray
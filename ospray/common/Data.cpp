@@ -40,6 +40,14 @@ namespace ospray {
     managedObjectType = OSP_DATA;
   }
 
+  Data::Data(size_t numItems, OSPDataType type, void *init,
+             OSPDataDeleter deleter, void *deleterUserData) :
+    Data(numItems, type, init, OSP_DATA_SHARED_BUFFER)
+  {
+    this->deleter = deleter;
+    this->deleterUserData = deleterUserData;
+  }
+
   Data::~Data()
   {
     if (type == OSP_OBJECT) {
@@ -52,6 +60,8 @@ namespace ospray {
 
     if (!(flags & OSP_DATA_SHARED_BUFFER))
       alignedFree(data);
+    else if (deleter)
+      deleter(deleterUserData, data);
   }
 
   /*! commit this object - for this object type, make sure that all
@@ -27,6 +27,12 @@ namespace ospray {
   {
     Data(size_t numItems, OSPDataType type, void *data, int flags = 0);
 
+    /*! create a data array that shares (and does not copy) the given
+        memory; 'deleter' (if non-null) gets called once this object
+        is destroyed, i.e. once ospray no longer references 'data' */
+    Data(size_t numItems, OSPDataType type, void *data,
+         OSPDataDeleter deleter, void *deleterUserData = nullptr);
+
     virtual ~Data();
 
     /*! commit this object - for this object type, make sure that all
@@ -46,6 +52,9 @@ namespace ospray {
     size_t      numBytes; /*!< total num bytes (sizeof(type)*numItems) */
     int         flags;    /*!< creation flags */
     OSPDataType type;     /*!< element type */
+
+    OSPDataDeleter deleter {nullptr}; /*!< called on shared data at destruction */
+    void *deleterUserData {nullptr};  /*!< user pointer passed to 'deleter' */
   };
 
 } // ::ospray
@@ -0,0 +1,132 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "FrameStats.h"
+// stl
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace ospray {
+
+  /*! the counters of one thread; only the owning thread writes them, so
+      relaxed load+store is enough (and cheaper than fetch_add) */
+  struct ThreadCounters
+  {
+    std::array<std::atomic<uint64>, RC_NUM_COUNTERS> values;
+
+    ThreadCounters()
+    {
+      for (auto &v : values)
+        v = 0;
+    }
+  };
+
+  /*! all thread counters ever created; they are never freed, such that
+      the counts of finished threads are still part of the sums */
+  struct CounterRegistry
+  {
+    std::mutex mutex;
+    std::vector<ThreadCounters*> threads;
+  };
+
+  static CounterRegistry &counterRegistry()
+  {
+    static CounterRegistry *registry = new CounterRegistry;
+    return *registry;
+  }
+
+  static thread_local ThreadCounters *threadCounters = nullptr;
+
+  static std::atomic<uint64> commitNS {0};
+
+  void addRenderCount(RenderCounter counter, uint64 n)
+  {
+    if (!threadCounters) {
+      auto &registry = counterRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      threadCounters = new ThreadCounters;
+      registry.threads.push_back(threadCounters);
+    }
+
+    auto &value = threadCounters->values[counter];
+    value.store(value.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+  }
+
+  extern "C" void ospray_addRenderCount(int32 counter, uint64 n)
+  {
+    addRenderCount((RenderCounter)counter, n);
+  }
+
+  RenderCounters renderCounters()
+  {
+    RenderCounters sum;
+    sum.fill(0);
+
+    auto &registry = counterRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto *t : registry.threads) {
+      for (int i = 0; i < RC_NUM_COUNTERS; i++)
+        sum[i] += t->values[i].load(std::memory_order_relaxed);
+    }
+
+    return sum;
+  }
+
+  void addCommitTime(double seconds)
+  {
+    commitNS += uint64(seconds * 1e9);
+  }
+
+  FrameStatsScope::FrameStatsScope(OSPFrameStats &target)
+    : target(target),
+      begin(renderCounters()),
+      startTime(getSysTime()),
+      commitTime(commitNS.exchange(0) * 1e-9)
+  {
+  }
+
+  FrameStatsScope::~FrameStatsScope()
+  {
+    const double renderTime = getSysTime() - startTime;
+
+    const RenderCounters end = renderCounters();
+    auto delta = [&](RenderCounter c) { return end[c] - begin[c]; };
+
+    OSPFrameStats stats;
+    stats.primaryRays    = delta(RC_PRIMARY_RAYS);
+    stats.shadowRays     = delta(RC_SHADOW_RAYS);
+    stats.secondaryRays  = delta(RC_TRACED_RAYS) -
+                           std::min(delta(RC_TRACED_RAYS), stats.primaryRays);
+    stats.volumeSamples  = delta(RC_VOLUME_SAMPLES);
+    stats.tilesRendered  = delta(RC_TILES_RENDERED);
+    stats.tilesSkipped   = delta(RC_TILES_SKIPPED);
+    stats.commitTime     = commitTime;
+    stats.renderTime     = renderTime;
+    stats.accumulateTime = delta(RC_ACCUMULATE_NS) * 1e-9;
+    stats.compositeTime  = delta(RC_COMPOSITE_NS) * 1e-9;
+
+    const double rcpTime = renderTime > 0.0 ? 1.0 / renderTime : 0.0;
+    stats.raysPerSecond =
+      (stats.primaryRays + stats.shadowRays + stats.secondaryRays) * rcpTime;
+    stats.samplesPerSecond = stats.primaryRays * rcpTime;
+
+    target = stats;
+  }
+
+} // ::ospray
@@ -0,0 +1,76 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "OSPCommon.h"
+// stl
+#include <array>
+
+/*! \file FrameStats.h render statistics as returned by ospGetFrameStats().
+
+    While rendering, every thread increments its own set of counters
+    (from C++ with addRenderCount(), from ISPC with the helpers in
+    FrameStats.ih); a frame's statistics are the difference of the sums
+    over all threads before and after the frame. Frames rendered
+    concurrently into different frame buffers thus see each other's
+    counts.
+*/
+
+namespace ospray {
+
+  /*! the counters of each thread; make sure this matches the RC_*
+      defines in FrameStats.ih */
+  enum RenderCounter
+  {
+    RC_PRIMARY_RAYS = 0,
+    RC_SHADOW_RAYS,
+    RC_TRACED_RAYS,    //!< all non-shadow rays (primary and secondary)
+    RC_VOLUME_SAMPLES,
+    RC_TILES_RENDERED,
+    RC_TILES_SKIPPED,  //!< tiles whose error was already below threshold
+    RC_ACCUMULATE_NS,  //!< time spent in FrameBuffer::setTile()
+    RC_COMPOSITE_NS,   //!< time spent waiting for distributed compositing
+    RC_NUM_COUNTERS
+  };
+
+  using RenderCounters = std::array<uint64, RC_NUM_COUNTERS>;
+
+  /*! add 'n' to the given counter of the calling thread */
+  OSPRAY_SDK_INTERFACE void addRenderCount(RenderCounter counter, uint64 n);
+
+  /*! sum of all counters over all threads */
+  OSPRAY_SDK_INTERFACE RenderCounters renderCounters();
+
+  /*! accounts time spent in ospCommit() towards the next frame */
+  OSPRAY_SDK_INTERFACE void addCommitTime(double seconds);
+
+  /*! records the statistics of the frame rendered during its lifetime
+      into the given frame buffer's stats */
+  struct OSPRAY_SDK_INTERFACE FrameStatsScope
+  {
+    FrameStatsScope(OSPFrameStats &target);
+    ~FrameStatsScope();
+
+  private:
+
+    OSPFrameStats &target;
+    RenderCounters begin;
+    double startTime;
+    double commitTime;
+  };
+
+} // ::ospray
@@ -17,8 +17,13 @@
 // ospray
 #include "api/Device.h"
 #include "Model.h"
+#include "ospcommon/tasking/parallel_for.h"
 // ispc exports
 #include "Model_ispc.h"
+#include "geometry/Geometry_ispc.h"
+// stl
+#include <exception>
+#include <mutex>
 
 namespace ospray {
 
@@ -50,17 +55,13 @@ namespace ospray {
     ispc::Model_init(getIE(), embreeDevice, geometry.size(), volume.size());
     embreeSceneHandle = (RTCScene)ispc::Model_getEmbreeSceneHandle(getIE());
 
+    finalizeGeometries(getParam1i("parallelCommit", 0));
+
     bounds = empty;
 
     for (size_t i = 0; i < geometry.size(); i++) {
-       postStatusMsg(2)
-           << "=======================================================\n"
-           << "Finalizing geometry " << i;
-
-      geometry[i]->finalize(this);
-
       bounds.extend(geometry[i]->bounds);
-      ispc::Model_setGeometry(getIE(), i, geometry[i]->getIE());
+      ispc::Model_setGeometry(getIE(), geomID[i], geometry[i]->getIE());
     }
 
     for (size_t i=0; i<volume.size(); i++) 
@@ -69,4 +70,59 @@ namespace ospray {
     rtcCommit(embreeSceneHandle);
   }
 
+  void Model::finalizeGeometries(bool parallel)
+  {
+    const size_t numGeometries = geometry.size();
+    geomID.assign(numGeometries, -1);
+
+    std::vector<size_t> concurrent, sequential;
+    for (size_t i = 0; i < numGeometries; i++) {
+      if (parallel && geometry[i]->finalizeIsThreadSafe())
+        concurrent.push_back(i);
+      else
+        sequential.push_back(i);
+    }
+
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    tasking::parallel_for(concurrent.size(), [&](size_t c) {
+      const size_t i = concurrent[c];
+      try {
+        geometry[i]->finalize(this);
+        geomID[i] = ispc::Geometry_getGeomID(geometry[i]->getIE());
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+          error = std::current_exception();
+      }
+    });
+
+    if (error)
+      std::rethrow_exception(error);
+
+    // embree numbers the geometries in the order they got created, the
+    // concurrently created ones thus have to tell which number they got
+    std::vector<bool> used(concurrent.size(), false);
+    for (size_t i : concurrent) {
+      const int32 id = geomID[i];
+      if (id < 0 || id >= int32(concurrent.size()) || used[id]) {
+        throw std::runtime_error(geometry[i]->toString() + " claims a"
+                                 " thread-safe finalize(), but does not"
+                                 " report a valid embree geomID");
+      }
+      used[id] = true;
+    }
+
+    for (size_t s = 0; s < sequential.size(); s++) {
+      const size_t i = sequential[s];
+      postStatusMsg(2)
+          << "=======================================================\n"
+          << "Finalizing geometry " << i;
+
+      geometry[i]->finalize(this);
+      geomID[i] = concurrent.size() + s;
+    }
+  }
+
 } // ::ospray
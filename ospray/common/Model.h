@@ -44,6 +44,10 @@ namespace ospray {
     virtual std::string toString() const override;
     virtual void commit() override;
 
+    /*! finalize all geometries; if 'parallel', those which have a
+        thread-safe finalize() concurrently (before all others) */
+    void finalizeGeometries(bool parallel);
+
     // Data members //
 
     using GeometryVector = std::vector<Ref<Geometry>>;
@@ -51,6 +55,9 @@ namespace ospray {
 
     //! \brief vector of all geometries used in this model
     GeometryVector geometry;
+    /*! the embree geomID of each geometry, i.e., its index on the ISPC
+        side (and as reported by rays) */
+    std::vector<int32> geomID;
     //! \brief vector of all volumes used in this model
     VolumeVector volume;
 
@@ -18,6 +18,7 @@
 #include "api/Device.h"
 
 #include <map>
+#include <mutex>
 
 namespace ospray {
 
@@ -330,6 +331,10 @@ namespace ospray {
     if (api::deviceIsSet()) {
       auto &device = api::currentDevice();
 
+      // API calls may fail concurrently on several threads
+      static std::mutex errorMutex;
+      std::lock_guard<std::mutex> lock(errorMutex);
+
       device.lastErrorCode = e;
       device.lastErrorMsg  = message;
 
@@ -15,34 +15,226 @@
 // ======================================================================== //
 
 #include "ObjectHandle.h"
-#include <map>
-#include <stack>
+// stl
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ospray {
 
-  std::map<int64,Ref<ospray::ManagedObject>> objectByHandle;
-  std::stack<int64> freedHandles;
+  /*! the handle table: slots are allocated in chunks which never move
+      (or get freed), so a lookup is two loads and takes no lock. Freed
+      slots are kept in several free lists, the one used is picked per
+      thread, so concurrent allocations don't contend on a single lock */
+  struct HandleTable
+  {
+    static constexpr int    CHUNK_BITS = 16;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static constexpr size_t MAX_SLOTS  = size_t(1) << 31; // IDs are int32
+    static constexpr size_t NUM_CHUNKS = MAX_SLOTS / CHUNK_SIZE;
+    static constexpr int    NUM_SHARDS = 16;
+
+    struct Slot
+    {
+      std::atomic<ManagedObject*> object {nullptr};
+      //! generation of the handle currently referring to this slot
+      std::atomic<uint16> generation {1};
+      //! whether the handle got assigned (possibly to nullptr) since
+      //! it was allocated
+      std::atomic<bool> assigned {false};
+    };
+
+    struct Shard
+    {
+      std::mutex mutex;
+      std::vector<uint32> freeSlots;
+    };
+
+    HandleTable()
+    {
+      for (auto &c : chunks)
+        c = nullptr;
+    }
+
+    //! the slot of a handle, nullptr if there is none (yet)
+    Slot *find(const ObjectHandle &handle) const
+    {
+      if (handle.i32.ID <= 0 || handle.i32.owner != 0)
+        return nullptr;
+      const size_t s = size_t(handle.i32.ID) - 1;
+      Slot *chunk = chunks[s >> CHUNK_BITS].load(std::memory_order_acquire);
+      return chunk ? &chunk[s & (CHUNK_SIZE - 1)] : nullptr;
+    }
+
+    //! the given slot, allocates its chunk if necessary
+    Slot &get(size_t s)
+    {
+      auto &c = chunks[s >> CHUNK_BITS];
+      Slot *chunk = c.load(std::memory_order_acquire);
+      if (!chunk) {
+        Slot *newChunk = new Slot[CHUNK_SIZE];
+        if (c.compare_exchange_strong(chunk, newChunk,
+                                      std::memory_order_acq_rel)) {
+          chunk = newChunk;
+        } else {
+          delete [] newChunk;
+        }
+      }
+      return chunk[s & (CHUNK_SIZE - 1)];
+    }
+
+    Shard &localShard()
+    {
+      static std::atomic<int> nextShard {0};
+      static thread_local int shard = nextShard++ % NUM_SHARDS;
+      return shards[shard];
+    }
+
+    bool popFreeSlot(Shard &shard, uint32 &s)
+    {
+      if (shard.freeSlots.empty())
+        return false;
+      s = shard.freeSlots.back();
+      shard.freeSlots.pop_back();
+      return true;
+    }
+
+    ObjectHandle allocate()
+    {
+      uint32 s = 0;
+      bool reused = false;
+      {
+        auto &shard = localShard();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        reused = popFreeSlot(shard, s);
+      }
+      // before growing the table take a slot freed by other threads
+      for (int i = 0; i < NUM_SHARDS && !reused; i++) {
+        std::unique_lock<std::mutex> lock(shards[i].mutex, std::try_to_lock);
+        if (lock.owns_lock())
+          reused = popFreeSlot(shards[i], s);
+      }
+      if (!reused) {
+        const size_t n = numSlots++;
+        if (n >= MAX_SLOTS - 1)
+          throw std::runtime_error("#osp: out of object handles");
+        s = n;
+      }
+
+      ObjectHandle handle(0);
+      handle.i32.ID = s + 1;
+      handle.i32.generation = get(s).generation.load(std::memory_order_acquire);
+      return handle;
+    }
+
+    void free(const ObjectHandle &handle)
+    {
+      Slot *slot = find(handle);
+      if (!slot)
+        return;
+
+      // a stale (or already freed) handle must not free the slot again
+      uint16 generation = handle.i32.generation;
+      const uint16 next = generation == 0xffff ? 1 : generation + 1;
+      if (!slot->generation.compare_exchange_strong(generation, next))
+        return;
+      slot->assigned.store(false, std::memory_order_release);
+
+      auto &shard = localShard();
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.freeSlots.push_back(handle.i32.ID - 1);
+    }
+
+    void assign(const ObjectHandle &handle, ManagedObject *object)
+    {
+      if (handle.i32.ID <= 0 || handle.i32.owner != 0)
+        throw std::runtime_error("#osp: invalid object handle "
+                                 + std::to_string(handle.i64));
+
+      const size_t id = handle.i32.ID;
+      Slot &slot = get(id - 1);
+      if (object)
+        object->refInc();
+      slot.generation.store(handle.i32.generation, std::memory_order_release);
+      ManagedObject *old = slot.object.exchange(object,
+                                                std::memory_order_acq_rel);
+      slot.assigned.store(true, std::memory_order_release);
+      if (old)
+        old->refDec();
+
+      // handles assigned on workers were allocated by the master
+      size_t n = numSlots.load();
+      while (n < id && !numSlots.compare_exchange_weak(n, id));
+    }
+
+    ManagedObject *lookup(const ObjectHandle &handle) const
+    {
+      Slot *slot = find(handle);
+      if (!slot)
+        return nullptr;
+      ManagedObject *object = slot->object.load(std::memory_order_acquire);
+      if (slot->generation.load(std::memory_order_acquire)
+          != handle.i32.generation)
+        return nullptr;
+      return object;
+    }
+
+    bool defined(const ObjectHandle &handle) const
+    {
+      Slot *slot = find(handle);
+      if (!slot)
+        return false;
+      const bool assigned = slot->assigned.load(std::memory_order_acquire);
+      return assigned && slot->generation.load(std::memory_order_acquire)
+                         == handle.i32.generation;
+    }
+
+    ManagedObject *release(const ObjectHandle &handle)
+    {
+      Slot *slot = find(handle);
+      if (!slot || slot->generation.load() != handle.i32.generation)
+        return nullptr;
+      return slot->object.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    ObjectHandle reverseLookup(const ManagedObject *object) const
+    {
+      const size_t n = std::min(numSlots.load(), MAX_SLOTS);
+      for (size_t s = 0; s < n; s++) {
+        ObjectHandle handle(0);
+        handle.i32.ID = s + 1;
+        Slot *slot = find(handle);
+        if (slot && slot->object.load() == object) {
+          handle.i32.generation = slot->generation.load();
+          return handle;
+        }
+      }
+      return nullHandle;
+    }
+
+    std::atomic<Slot*>  chunks[NUM_CHUNKS];
+    //! slots ever handed out, the ones below are in use or free lists
+    std::atomic<size_t> numSlots {0};
+    Shard shards[NUM_SHARDS];
+  };
+
+  // NOTE: intentionally leaked, objects may still be looked up (or
+  //       released) while static objects get destroyed at exit
+  static HandleTable &handleTable()
+  {
+    static HandleTable *table = new HandleTable;
+    return *table;
+  }
 
-  //! next unassigned ID on this node
-  /*! we start numbering with 1 to make sure that "0:0" is an
-    invalid handle (so we can typecast between (64-bit) handles
-    and (64-bit)OSPWhatEver pointers */
-  int32 nextFreeLocalID = 1;
-    
   void ObjectHandle::free()
   {
-    freedHandles.push((int64)*this);
+    handleTable().free(*this);
   }
 
-  ObjectHandle::ObjectHandle()
+  ObjectHandle::ObjectHandle() : i64(handleTable().allocate().i64)
   {
-    if (freedHandles.empty()) {
-      i32.ID    = nextFreeLocalID++;
-      i32.owner = 0;
-    } else {
-      i64 = freedHandles.top();
-      freedHandles.pop();
-    }
   }
 
   ObjectHandle::ObjectHandle(int64 i) : i64(i)
@@ -63,20 +255,21 @@ namespace ospray {
   void ObjectHandle::assign(const ObjectHandle &handle,
                             const ManagedObject *object)
   {
-    objectByHandle[handle] = (ManagedObject*)object;
+    handleTable().assign(handle, (ManagedObject*)object);
   }
 
   void ObjectHandle::assign(const ManagedObject *object) const
   {
-    objectByHandle[*this] = (ManagedObject*)object;
+    handleTable().assign(*this, (ManagedObject*)object);
   }
 
   void ObjectHandle::freeObject() const
   {
-    auto it = objectByHandle.find(i64);
-    Assert(it != objectByHandle.end());
-    it->second = nullptr;
-    objectByHandle.erase(it);
+    Assert(defined());
+    ManagedObject *object = handleTable().release(*this);
+    if (object)
+      object->refDec();
+    handleTable().free(*this);
   }
 
   int32 ObjectHandle::ownerRank() const
@@ -96,16 +289,15 @@ namespace ospray {
 
   bool ObjectHandle::defined() const
   {
-    auto it = objectByHandle.find(i64);
-    return it != objectByHandle.end();
+    return handleTable().defined(*this);
   }
 
   ManagedObject *ObjectHandle::lookup() const
   {
     if (i64 == 0) return nullptr;
 
-    auto it = objectByHandle.find(i64);
-    if (it == objectByHandle.end()) {
+    ManagedObject *object = handleTable().lookup(*this);
+    if (!object) {
 #ifndef NDEBUG
       // iw - made this into a warning only; the original code had
       // this throw an actual exceptoin, but that may be overkill
@@ -113,16 +305,12 @@ namespace ospray {
 #endif
       return nullptr;
     }
-    return it->second.ptr;
+    return object;
   }
 
   ObjectHandle ObjectHandle::lookup(ManagedObject *object)
   {
-    for (auto it = objectByHandle.begin(); it != objectByHandle.end(); it++) {
-      if (it->second.ptr == object) return(ObjectHandle(it->first));
-    }
-
-    return(nullHandle);
+    return handleTable().reverseLookup(object);
   }
     
   OSPRAY_SDK_INTERFACE const ObjectHandle nullHandle(0);
@@ -37,9 +37,16 @@ namespace ospray {
     to test the handled resturend from ospNewXXX calls for null just
     as if they were pointers (and thus, 'null' objects are
     consistent between local and mpi rendering)
+
+    The ID is the (1-based) slot of the object in a dense handle
+    table; each time a slot is freed its generation is incremented, so
+    a stale handle to a freed (and possibly reused) slot does not
+    resolve to the new object. Lookups never lock, handles can be
+    allocated and freed concurrently from any thread.
   */
   union OSPRAY_SDK_INTERFACE ObjectHandle
   {
+    /*! return the handle (i.e., its slot) for reuse */
     void free();
 
     ObjectHandle();
@@ -53,7 +60,8 @@ namespace ospray {
     /*! Return the handle associated with the given object. */
     static ObjectHandle lookup(ManagedObject *object);
 
-    /*! check whether the handle is defined *on this rank* */
+    /*! check whether the handle is defined *on this rank*, i.e., got
+        assigned (possibly to nullptr) and was not freed since */
     bool defined() const;
 
     /*! define the given handle to refer to given object */
@@ -62,6 +70,7 @@ namespace ospray {
     /*! define the given handle to refer to given object */
     void assign(const ManagedObject *object) const;
 
+    /*! release the object and free the handle */
     void freeObject() const;
 
     int32 ownerRank() const;
@@ -72,7 +81,7 @@ namespace ospray {
 
     // Data members //
 
-    struct { int32 ID; int32 owner; } i32;
+    struct { int32 ID; uint16 generation; uint16 owner; } i32;
     int64 i64;
   };
 
@@ -19,6 +19,7 @@
 #include "OSPCommon.h"
 
 #include <map>
+#include <mutex>
 
 namespace ospray {
 
@@ -29,10 +30,14 @@ namespace ospray {
     // this class.
     using creationFunctionPointer = OSPRAY_CLASS*(*)();
 
-    // Function pointers corresponding to each subtype.
+    // Function pointers corresponding to each subtype; objects may be
+    // created from several threads at once.
     static std::map<std::string, creationFunctionPointer> symbolRegistry;
+    static std::mutex registryMutex;
     const auto type_string = stringForType(OSP_TYPE);
 
+    std::unique_lock<std::mutex> lock(registryMutex);
+
     // Find the creation function for the subtype if not already known.
     if (symbolRegistry.count(type) == 0) {
       postStatusMsg(2) << "#ospray: trying to look up "
@@ -55,15 +60,19 @@ namespace ospray {
       }
     }
 
+    const creationFunctionPointer create = symbolRegistry[type];
+    if (!create)
+      symbolRegistry.erase(type);
+    lock.unlock();
+
     // Create a concrete instance of the requested subtype.
-    auto *object = symbolRegistry[type] ? (*symbolRegistry[type])() : nullptr;
+    auto *object = create ? (*create)() : nullptr;
 
     // Denote the subclass type in the ManagedObject base class.
     if (object) {
       object->managedObjectType = OSP_TYPE;
     }
     else {
-      symbolRegistry.erase(type);
       throw std::runtime_error("Could not find " + type_string + " of type: " 
         + type + ".  Make sure you have the correct OSPRay libraries linked.");
     }
@@ -0,0 +1,160 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+// ospray
+#include "DenoisePixelOp.h"
+#include "LocalFB.h"
+#include "DenoisePixelOp_ispc.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
+#include "ospcommon/utility/Trace.h"
+
+namespace ospray {
+
+  // number of rows a task filters
+  static const int DENOISE_ROWS_PER_TASK = 16;
+
+  DenoisePixelOp::Instance::Instance(FrameBuffer *fb, DenoisePixelOp *op)
+    : op(op),
+      localFB(dynamic_cast<LocalFrameBuffer*>(fb))
+  {
+    this->fb = fb;
+
+    if (!localFB) {
+      postStatusMsg() << "#osp: the 'denoise' pixel op only supports local "
+                      << "frame buffers, frames will not be denoised";
+      return;
+    }
+
+    const size_t numPixels = size_t(fb->size.x) * fb->size.y;
+    irradiance  = (vec4f*)alignedMalloc(sizeof(vec4f) * numPixels);
+    filtered[0] = (vec4f*)alignedMalloc(sizeof(vec4f) * numPixels);
+    filtered[1] = (vec4f*)alignedMalloc(sizeof(vec4f) * numPixels);
+    normal = (vec3f*)alignedMalloc(sizeof(vec3f) * numPixels);
+    albedo = (vec3f*)alignedMalloc(sizeof(vec3f) * numPixels);
+    depth  = (float*)alignedMalloc(sizeof(float) * numPixels);
+    noise  = (float*)alignedMalloc(sizeof(float) * numPixels);
+  }
+
+  DenoisePixelOp::Instance::~Instance()
+  {
+    alignedFree(irradiance);
+    alignedFree(filtered[0]);
+    alignedFree(filtered[1]);
+    alignedFree(normal);
+    alignedFree(albedo);
+    alignedFree(depth);
+    alignedFree(noise);
+  }
+
+  void DenoisePixelOp::Instance::postAccum(Tile &tile)
+  {
+    if (!localFB)
+      return;
+
+    OSPRAY_TRACE_SCOPE("DenoisePixelOp::gatherTile");
+    ispc::DenoisePixelOp_gatherTile((ispc::Tile&)tile, fb->size.x,
+                                    irradiance, normal, albedo,
+                                    depth, noise);
+  }
+
+  bool DenoisePixelOp::Instance::needsAOVs() const
+  {
+    return localFB != nullptr;
+  }
+
+  void DenoisePixelOp::Instance::endFrame()
+  {
+    if (!localFB || !localFB->colorBuffer)
+      return;
+
+    OSPRAY_TRACE_SCOPE("DenoisePixelOp::endFrame");
+
+    const vec2i size = fb->size;
+    const int numTasks = divRoundUp(size.y, DENOISE_ROWS_PER_TASK);
+
+    const vec4f *src = irradiance;
+    for (int i = 0; i < op->iterations; i++) {
+      vec4f *dst = filtered[i & 1];
+      // later passes have less noise left, thus stop at smaller edges
+      const float sigmaColor = op->sigmaColor / (1 << i);
+      tasking::parallel_for(numTasks, [&](int taskIndex) {
+        const int y0 = taskIndex * DENOISE_ROWS_PER_TASK;
+        const int y1 = std::min(y0 + DENOISE_ROWS_PER_TASK, size.y);
+        ispc::DenoisePixelOp_filterRows(size.x, size.y, y0, y1, 1 << i,
+                                        src, dst,
+                                        normal, depth, noise,
+                                        sigmaColor,
+                                        op->sigmaNormal,
+                                        op->sigmaDepth);
+      });
+      src = dst;
+    }
+
+    void *color = localFB->colorBuffer;
+    const auto format = localFB->colorBufferFormat;
+    tasking::parallel_for(numTasks, [&](int taskIndex) {
+      const int y0 = taskIndex * DENOISE_ROWS_PER_TASK;
+      const int y1 = std::min(y0 + DENOISE_ROWS_PER_TASK, size.y);
+      switch (format) {
+      case OSP_FB_RGBA8:
+        ispc::DenoisePixelOp_writeRows_RGBA8(size.x, y0, y1, src,
+                                             albedo, color);
+        break;
+      case OSP_FB_SRGBA:
+        ispc::DenoisePixelOp_writeRows_SRGBA(size.x, y0, y1, src,
+                                             albedo, color);
+        break;
+      case OSP_FB_RGBA32F:
+        ispc::DenoisePixelOp_writeRows_RGBA32F(size.x, y0, y1, src,
+                                               albedo, color);
+        break;
+      default:
+        break;
+      }
+    });
+  }
+
+  std::string DenoisePixelOp::Instance::toString() const
+  {
+    return "ospray::DenoisePixelOp::Instance";
+  }
+
+  void DenoisePixelOp::commit()
+  {
+    PixelOp::commit();
+
+    iterations  = std::max(getParam1i("iterations", 5), 0);
+    sigmaColor  = getParam1f("sigmaColor", 1.f);
+    sigmaNormal = getParam1f("sigmaNormal", 64.f);
+    sigmaDepth  = getParam1f("sigmaDepth", 0.1f);
+  }
+
+  std::string DenoisePixelOp::toString() const
+  {
+    return "ospray::DenoisePixelOp";
+  }
+
+  PixelOp::Instance *DenoisePixelOp::createInstance(FrameBuffer *fb,
+                                                    PixelOp::Instance *prev)
+  {
+    UNUSED(prev);
+    return new Instance(fb, this);
+  }
+
+  OSP_REGISTER_PIXEL_OP(DenoisePixelOp, denoise);
+
+} // ::ospray
@@ -0,0 +1,86 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray
+#include "fb/PixelOp.h"
+
+namespace ospray {
+
+  struct LocalFrameBuffer;
+
+  /*! \brief edge-avoiding a-trous wavelet filter ("denoise" pixel op)
+
+      Reduces the noise of (low sample count, possibly accumulated)
+      path traced frames: postAccum gathers the accumulated color of
+      every tile, demodulated by the albedo the renderer wrote into the
+      tile, together with the first hit's normal and depth. At the end
+      of the frame the irradiance gets filtered with 'iterations'
+      a-trous passes, whose taps are stopped at normal, depth and
+      luminance edges, and the remodulated result is written into the
+      color buffer. The accumulation buffer is not modified, thus the
+      filter does not bias the converged image.
+
+      Only works with local frame buffers; frame buffers with
+      OSP_FB_NORMAL and OSP_FB_ALBEDO channels provide accumulated
+      (i.e., converging) guides, otherwise the current frame's are
+      used. */
+  struct OSPRAY_SDK_INTERFACE DenoisePixelOp : public PixelOp
+  {
+    struct OSPRAY_SDK_INTERFACE Instance : public PixelOp::Instance
+    {
+      Instance(FrameBuffer *fb, DenoisePixelOp *op);
+      virtual ~Instance() override;
+
+      void postAccum(Tile &tile) override;
+      void endFrame() override;
+      bool needsAOVs() const override;
+
+      std::string toString() const override;
+
+      Ref<DenoisePixelOp> op;
+      //! the denoised frame buffer, nullptr if unsupported
+      LocalFrameBuffer *localFB {nullptr};
+
+      /*! gathered irradiance; kept unfiltered, as tiles skipped by
+          adaptive accumulation are not gathered again */
+      vec4f *irradiance {nullptr};
+      vec4f *filtered[2] {nullptr, nullptr}; //!< ping-pong filter buffers
+      vec3f *normal {nullptr};
+      vec3f *albedo {nullptr}; //!< demodulation factor
+      float *depth {nullptr};
+      float *noise {nullptr};  //!< relative noise of the averaged color
+    };
+
+    void commit() override;
+
+    std::string toString() const override;
+
+    PixelOp::Instance *createInstance(FrameBuffer *fb,
+                                      PixelOp::Instance *prev) override;
+
+    //! number of a-trous passes, i.e., the filter radius is 2^(n+1)-2
+    int   iterations {5};
+    //! luminance edge stopping, relative to the noise of the color
+    float sigmaColor {1.f};
+    //! exponent of the cosine between normals
+    float sigmaNormal {64.f};
+    //! relative depth difference per pixel
+    float sigmaDepth {0.1f};
+  };
+
+} // ::ospray
@@ -16,6 +16,10 @@
 
 #include "FrameBuffer.h"
 #include "FrameBuffer_ispc.h"
+// ospcommon
+#include "ospcommon/numa.h"
+// stl
+#include <cstdio>
 
 namespace ospray {
 
@@ -23,8 +27,10 @@ namespace ospray {
                            ColorBufferFormat colorBufferFormat,
                            bool hasDepthBuffer,
                            bool hasAccumBuffer,
-                           bool hasVarianceBuffer)
+                           bool hasVarianceBuffer,
+                           const vec2i &tileSize)
     : size(size),
+      tileSize(tileSize),
       numTiles(divRoundUp(size, getTileSize())),
       maxValidPixelID(size-vec2i(1)),
       hasDepthBuffer(hasDepthBuffer),
@@ -35,11 +41,44 @@ namespace ospray {
   {
     managedObjectType = OSP_FRAMEBUFFER;
     Assert(size.x > 0 && size.y > 0);
+    Assert(tileSize.x <= TILE_SIZE && tileSize.y <= TILE_SIZE);
+  }
+
+  bool FrameBuffer::needsAOVs() const
+  {
+    return hasNormalBuffer || hasAlbedoBuffer
+           || (pixelOp && pixelOp->needsAOVs());
   }
 
   vec2i FrameBuffer::getTileSize() const
   {
-    return vec2i(TILE_SIZE);
+    return tileSize;
+  }
+
+  vec2i FrameBuffer::parseTileSize(const std::string &str)
+  {
+    vec2i tileSize(0);
+    char x = 0, trailing = 0;
+    const int n = sscanf(str.c_str(), "%d%c%d%c",
+                         &tileSize.x, &x, &tileSize.y, &trailing);
+    if (n == 1)
+      tileSize.y = tileSize.x;
+    else if (n != 3 || x != 'x')
+      throw std::runtime_error("invalid tile size '" + str + "' (must be "
+                               "'<n>' or '<width>x<height>')");
+
+    auto isValid = [](int s) {
+      return s > 0 && s <= TILE_SIZE && (s & (s - 1)) == 0;
+    };
+    if (!isValid(tileSize.x) || !isValid(tileSize.y)
+        || tileSize.x * tileSize.y < RENDERTILE_PIXELS_PER_JOB) {
+      throw std::runtime_error("invalid tile size '" + str + "' (width and "
+                               "height must be powers of two <= "
+                               + std::to_string(TILE_SIZE) + ", with at least "
+                               + std::to_string(RENDERTILE_PIXELS_PER_JOB)
+                               + " pixels per tile)");
+    }
+    return tileSize;
   }
 
   vec2i FrameBuffer::getNumTiles() const
@@ -52,6 +91,11 @@ namespace ospray {
     return numTiles.x * numTiles.y;
   }
 
+  int FrameBuffer::tileNode(const vec2i &tile) const
+  {
+    return numa::blockNode(tile.y, numTiles.y, numa::numNodes());
+  }
+
   vec2i FrameBuffer::getNumPixels() const
   {
     return size;
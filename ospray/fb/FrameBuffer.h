@@ -34,11 +34,15 @@ namespace ospray {
                 ColorBufferFormat colorBufferFormat,
                 bool hasDepthBuffer,
                 bool hasAccumBuffer,
-                bool hasVarianceBuffer = false);
+                bool hasVarianceBuffer = false,
+                const vec2i &tileSize = vec2i(TILE_SIZE));
     virtual ~FrameBuffer() = default;
 
     virtual const void *mapDepthBuffer() = 0;
     virtual const void *mapColorBuffer() = 0;
+    //! frame buffers without normal/albedo channels return nullptr
+    virtual const void *mapNormalBuffer() { return nullptr; }
+    virtual const void *mapAlbedoBuffer() { return nullptr; }
 
     virtual void unmap(const void *mappedMem) = 0;
     virtual void setTile(Tile &tile) = 0;
@@ -46,14 +50,28 @@ namespace ospray {
     /*! \brief clear (the specified channels of) this frame buffer */
     virtual void clear(const uint32 fbChannelFlags) = 0;
 
+    /*! whether the tiles rendered into this frame buffer need normal
+        and albedo (an AOVTile), for the channels or the pixel op */
+    bool needsAOVs() const;
+
     //! get number of pixels per tile, in x and y direction
     vec2i getTileSize() const;
 
+    /*! parses a tile size given as "<n>" or "<width>x<height>"; width
+        and height must be powers of two of at most TILE_SIZE (the size
+        tiles are allocated with), and a tile must have at least
+        RENDERTILE_PIXELS_PER_JOB pixels. throws on invalid sizes */
+    static vec2i parseTileSize(const std::string &tileSize);
+
     //! return number of tiles in x and y direction
     vec2i getNumTiles() const;
 
     int getTotalTiles() const;
 
+    /*! the NUMA node that holds (and in 'local' NUMA mode renders) the
+        given tile; rows of tiles are split evenly over the nodes */
+    int tileNode(const vec2i &tile) const;
+
     //! get number of pixels in x and y diretion
     vec2i getNumPixels() const;
 
@@ -74,6 +92,13 @@ namespace ospray {
     virtual std::string toString() const override;
 
     const vec2i size;
+    /*! pixels per tile, chosen at runtime per frame buffer; tiles are
+        always allocated with TILE_SIZE x TILE_SIZE pixels, of which a
+        frame buffer uses the lower left tileSize.x x tileSize.y */
+    const vec2i tileSize;
+
+    //! statistics of the last frame, see ospGetFrameStats()
+    OSPFrameStats frameStats {};
     vec2i numTiles;
     vec2i maxValidPixelID;
 
@@ -84,6 +109,10 @@ namespace ospray {
         an accumulation buffer */
     bool hasAccumBuffer;
     bool hasVarianceBuffer;
+    /*! whether the app requested the (first hit) normal and albedo
+        channels, as written by the renderers into the tiles */
+    bool hasNormalBuffer {false};
+    bool hasAlbedoBuffer {false};
 
     /*! buffer format of the color buffer */
     ColorBufferFormat colorBufferFormat;
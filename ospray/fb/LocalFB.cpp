@@ -17,17 +17,52 @@
 //ospray
 #include "LocalFB.h"
 #include "LocalFB_ispc.h"
+// ospcommon
+#include "ospcommon/numa.h"
+#include "ospcommon/utility/Trace.h"
 
 namespace ospray {
 
+  /*! place the pages of a freshly allocated (not yet touched) per-pixel
+      buffer on the NUMA nodes: in 'local' mode each node gets the rows
+      of tiles it renders, in 'interleave' mode pages are interleaved */
+  static void placePixelBuffer(const FrameBuffer &fb, void *buffer,
+                               size_t bytesPerPixel)
+  {
+    if (!buffer)
+      return;
+
+    const size_t bytesPerRow = bytesPerPixel * fb.size.x;
+    if (numa::mode() != numa::LOCAL) {
+      numa::distribute(buffer, bytesPerRow * fb.size.y);
+      return;
+    }
+
+    const vec2i numTiles = fb.getNumTiles();
+    for (int ty = 0; ty < numTiles.y; ) {
+      const int node = fb.tileNode(vec2i(0, ty));
+      const int begin = ty;
+      while (ty < numTiles.y && fb.tileNode(vec2i(0, ty)) == node)
+        ty++;
+      const size_t firstRow = size_t(begin) * fb.tileSize.y;
+      const size_t endRow   = std::min(size_t(ty) * fb.tileSize.y,
+                                       size_t(fb.size.y));
+      numa::placeOnNode((char*)buffer + firstRow * bytesPerRow,
+                        (endRow - firstRow) * bytesPerRow, node);
+    }
+  }
+
   LocalFrameBuffer::LocalFrameBuffer(const vec2i &size,
                                      ColorBufferFormat colorBufferFormat,
                                      bool hasDepthBuffer,
                                      bool hasAccumBuffer,
                                      bool hasVarianceBuffer,
-                                     void *colorBufferToUse)
+                                     void *colorBufferToUse,
+                                     const vec2i &tileSize,
+                                     bool hasNormalBuffer,
+                                     bool hasAlbedoBuffer)
     : FrameBuffer(size, colorBufferFormat, hasDepthBuffer,
-                  hasAccumBuffer, hasVarianceBuffer)
+                  hasAccumBuffer, hasVarianceBuffer, tileSize)
       , tileErrorRegion(hasVarianceBuffer ? getNumTiles() : vec2i(0))
   {
     Assert(size.x > 0);
@@ -67,13 +102,37 @@ namespace ospray {
                      (vec4f*)alignedMalloc(sizeof(vec4f)*size.x*size.y) :
                      nullptr;
 
+    this->hasNormalBuffer = hasNormalBuffer;
+    normalBuffer = hasNormalBuffer ?
+                   (vec3f*)alignedMalloc(sizeof(vec3f)*size.x*size.y) :
+                   nullptr;
+
+    this->hasAlbedoBuffer = hasAlbedoBuffer;
+    albedoBuffer = hasAlbedoBuffer ?
+                   (vec3f*)alignedMalloc(sizeof(vec3f)*size.x*size.y) :
+                   nullptr;
+
+    if (!colorBufferToUse) {
+      placePixelBuffer(*this, colorBuffer,
+                       colorBufferFormat == OSP_FB_RGBA32F ? sizeof(vec4f)
+                                                           : sizeof(uint32));
+    }
+    placePixelBuffer(*this, depthBuffer, sizeof(float));
+    placePixelBuffer(*this, accumBuffer, sizeof(vec4f));
+    placePixelBuffer(*this, varianceBuffer, sizeof(vec4f));
+    placePixelBuffer(*this, normalBuffer, sizeof(vec3f));
+    placePixelBuffer(*this, albedoBuffer, sizeof(vec3f));
+
     ispcEquivalent = ispc::LocalFrameBuffer_create(this,size.x,size.y,
                                                    colorBufferFormat,
                                                    colorBuffer,
                                                    depthBuffer,
                                                    accumBuffer,
                                                    varianceBuffer,
-                                                   tileAccumID);
+                                                   normalBuffer,
+                                                   albedoBuffer,
+                                                   tileAccumID,
+                                                   tileSize.x, tileSize.y);
   }
 
   LocalFrameBuffer::~LocalFrameBuffer()
@@ -82,6 +141,8 @@ namespace ospray {
     alignedFree(colorBuffer);
     alignedFree(accumBuffer);
     alignedFree(varianceBuffer);
+    alignedFree(normalBuffer);
+    alignedFree(albedoBuffer);
     alignedFree(tileAccumID);
   }
 
@@ -108,16 +169,28 @@ namespace ospray {
 
   void LocalFrameBuffer::setTile(Tile &tile)
   {
-    if (pixelOp)
+    OSPRAY_TRACE_SCOPE("LocalFrameBuffer::setTile");
+
+    if (pixelOp) {
+      OSPRAY_TRACE_SCOPE("PixelOp::preAccum");
       pixelOp->preAccum(tile);
+    }
     if (accumBuffer) {
+      OSPRAY_TRACE_SCOPE("LocalFrameBuffer::accumulateTile");
       const float err = ispc::LocalFrameBuffer_accumulateTile(getIE(),(ispc::Tile&)tile);
       if ((tile.accumID & 1) == 1)
-        tileErrorRegion.update(tile.region.lower/TILE_SIZE, err);
+        tileErrorRegion.update(tile.region.lower/tileSize, err);
     }
-    if (pixelOp)
+    if (tile.aov && (normalBuffer || albedoBuffer)) {
+      OSPRAY_TRACE_SCOPE("LocalFrameBuffer::accumulateAuxTile");
+      ispc::LocalFrameBuffer_accumulateAuxTile(getIE(),(ispc::Tile&)tile);
+    }
+    if (pixelOp) {
+      OSPRAY_TRACE_SCOPE("PixelOp::postAccum");
       pixelOp->postAccum(tile);
+    }
     if (colorBuffer) {
+      OSPRAY_TRACE_SCOPE("LocalFrameBuffer::writeTile");
       switch (colorBufferFormat) {
       case OSP_FB_RGBA8:
         ispc::LocalFrameBuffer_writeTile_RGBA8(getIE(),(ispc::Tile&)tile);
@@ -146,6 +219,7 @@ namespace ospray {
 
   void LocalFrameBuffer::beginFrame()
   {
+    OSPRAY_TRACE_SCOPE("LocalFrameBuffer::beginFrame");
     FrameBuffer::beginFrame();
     if (pixelOp)
       pixelOp->beginFrame();
@@ -153,8 +227,11 @@ namespace ospray {
 
   float LocalFrameBuffer::endFrame(const float errorThreshold)
   {
-    if (pixelOp)
+    if (pixelOp) {
+      OSPRAY_TRACE_SCOPE("PixelOp::endFrame");
       pixelOp->endFrame();
+    }
+    OSPRAY_TRACE_SCOPE("LocalFrameBuffer::refineError");
     return tileErrorRegion.refine(errorThreshold);
   }
 
@@ -170,9 +247,22 @@ namespace ospray {
     return (const void *)colorBuffer;
   }
 
+  const void *LocalFrameBuffer::mapNormalBuffer()
+  {
+    this->refInc();
+    return (const void *)normalBuffer;
+  }
+
+  const void *LocalFrameBuffer::mapAlbedoBuffer()
+  {
+    this->refInc();
+    return (const void *)albedoBuffer;
+  }
+
   void LocalFrameBuffer::unmap(const void *mappedMem)
   {
-    if (!(mappedMem == colorBuffer || mappedMem == depthBuffer)) {
+    if (!(mappedMem == colorBuffer || mappedMem == depthBuffer
+          || mappedMem == normalBuffer || mappedMem == albedoBuffer)) {
       throw std::runtime_error("ERROR: unmapping a pointer not created by "
                                "OSPRay!");
     }
@@ -31,6 +31,8 @@ namespace ospray {
     float     *depthBuffer; /*!< one float per pixel, may be NULL */
     vec4f     *accumBuffer; /*!< one RGBA per pixel, may be NULL */
     vec4f     *varianceBuffer; /*!< one RGBA per pixel, may be NULL, accumulates every other sample, for variance estimation / stopping */
+    vec3f     *normalBuffer; /*!< accumulated first hit normal, may be NULL */
+    vec3f     *albedoBuffer; /*!< accumulated first hit albedo, may be NULL */
     int32     *tileAccumID; //< holds accumID per tile, for adaptive accumulation
     TileError  tileErrorRegion; /*!< holds error per tile and adaptive regions, for variance estimation / stopping */
 
@@ -39,7 +41,10 @@ namespace ospray {
                      bool hasDepthBuffer,
                      bool hasAccumBuffer,
                      bool hasVarianceBuffer,
-                     void *colorBufferToUse=nullptr);
+                     void *colorBufferToUse=nullptr,
+                     const vec2i &tileSize=vec2i(TILE_SIZE),
+                     bool hasNormalBuffer=false,
+                     bool hasAlbedoBuffer=false);
     virtual ~LocalFrameBuffer();
 
     //! \brief common function to help printf-debugging
@@ -54,6 +59,8 @@ namespace ospray {
 
     const void *mapColorBuffer() override;
     const void *mapDepthBuffer() override;
+    const void *mapNormalBuffer() override;
+    const void *mapAlbedoBuffer() override;
     void unmap(const void *mappedMem) override;
     void clear(const uint32 fbChannelFlags) override;
   };
@@ -68,6 +68,10 @@ namespace ospray {
           into the color buffer */
       virtual void postAccum(Tile &tile) { UNUSED(tile); }
 
+      /*! whether this pixel op reads the normal and albedo of the
+          tiles (tile.aov), which renderers only write if requested */
+      virtual bool needsAOVs() const { return false; }
+
       //! \brief common function to help printf-debugging
       /*! Every derived class should overrride this! */
       virtual std::string toString() const;
@@ -23,11 +23,33 @@ namespace ospray {
   static_assert(TILE_SIZE > 0 && (TILE_SIZE & (TILE_SIZE - 1)) == 0,
       "OSPRay config error: TILE_SIZE must be a positive power of two.");
 
+  /*! the "arbitrary output variables" of a tile, i.e., normal and
+      albedo of the first hit, in the same row-major TILE_SIZE x
+      TILE_SIZE layout as the pixels of the tile they belong to. they
+      are kept out of the Tile itself as only the OSP_FB_NORMAL and
+      OSP_FB_ALBEDO channels and the "denoise" pixel op use them */
+  struct OSPRAY_SDK_INTERFACE __aligned(64) AOVTile
+  {
+    // normal of the first hit; in float.
+    float nx[TILE_SIZE*TILE_SIZE];
+    float ny[TILE_SIZE*TILE_SIZE];
+    float nz[TILE_SIZE*TILE_SIZE];
+    // albedo of the first hit; in float.
+    float ar[TILE_SIZE*TILE_SIZE];
+    float ag[TILE_SIZE*TILE_SIZE];
+    float ab[TILE_SIZE*TILE_SIZE];
+
+    //! pooled just like the Tile they get attached to
+    static void *operator new(size_t size) { return alignedMalloc(size); }
+    static void operator delete(void *ptr) { alignedFree(ptr); }
+  };
+
   //! a tile of pixels used by any tile-based renderer
   /*! pixels in the tile are in a row-major TILE_SIZE x TILE_SIZE
       pattern. the 'region' specifies which part of the screen this
       tile belongs to: tile.lower is the lower-left coordinate of this
-      tile (and a multiple of TILE_SIZE); the 'upper' value may be
+      tile (and a multiple of the frame buffer's tile size, which is
+      at most TILE_SIZE in either direction); the 'upper' value may be
       smaller than the upper-right edge of the "full" tile.
 
       note that a tile contains "all" of the values a renderer might
@@ -54,18 +76,29 @@ namespace ospray {
     int32    generation;
     int32    children;
     int32    accumID; //!< how often has been accumulated into this tile
+    /*! the normal and albedo channels of this tile; only attached
+        (and thus only written by the renderers) if the frame buffer
+        needs them, see FrameBuffer::needsAOVs() */
+    AOVTile *aov {nullptr};
 
     Tile() = default;
-    Tile(const vec2i &tile, const vec2i &fbsize, const int32 accumId)
+    Tile(const vec2i &tile, const vec2i &fbsize, const int32 accumId,
+         const vec2i &tileSize = vec2i(TILE_SIZE))
       : fbSize(fbsize),
         rcp_fbSize(rcp(vec2f(fbsize))),
         generation(0),
         children(0),
         accumID(accumId)
     {
-      region.lower = tile * TILE_SIZE;
-      region.upper = ospcommon::min(region.lower + TILE_SIZE, fbsize);
+      region.lower = tile * tileSize;
+      region.upper = ospcommon::min(region.lower + tileSize, fbsize);
     }
+
+    /*! tiles are too large for the task stack and thus always heap
+        allocated (see LocalTiledLoadBalancer), they get recycled
+        through the pooled allocator across tile tasks and frames */
+    static void *operator new(size_t size) { return alignedMalloc(size); }
+    static void operator delete(void *ptr) { alignedFree(ptr); }
   };
 
 } // ::ospray
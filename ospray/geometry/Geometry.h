@@ -57,6 +57,13 @@ namespace ospray {
         model's acceleration structure */
     virtual void finalize(Model *);
 
+    /*! whether finalize() may run concurrently with the finalize() of
+        other geometries of the same model (see the model's
+        'parallelCommit' parameter); it then must only change this
+        geometry's own state, and has to store the geomID of the embree
+        geometry it creates in the ISPC Geometry::geomID */
+    virtual bool finalizeIsThreadSafe() const { return false; }
+
     /*! \brief creates an abstract geometry class of given type
 
       The respective geometry type must be a registered geometry type
@@ -88,7 +88,8 @@ namespace ospray {
                                (ispc::AffineSpace3f&)xfm,
                                (ispc::AffineSpace3f&)rcp_xfm,
                                instancedScene->getIE(),
-                               &areaPDF[0]);
+                               &areaPDF[0],
+                               embreeGeomID);
     for (auto volume : instancedScene->volume) {
       ospSet3f((OSPObject)volume.ptr, "xfm.l.vx", xfm.l.vx.x, xfm.l.vx.y, xfm.l.vx.z);
       ospSet3f((OSPObject)volume.ptr, "xfm.l.vy", xfm.l.vy.x, xfm.l.vy.y, xfm.l.vy.z);
@@ -20,6 +20,7 @@
 #include "StreamLines.h"
 #include "common/Data.h"
 #include "common/Model.h"
+#include "ospcommon/tasking/parallel_for.h"
 // ispc-generated files
 #include "StreamLines_ispc.h"
 
@@ -41,6 +42,7 @@ namespace ospray {
     vertexData = getParamData("vertex",nullptr);
     indexData  = getParamData("index",nullptr);
     colorData  = getParamData("vertex.color",getParamData("color"));
+    native     = getParam1i("native",0);
 
     Assert(radius > 0.f);
     Assert(vertexData);
@@ -55,7 +57,8 @@ namespace ospray {
     postStatusMsg(2) << "#osp: creating streamlines geometry, "
                      << "#verts=" << numVertices << ", "
                      << "#segments=" << numSegments << ", "
-                     << "radius=" << radius;
+                     << "radius=" << radius << ", "
+                     << "native=" << native;
 
     bounds = empty;
     if (vertex) {
@@ -63,9 +66,42 @@ namespace ospray {
         bounds.extend(box3f(vertex[i] - radius, vertex[i] + radius));
     }
 
-    ispc::StreamLines_set(getIE(),model->getIE(),radius, (ispc::vec3fa*)vertex,
-                          numVertices, (uint32_t*)index,numSegments,
-                          (ispc::vec4f*)color);
+    if (native) {
+      // embree's line segments expect the radius in the vertex' w
+      // component, which for the user's vertices is free for other
+      // use, so we need our own (and only) copy of them
+      vertexCurve.resize(numVertices);
+      const size_t blockSize = 64*1024;
+      const int numBlocks = divRoundUp(numVertices, blockSize);
+      tasking::parallel_for(numBlocks, [&](int blockID) {
+        const size_t begin = blockID * blockSize;
+        const size_t end   = std::min(begin + blockSize, numVertices);
+        for (size_t i = begin; i < end; i++) {
+          const vec3fa &v = vertex[i];
+          vertexCurve[i] = vec4f(v.x, v.y, v.z, radius);
+        }
+      });
+
+      RTCScene embreeSceneHandle = model->embreeSceneHandle;
+      const uint32 eLines = rtcNewLineSegments(embreeSceneHandle,
+                                               RTC_GEOMETRY_STATIC,
+                                               numSegments, numVertices);
+      rtcSetBuffer(embreeSceneHandle, eLines, RTC_VERTEX_BUFFER,
+                   vertexCurve.data(), 0, sizeof(vec4f));
+      rtcSetBuffer(embreeSceneHandle, eLines, RTC_INDEX_BUFFER,
+                   (void*)index, 0, sizeof(uint32));
+
+      ispc::StreamLines_setNative(getIE(), model->getIE(), eLines, radius,
+                                  (ispc::vec3fa*)vertex, numVertices,
+                                  (uint32_t*)index, numSegments,
+                                  (ispc::vec4f*)color);
+    } else {
+      vertexCurve.clear();
+      ispc::StreamLines_set(getIE(),model->getIE(),radius,
+                            (ispc::vec3fa*)vertex, numVertices,
+                            (uint32_t*)index,numSegments,
+                            (ispc::vec4f*)color);
+    }
   }
 
   OSP_REGISTER_GEOMETRY(StreamLines,streamlines);
@@ -65,8 +65,19 @@ namespace ospray {
     <dt><li><code>Data<vec3fa> vertex</code></dt><dd> Array of all vertices for *all* curves in this geometry, one curve's vertices stored after another.</dd>
     <dt><li><code>Data<int32>  index </code></dt><dd> index[i] specifies the index of the first vertex of the i'th curve. The curve then uses all following vertices in the 'vertex' array until either the next curve starts, or the array's end is reached.</dd>
     <dt><li><code>Data<vec3fa> color</code></dt><dd> Array of vertex colors corresponding to the vertices in this geometry.</dd>
+    <dt><code>int32        native</code></dt><dd> If non-zero, hand the segments to embree's native line segment primitive instead of intersecting them as user geometry (default: 0)</dd>
     </dl>
 
+    In 'native' mode embree builds its own (vectorized) BVH over the
+    segments and intersects them with its built-in line intersector;
+    the 'index' array is shared with embree directly, and only one
+    additional (x,y,z,radius) copy of the vertices is kept. Embree
+    renders line segments as ray-facing, constant-width strips with
+    round joints rather than as true capsules, which is
+    indistinguishable for the thin lines typical of flow
+    visualization, but much cheaper to build and traverse for large
+    numbers of segments.
+
     The functionality for this geometry is implemented via the
     \ref ospray::StreamLines class.
 
@@ -98,6 +109,11 @@ namespace ospray {
     size_t        numSegments {0};
     const vec4f  *color {nullptr};
     float         radius {0.f};
+
+    //! use embree's native line segments instead of a user geometry
+    bool native {false};
+    //! (x,y,z,radius) vertex copy handed to embree in 'native' mode
+    std::vector<vec4f> vertexCurve;
   };
   /*! @} */
 
@@ -20,6 +20,7 @@
 #include "../include/ospray/ospray.h"
 // ispc exports
 #include "TriangleMesh_ispc.h"
+#include <atomic>
 #include <cmath>
 
 namespace ospray {
@@ -41,14 +42,15 @@ namespace ospray {
 
   void TriangleMesh::finalize(Model *model)
   {
-    static int numPrints = 0;
-    numPrints++;
-    if (numPrints == 5) {
+    // meshes may be finalized in parallel
+    static std::atomic<int> numPrints {0};
+    const int print = ++numPrints;
+    if (print == 5) {
       postStatusMsg(2) << "(all future printouts for triangle mesh creation "
                        << "will be omitted)";
     }
     
-    if (numPrints < 5)
+    if (print < 5)
       postStatusMsg(2) << "ospray: finalizing trianglemesh ...";
 
     Assert(model && "invalid model pointer");
@@ -148,7 +150,7 @@ namespace ospray {
     for (uint32_t i = 0; i < numVerts*numCompsInVtx; i+=numCompsInVtx)
       bounds.extend(*(vec3f*)(vertex + i));
 
-    if (numPrints < 5) {
+    if (print < 5) {
       postStatusMsg(2) << "  created triangle mesh (" << numTris << " tris "
                        << ", " << numVerts << " vertices)\n"
                        << "  mesh bounds " << bounds;
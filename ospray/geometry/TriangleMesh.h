@@ -78,6 +78,8 @@ namespace ospray {
     virtual ~TriangleMesh() = default;
     virtual std::string toString() const override;
     virtual void finalize(Model *model) override;
+    //! only creates its own embree mesh, and reports its geomID
+    virtual bool finalizeIsThreadSafe() const override { return true; }
 
     const int    *index;  //!< mesh's triangle index array
     const float  *vertex; //!< mesh's vertex array
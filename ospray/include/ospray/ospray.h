@@ -90,7 +90,9 @@ typedef enum {
   OSP_FB_COLOR=(1<<0),
   OSP_FB_DEPTH=(1<<1),
   OSP_FB_ACCUM=(1<<2),
-  OSP_FB_VARIANCE=(1<<3)
+  OSP_FB_VARIANCE=(1<<3),
+  OSP_FB_NORMAL=(1<<4),  //!< accumulated world-space normal of the first hit
+  OSP_FB_ALBEDO=(1<<5)   //!< accumulated albedo of the first hit
 } OSPFrameBufferChannel;
 
 /*! flags that can be passed to OSPNewData; can be OR'ed together */
@@ -98,6 +100,11 @@ typedef enum {
   OSP_DATA_SHARED_BUFFER = (1<<0),
 } OSPDataCreationFlags;
 
+/*! callback that OSPRay invokes once it no longer references the
+    memory of a data array created with ospNewSharedData(); 'userData'
+    is the pointer that was passed along with the callback */
+typedef void (*OSPDataDeleter)(void *userData, const void *sharedData);
+
 #ifdef __cplusplus
 namespace osp {
   /*! namespace for classes in the public core API */
@@ -282,6 +289,34 @@ extern "C" {
   /*! commit parameters on a given device */
   OSPRAY_INTERFACE void ospDeviceCommit(OSPDevice);
 
+  /*! statistics of OSPRay's internal memory allocator */
+  typedef struct {
+    uint64_t bytesInUse;             //< requested bytes currently allocated
+    uint64_t peakBytesInUse;         //< maximum of bytesInUse so far
+    uint64_t numAllocations;
+    uint64_t numFrees;
+    uint64_t numPoolHits;            //< allocations served from a pool
+    uint64_t bytesPooled;            //< bytes held unused in the pools
+    uint64_t numHugePageAllocations;
+    uint64_t hugePageBytesInUse;
+  } OSPAllocationStats;
+
+  /*! get the allocation statistics of the given device (for distributed
+      devices: of the application process) */
+  OSPRAY_INTERFACE void ospDeviceGetAllocationStats(OSPDevice,
+                                                    OSPAllocationStats *);
+
+  /*! start recording the following API calls on the current device
+      into a command buffer instead of issuing them one by one.
+      Devices that execute calls locally simply run them right away;
+      calls that have to return a result from the device (e.g.
+      ospRenderFrame, ospPick) still work and submit what has been
+      recorded so far before they execute */
+  OSPRAY_INTERFACE void ospBeginCommandBuffer();
+
+  /*! stop recording and submit all recorded API calls as one batch */
+  OSPRAY_INTERFACE void ospEndCommandBuffer();
+
   //! load plugin 'name' from shard lib libospray_module_<name>.so
   //! returns OSPError value to report any errors during initialization
   OSPRAY_INTERFACE OSPError ospLoadModule(const char *pluginName);
@@ -294,6 +329,26 @@ extern "C" {
                                         OSPRenderer,
                                         const uint32_t frameBufferChannels OSP_DEFAULT_VAL(=OSP_FB_COLOR));
 
+  /*! statistics of the last frame rendered into a frame buffer */
+  typedef struct {
+    uint64_t primaryRays;    //< camera rays (i.e. pixel samples)
+    uint64_t shadowRays;     //< occlusion rays, incl. AO and transparency
+    uint64_t secondaryRays;  //< all other rays (bounces, continuations)
+    uint64_t volumeSamples;
+    uint64_t tilesRendered;
+    uint64_t tilesSkipped;   //< tiles already below the error threshold
+    double commitTime;       //< seconds in ospCommit() since the last frame
+    double renderTime;       //< seconds in ospRenderFrame()
+    double accumulateTime;   //< summed thread time writing/accumulating tiles
+    double compositeTime;    //< seconds waiting for distributed compositing
+    double raysPerSecond;    //< all rays per second of renderTime
+    double samplesPerSecond; //< primary rays per second of renderTime
+  } OSPFrameStats;
+
+  /*! get the statistics of the last frame rendered into the given frame
+      buffer (for distributed devices: the contribution of this rank) */
+  OSPRAY_INTERFACE void ospGetFrameStats(OSPFrameBuffer, OSPFrameStats *);
+
   //! create a new renderer of given type
   /*! return 'NULL' if that type is not known */
   OSPRAY_INTERFACE OSPRenderer ospNewRenderer(const char *type);
@@ -395,6 +450,25 @@ extern "C" {
                                       const void *source,
                                       const uint32_t dataCreationFlags OSP_DEFAULT_VAL(=0));
 
+  /*! create a new data buffer that directly uses (i.e. does not copy)
+      the application's memory at 'sharedData'
+
+    Ownership of the memory stays with the application, but its
+    lifetime is tied to the returned data object: once OSPRay no
+    longer references the memory (i.e. after the last reference to
+    the data object has been released, or, for devices that do not
+    keep the data on the calling process such as 'mpi_offload', as
+    soon as it has been transferred) the optional 'deleter' is called
+    with 'userData' and 'sharedData'. The deleter can thus be used to
+    free "owned" memory, or just to learn when "borrowed" memory may
+    be reused. The memory must stay valid and unchanged until then.
+  */
+  OSPRAY_INTERFACE OSPData ospNewSharedData(size_t numItems,
+                                            OSPDataType,
+                                            const void *sharedData,
+                                            OSPDataDeleter deleter OSP_DEFAULT_VAL(=NULL),
+                                            void *userData OSP_DEFAULT_VAL(=NULL));
+
   /*! \} */
 
 
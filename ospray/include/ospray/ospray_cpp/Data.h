@@ -27,6 +27,8 @@ public:
 
   Data(size_t numItems, OSPDataType format,
        const void *init = nullptr, int flags = 0);
+  Data(size_t numItems, OSPDataType format, const void *sharedData,
+       OSPDataDeleter deleter, void *userData = nullptr);
   Data(const Data &copy);
   Data(OSPData existing);
 };
@@ -39,6 +41,14 @@ inline Data::Data(size_t numItems, OSPDataType format,
   ospObject = ospNewData(numItems, format, init, flags);
 }
 
+inline Data::Data(size_t numItems, OSPDataType format,
+                  const void *sharedData, OSPDataDeleter deleter,
+                  void *userData)
+{
+  ospObject = ospNewSharedData(numItems, format, sharedData,
+                               deleter, userData);
+}
+
 inline Data::Data(const Data &copy) :
   ManagedObject_T<OSPData>(copy.handle())
 {
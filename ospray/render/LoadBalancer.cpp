@@ -17,7 +17,13 @@
 // own
 #include "LoadBalancer.h"
 #include "Renderer.h"
+#include "common/FrameStats.h"
+#include "ospcommon/numa.h"
 #include "ospcommon/tasking/parallel_for.h"
+#include "ospcommon/tasking/tasking_system_handle.h"
+#include "ospcommon/utility/Trace.h"
+// stl
+#include <atomic>
 
 namespace ospray {
 
@@ -31,38 +37,105 @@ namespace ospray {
     Assert(renderer);
     Assert(fb);
 
-    void *perFrameData = renderer->beginFrame(fb);
+    OSPRAY_TRACE_SCOPE("LoadBalancer::renderFrame");
 
-    tasking::parallel_for(fb->getTotalTiles(), [&](int taskIndex) {
+    void *perFrameData = nullptr;
+    {
+      OSPRAY_TRACE_SCOPE("Renderer::beginFrame");
+      perFrameData = renderer->beginFrame(fb);
+    }
+
+    auto renderTile = [&](int taskIndex) {
       const size_t numTiles_x = fb->getNumTiles().x;
       const size_t tile_y = taskIndex / numTiles_x;
       const size_t tile_x = taskIndex - tile_y*numTiles_x;
       const vec2i tileID(tile_x, tile_y);
       const int32 accumID = fb->accumID(tileID);
 
-      if (fb->tileError(tileID) <= renderer->errorThreshold)
+      if (fb->tileError(tileID) <= renderer->errorThreshold) {
+        addRenderCount(RC_TILES_SKIPPED, 1);
         return;
+      }
+
+      OSPRAY_TRACE_SCOPE_ARG("LoadBalancer::renderTile", "tile", taskIndex);
 
-#define MAX_TILE_SIZE 128
-#if TILE_SIZE > MAX_TILE_SIZE
-      auto tilePtr = make_unique<Tile>(tileID, fb->size, accumID);
+      // tiles come from the pooled allocator, i.e., are recycled across
+      // tile tasks and frames instead of being built on the task stack
+      auto tilePtr = make_unique<Tile>(tileID, fb->size, accumID,
+                                       fb->getTileSize());
       auto &tile   = *tilePtr;
-#else
-      Tile __aligned(64) tile(tileID, fb->size, accumID);
-#endif
 
-      tasking::parallel_for(numJobs(renderer->spp, accumID), [&](int tIdx) {
-        renderer->renderTile(perFrameData, tile, tIdx);
-      });
+      // normal and albedo are only rendered if someone is going to use them
+      std::unique_ptr<AOVTile> aovPtr;
+      if (fb->needsAOVs()) {
+        aovPtr   = make_unique<AOVTile>();
+        tile.aov = aovPtr.get();
+      }
+
+      {
+        OSPRAY_TRACE_SCOPE("Renderer::renderTile");
+        const size_t jobs = numJobs(renderer->spp, accumID, fb->getTileSize());
+        tasking::parallel_for(jobs, [&](int tIdx) {
+          renderer->renderTile(perFrameData, tile, tIdx);
+        });
+      }
 
+      const double start = getSysTime();
       fb->setTile(tile);
-    });
+      addRenderCount(RC_ACCUMULATE_NS, uint64((getSysTime() - start) * 1e9));
+      addRenderCount(RC_TILES_RENDERED, 1);
+    };
+
+    if (numa::mode() == numa::LOCAL && numa::numNodes() > 1)
+      renderTilesNodeLocal(fb, renderTile);
+    else
+      tasking::parallel_for(fb->getTotalTiles(), renderTile);
 
-    renderer->endFrame(perFrameData,channelFlags);
+    {
+      OSPRAY_TRACE_SCOPE("Renderer::endFrame");
+      renderer->endFrame(perFrameData,channelFlags);
+    }
 
+    OSPRAY_TRACE_SCOPE("FrameBuffer::endFrame");
     return fb->endFrame(renderer->errorThreshold);
   }
 
+  /*! every node has a queue of the tiles whose framebuffer memory it
+      holds (see FrameBuffer::tileNode()); workers (pinned to their node)
+      first drain the queue of their own node, and only then help out
+      with the tiles of the other nodes */
+  template <typename RENDER_TILE_T>
+  void LocalTiledLoadBalancer::renderTilesNodeLocal(FrameBuffer *fb,
+                                                    RENDER_TILE_T &renderTile)
+  {
+    const int numNodes = numa::numNodes();
+    const vec2i numTiles = fb->getNumTiles();
+
+    // tiles of a node are whole rows of tiles, thus a contiguous range
+    std::vector<int> tileEnd(numNodes, 0);
+    for (int ty = 0; ty < numTiles.y; ty++)
+      tileEnd[fb->tileNode(vec2i(0, ty))] = (ty + 1) * numTiles.x;
+
+    std::unique_ptr<std::atomic<int>[]>
+      nextTile(new std::atomic<int>[numNodes]);
+    for (int n = 0, begin = 0; n < numNodes; n++) {
+      tileEnd[n] = std::max(tileEnd[n], begin);
+      nextTile[n] = begin;
+      begin = tileEnd[n];
+    }
+
+    const int numWorkers = std::max(1, tasking::numTaskingThreads());
+    tasking::parallel_for(numWorkers, [&](int) {
+      const int home = numa::currentNode();
+      for (int i = 0; i < numNodes; i++) {
+        const int node = (home + i) % numNodes;
+        int t;
+        while ((t = nextTile[node]++) < tileEnd[node])
+          renderTile(t);
+      }
+    });
+  }
+
   std::string LocalTiledLoadBalancer::toString() const
   {
     return "ospray::LocalTiledLoadBalancer";
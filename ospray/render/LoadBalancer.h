@@ -34,11 +34,16 @@ namespace ospray {
                               FrameBuffer *fb,
                               const uint32 channelFlags) = 0;
 
-    static size_t numJobs(const int spp, int accumID)
+    /*! number of renderTile() jobs for one tile of the given size;
+        must match the blocks used by Renderer_default_renderTile */
+    static size_t numJobs(const int spp, int accumID,
+                          const vec2i &tileSize = vec2i(TILE_SIZE))
     {
+      const int square = std::min(tileSize.x, tileSize.y);
       const int blocks = (accumID > 0 || spp > 0) ? 1 :
-        std::min(1 << -2 * spp, TILE_SIZE*TILE_SIZE);
-      return divRoundUp((TILE_SIZE*TILE_SIZE)/RENDERTILE_PIXELS_PER_JOB, blocks);
+        std::min(1 << -2 * spp, square*square);
+      return divRoundUp(divRoundUp(tileSize.x*tileSize.y,
+                                   RENDERTILE_PIXELS_PER_JOB), blocks);
     }
   };
 
@@ -54,6 +59,12 @@ namespace ospray {
                       const uint32 channelFlags) override;
 
     std::string toString() const override;
+
+  private:
+
+    /*! render all tiles in 'local' NUMA mode */
+    template <typename RENDER_TILE_T>
+    void renderTilesNodeLocal(FrameBuffer *fb, RENDER_TILE_T &renderTile);
   };
 
 } // ::ospray
@@ -17,6 +17,7 @@
 // ospray
 #include "Renderer.h"
 #include "common/Util.h"
+#include "common/FrameStats.h"
 // ispc exports
 #include "Renderer_ispc.h"
 // ospray
@@ -96,6 +97,7 @@ namespace ospray {
 
   float Renderer::renderFrame(FrameBuffer *fb, const uint32 channelFlags)
   {
+    FrameStatsScope stats(fb->frameStats);
     return TiledLoadBalancer::instance->renderFrame(this,fb,channelFlags);
   }
 
@@ -85,7 +85,7 @@ namespace ospray {
           void* light = ispc::GeometryLight_create(geo->getIE()
               , (const ispc::AffineSpace3f&)xfm
               , (const ispc::AffineSpace3f&)rcp_xfm
-              , areaPDF+i);
+              , areaPDF+model->geomID[i]);
 
           if (light)
             lightArray.push_back(light);
@@ -16,6 +16,8 @@
 
 #include "Texture2D.h"
 #include "Texture2D_ispc.h"
+// ospcommon
+#include "ospcommon/numa.h"
 
 namespace ospray {
 
@@ -48,6 +50,8 @@ namespace ospray {
       tx->data = data;
     } else {
       tx->data = bytes ? new unsigned char[bytes] : NULL;
+      // textures are fetched by all threads, so spread them over all nodes
+      numa::distribute(tx->data, bytes);
       memcpy(tx->data, data, bytes);
     }
 
@@ -15,64 +15,145 @@
 // ======================================================================== //
 
 #include "AMRAccel.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
+// stl
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
 
 namespace ospray {
   namespace amr {
 
+    /*! subtrees with at least this many bricks get their two halves
+        built in parallel */
+    static const size_t PARALLEL_BUILD_THRESHOLD = 256;
+
+    struct AMRAccel::BuildNode
+    {
+      box3f bounds;
+      int   dim {3};
+      float pos {0.f};
+      std::unique_ptr<BuildNode> child[2];
+      //! bricks overlapping this node, for leaves only
+      std::vector<const AMRData::Brick *> brick;
+    };
+
+    /*! FNV-1a hash over the layout (not the values) of all input bricks */
+    static uint64 hashBrickLayout(const AMRData &input)
+    {
+      uint64 hash = 14695981039346656037ull;
+      auto hashBytes = [&](const void *ptr, size_t size) {
+        const unsigned char *bytes = (const unsigned char *)ptr;
+        for (size_t i = 0; i < size; i++) {
+          hash ^= bytes[i];
+          hash *= 1099511628211ull;
+        }
+      };
+      for (const auto &b : input.brick) {
+        hashBytes(&b.box, sizeof(b.box));
+        hashBytes(&b.level, sizeof(b.level));
+        hashBytes(&b.cellWidth, sizeof(b.cellWidth));
+      }
+      return hash;
+    }
+
     /*! constructor that constructs the actual accel from the amr data */
     AMRAccel::AMRAccel(const AMRData &input)
     {
-      box3f bounds = empty;
-      std::vector<const AMRData::Brick *> brickVec;
-      for (auto &b : input.brick) {
-        brickVec.push_back(&b);
-        bounds.extend(b.worldBounds);
-      }
-      this->worldBounds = bounds;
+      buildLevelInfo(input);
+      build(input);
+    }
 
-      for (auto &b : brickVec) {
-        if (b->level >= level.size())
-          level.resize(b->level+1);
-        level[b->level].level = b->level;
-        level[b->level].cellWidth = b->cellWidth;
-        level[b->level].halfCellWidth = 0.5f*b->cellWidth;
-        level[b->level].rcpCellWidth = 1.f/b->cellWidth;
+    AMRAccel::AMRAccel(const AMRData &input, const std::string &cacheFileName)
+    {
+      buildLevelInfo(input);
+      if (load(cacheFileName, input)) {
+        postStatusMsg(1) << "#osp:amr: loaded accel from " << cacheFileName;
+        return;
       }
 
-      node.resize(1);
-      buildRec(0, bounds, brickVec);
+      build(input);
+      if (!save(cacheFileName)) {
+        postStatusMsg(1) << "#osp:amr: could not write accel cache file "
+                         << cacheFileName;
+      }
     }
 
     /*! destructor that frees all allocated memory */
     AMRAccel::~AMRAccel()
     {
-      for (auto &l : leaf)
-        delete [] l.brickList;
-
       leaf.clear();
       node.clear();
     }
 
+    void AMRAccel::buildLevelInfo(const AMRData &input)
+    {
+      worldBounds = empty;
+      for (const auto &b : input.brick) {
+        worldBounds.extend(b.worldBounds);
+        if (b.level >= level.size())
+          level.resize(b.level+1);
+        level[b.level].level = b.level;
+        level[b.level].cellWidth = b.cellWidth;
+        level[b.level].halfCellWidth = 0.5f*b.cellWidth;
+        level[b.level].rcpCellWidth = 1.f/b.cellWidth;
+      }
+
+      firstBrick = input.brick.empty() ? nullptr : &input.brick[0];
+      inputHash  = hashBrickLayout(input);
+    }
+
+    void AMRAccel::build(const AMRData &input)
+    {
+      std::vector<const AMRData::Brick *> brickVec;
+      brickVec.reserve(input.brick.size());
+      for (auto &b : input.brick)
+        brickVec.push_back(&b);
+
+      std::unique_ptr<BuildNode> root = buildRec(worldBounds, brickVec);
+
+      // flatten the tree, children are stored next to each other
+      std::vector<std::vector<const AMRData::Brick *>> lists;
+      node.resize(1);
+      flatten(*root, 0, lists);
+      root.reset();
+
+      // put all leaf lists into one arena, each one sorted from finest
+      // to coarsest, and null-terminated
+      std::vector<size_t> listBegin(lists.size());
+      size_t arenaSize = 0;
+      for (size_t i = 0; i < lists.size(); i++) {
+        listBegin[i] = arenaSize;
+        arenaSize += lists[i].size() + 1;
+      }
+      brickListArena.resize(arenaSize);
+
+      tasking::parallel_for(lists.size(), [&](int leafID) {
+        const auto &list = lists[leafID];
+        const AMRData::Brick **begin = &brickListArena[listBegin[leafID]];
+        std::copy(list.begin(), list.end(), begin);
+        std::sort(begin, begin + list.size(),
+                  [&](const AMRData::Brick *a, const AMRData::Brick *b){
+                    return a->level > b->level;
+                  });
+        begin[list.size()] = nullptr;
+        leaf[leafID].brickList = begin;
+      });
+    }
+
     void AMRAccel::makeLeaf(index_t nodeID,
                             const box3f &bounds,
-                            const std::vector<const AMRData::Brick *> &brick)
+                            size_t numBricks)
     {
       node[nodeID].dim = 3;
-      node[nodeID].ofs = this->leaf.size(); //item.size();
-      node[nodeID].numItems = brick.size();
+      node[nodeID].ofs = this->leaf.size();
+      node[nodeID].numItems = numBricks;
 
       AMRAccel::Leaf newLeaf;
       newLeaf.bounds = bounds;
-      newLeaf.brickList = new const AMRData::Brick *[brick.size()+1];
-
-      // create leaf list, and sort it
-      std::copy(brick.begin(),brick.end(),newLeaf.brickList);
-      std::sort(newLeaf.brickList,newLeaf.brickList+brick.size(),
-                [&](const AMRData::Brick *a, const AMRData::Brick *b){
-                  return a->level > b->level;
-                });
-
-      newLeaf.brickList[brick.size()] = nullptr;
+      newLeaf.brickList = nullptr;
       this->leaf.push_back(newLeaf);
     }
 
@@ -83,28 +164,45 @@ namespace ospray {
       node[nodeID].ofs = childID;
     }
 
-    void AMRAccel::buildRec(int nodeID,
-                            const box3f &bounds,
-                            std::vector<const AMRData::Brick *> &brick)
+    void AMRAccel::flatten(BuildNode &buildNode,
+                           index_t nodeID,
+                           std::vector<std::vector<const AMRData::Brick *>>
+                             &lists)
+    {
+      if (buildNode.dim == 3) {
+        makeLeaf(nodeID, buildNode.bounds, buildNode.brick.size());
+        lists.push_back(std::move(buildNode.brick));
+      } else {
+        const index_t newNodeID = node.size();
+        makeInner(nodeID, buildNode.dim, buildNode.pos, newNodeID);
+        node.resize(newNodeID + 2);
+        flatten(*buildNode.child[0], newNodeID+0, lists);
+        flatten(*buildNode.child[1], newNodeID+1, lists);
+      }
+    }
+
+    std::unique_ptr<AMRAccel::BuildNode>
+    AMRAccel::buildRec(const box3f &bounds,
+                       std::vector<const AMRData::Brick *> &brick)
     {
-      std::set<float> possibleSplits[3];
-      for (int i=0;i<brick.size();i++) {
-        const box3f clipped = intersectionOf(bounds,brick[i]->worldBounds);
+      std::unique_ptr<BuildNode> buildNode(new BuildNode);
+      buildNode->bounds = bounds;
+
+      std::vector<float> possibleSplits[3];
+      for (int dim = 0; dim < 3; dim++)
+        possibleSplits[dim].reserve(2*brick.size());
+
+      for (const auto *b : brick) {
+        const box3f clipped = intersectionOf(bounds, b->worldBounds);
         assert(clipped.lower.x != clipped.upper.x);
         assert(clipped.lower.y != clipped.upper.y);
         assert(clipped.lower.z != clipped.upper.z);
-        if (clipped.lower.x != bounds.lower.x)
-          possibleSplits[0].insert(clipped.lower.x);
-        if (clipped.upper.x != bounds.upper.x)
-          possibleSplits[0].insert(clipped.upper.x);
-        if (clipped.lower.y != bounds.lower.y)
-          possibleSplits[1].insert(clipped.lower.y);
-        if (clipped.upper.y != bounds.upper.y)
-          possibleSplits[1].insert(clipped.upper.y);
-        if (clipped.lower.z != bounds.lower.z)
-          possibleSplits[2].insert(clipped.lower.z);
-        if (clipped.upper.z != bounds.upper.z)
-          possibleSplits[2].insert(clipped.upper.z);
+        for (int dim = 0; dim < 3; dim++) {
+          if (clipped.lower[dim] != bounds.lower[dim])
+            possibleSplits[dim].push_back(clipped.lower[dim]);
+          if (clipped.upper[dim] != bounds.upper[dim])
+            possibleSplits[dim].push_back(clipped.upper[dim]);
+        }
       }
 
       int bestDim = -1;
@@ -121,75 +219,243 @@ namespace ospray {
         // note that by construction the last brick must be the onoe
         // we're looking for (all on a lower level must be earlier in
         // the list)
-        assert(nodeID < this->node.size());
+        buildNode->brick = std::move(brick);
+        return buildNode;
+      }
 
-        makeLeaf(nodeID,bounds,brick);
-      } else {
-        float bestPos = std::numeric_limits<float>::infinity();
-        float mid = bounds.center()[bestDim];
-        for (const auto &split : possibleSplits[bestDim]) {
-          if (fabsf(split - mid) < fabsf(bestPos-mid))
-            bestPos = split;
-        }
-        box3f lBounds = bounds;
-        box3f rBounds = bounds;
-
-        switch(bestDim) {
-        case 0:
-          lBounds.upper.x = bestPos;
-          rBounds.lower.x = bestPos;
-          break;
-        case 1:
-          lBounds.upper.y = bestPos;
-          rBounds.lower.y = bestPos;
-          break;
-        case 2:
-          lBounds.upper.z = bestPos;
-          rBounds.lower.z = bestPos;
-          break;
-        }
+      float bestPos = std::numeric_limits<float>::infinity();
+      float mid = bounds.center()[bestDim];
+      for (const auto &split : possibleSplits[bestDim]) {
+        if (fabsf(split - mid) < fabsf(bestPos-mid))
+          bestPos = split;
+      }
+      box3f lBounds = bounds;
+      box3f rBounds = bounds;
+      lBounds.upper[bestDim] = bestPos;
+      rBounds.lower[bestDim] = bestPos;
 
-        std::vector<const AMRData::Brick *> l, r;
-        float sum_lo = 0.f, sum_hi = 0.f;
-        for (int i=0;i<brick.size();i++) {
-          const box3f wb = intersectionOf(brick[i]->worldBounds,bounds);
-          if (wb.empty())
-            throw std::runtime_error("empty box!?");
-          sum_lo += wb.lower[bestDim];
-          sum_hi += wb.upper[bestDim];
-          if (wb.lower[bestDim] >= bestPos) {
-            r.push_back(brick[i]);
-          } else if (wb.upper[bestDim] <= bestPos) {
-            l.push_back(brick[i]);
-          } else {
-            r.push_back(brick[i]);
-            l.push_back(brick[i]);
-          }
+      std::vector<const AMRData::Brick *> l, r;
+      for (const auto *b : brick) {
+        const box3f wb = intersectionOf(b->worldBounds, bounds);
+        if (wb.empty())
+          throw std::runtime_error("empty box!?");
+        if (wb.lower[bestDim] >= bestPos) {
+          r.push_back(b);
+        } else if (wb.upper[bestDim] <= bestPos) {
+          l.push_back(b);
+        } else {
+          r.push_back(b);
+          l.push_back(b);
         }
-        if (l.empty() || r.empty()) {
-          /* this here "should" never happen since the root level is
-             always completely covered. if we do reach this code we
-             have found a spatial region that doesn't contain *any*
-             brick, so we can be pretty sure that "something" is
-             missing :-/ */
-          std::cerr << "ERROR: found non overlapped node in AMR structure\n";
-          PRINT(bounds);
-          PRINT(bestPos);
-          PRINT(bestDim);
-          PRINT(brick.size());
-        }
-        assert(!(l.empty() || r.empty()));
+      }
+      if (l.empty() || r.empty()) {
+        /* this here "should" never happen since the root level is
+           always completely covered. if we do reach this code we
+           have found a spatial region that doesn't contain *any*
+           brick, so we can be pretty sure that "something" is
+           missing :-/ */
+        std::cerr << "ERROR: found non overlapped node in AMR structure\n";
+        PRINT(bounds);
+        PRINT(bestPos);
+        PRINT(bestDim);
+        PRINT(brick.size());
+      }
+      assert(!(l.empty() || r.empty()));
 
-        int newNodeID = node.size();
-        makeInner(nodeID,bestDim,bestPos,newNodeID);
+      const size_t numBricks = brick.size();
+      brick.clear();
+      brick.shrink_to_fit();
+
+      buildNode->dim = bestDim;
+      buildNode->pos = bestPos;
+
+      if (numBricks >= PARALLEL_BUILD_THRESHOLD) {
+        tasking::parallel_for(2, [&](int side) {
+          buildNode->child[side] = side == 0 ? buildRec(lBounds, l)
+                                             : buildRec(rBounds, r);
+        });
+      } else {
+        buildNode->child[0] = buildRec(lBounds, l);
+        buildNode->child[1] = buildRec(rBounds, r);
+      }
+
+      return buildNode;
+    }
+
+    // ------------------------------------------------------------------
+    // accel cache files
+    // ------------------------------------------------------------------
+
+    static const char  ACCEL_FILE_MAGIC[8]  = {'O','S','P','A','M','R','A','C'};
+    static const int32 ACCEL_FILE_VERSION   = 1;
+
+    struct AccelFileHeader
+    {
+      char   magic[8];
+      int32  version;
+      int32  numLevels;
+      uint64 numBricks;
+      uint64 inputHash;
+      uint64 numNodes;
+      uint64 numLeaves;
+      uint64 arenaSize;
+    };
+
+    bool AMRAccel::save(const std::string &fileName) const
+    {
+      FILE *file = fopen(fileName.c_str(), "wb");
+      if (!file)
+        return false;
+
+      AccelFileHeader header;
+      std::memcpy(header.magic, ACCEL_FILE_MAGIC, sizeof(header.magic));
+      header.version   = ACCEL_FILE_VERSION;
+      header.numLevels = level.size();
+      header.numBricks = 0;
+      header.inputHash = inputHash;
+      header.numNodes  = node.size();
+      header.numLeaves = leaf.size();
+      header.arenaSize = brickListArena.size();
+
+      // bricks are referred to by their index in the input, -1 terminates
+      // a leaf's list
+      std::vector<int64> arena(brickListArena.size());
+      for (size_t i = 0; i < arena.size(); i++) {
+        const auto *b = brickListArena[i];
+        arena[i] = b ? int64(b - firstBrick) : -1;
+        if (b)
+          header.numBricks = std::max<uint64>(header.numBricks, arena[i] + 1);
+      }
+
+      std::vector<box3f> leafBounds(leaf.size());
+      std::vector<uint64> leafBegin(leaf.size());
+      for (size_t i = 0; i < leaf.size(); i++) {
+        leafBounds[i] = leaf[i].bounds;
+        leafBegin[i]  = leaf[i].brickList - brickListArena.data();
+      }
 
-        node.push_back(AMRAccel::Node());
-        node.push_back(AMRAccel::Node());
-        brick.clear();
+      bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(node.data(), sizeof(Node), node.size(), file) == node.size()
+        && fwrite(leafBounds.data(), sizeof(box3f), leafBounds.size(), file)
+           == leafBounds.size()
+        && fwrite(leafBegin.data(), sizeof(uint64), leafBegin.size(), file)
+           == leafBegin.size()
+        && fwrite(arena.data(), sizeof(int64), arena.size(), file)
+           == arena.size();
 
-        buildRec(newNodeID+0,lBounds,l);
-        buildRec(newNodeID+1,rBounds,r);
+      ok = (fclose(file) == 0) && ok;
+      if (!ok)
+        std::remove(fileName.c_str());
+      return ok;
+    }
+
+    bool AMRAccel::load(const std::string &fileName, const AMRData &input)
+    {
+      FILE *file = fopen(fileName.c_str(), "rb");
+      if (!file)
+        return false;
+
+      uint64 fileSize = 0;
+      if (fseek(file, 0, SEEK_END) == 0) {
+        const long end = ftell(file);
+        fileSize = end < 0 ? 0 : uint64(end);
+      }
+      rewind(file);
+
+      AccelFileHeader header;
+      bool ok = fread(&header, sizeof(header), 1, file) == 1
+        && std::memcmp(header.magic, ACCEL_FILE_MAGIC, sizeof(header.magic))
+           == 0
+        && header.version == ACCEL_FILE_VERSION
+        && header.numLevels == int32(level.size())
+        && header.numBricks <= input.brick.size()
+        && header.inputHash == inputHash
+        && header.numNodes > 0;
+
+      // the counts must match the file size before anything gets
+      // allocated (each check bounds the count, so nothing overflows)
+      if (ok) {
+        uint64 remaining = fileSize - std::min<uint64>(fileSize, sizeof(header));
+        auto take = [&](uint64 count, uint64 bytesPerItem) {
+          if (count > remaining / bytesPerItem)
+            return false;
+          remaining -= count * bytesPerItem;
+          return true;
+        };
+        ok = take(header.numNodes, sizeof(Node))
+          && take(header.numLeaves, sizeof(box3f) + sizeof(uint64))
+          && take(header.arenaSize, sizeof(int64))
+          && remaining == 0;
+      }
+
+      std::vector<Node> nodes;
+      std::vector<box3f> leafBounds;
+      std::vector<uint64> leafBegin;
+      std::vector<int64> arena;
+
+      if (ok) {
+        nodes.resize(header.numNodes);
+        leafBounds.resize(header.numLeaves);
+        leafBegin.resize(header.numLeaves);
+        arena.resize(header.arenaSize);
+        ok = fread(nodes.data(), sizeof(Node), nodes.size(), file)
+             == nodes.size()
+          && fread(leafBounds.data(), sizeof(box3f), leafBounds.size(), file)
+             == leafBounds.size()
+          && fread(leafBegin.data(), sizeof(uint64), leafBegin.size(), file)
+             == leafBegin.size()
+          && fread(arena.data(), sizeof(int64), arena.size(), file)
+             == arena.size();
+      }
+      fclose(file);
+
+      // a stale or corrupt file must not make the accel (or its
+      // traversal) index out of bounds; validate every index first
+
+      // bricks are -1 (end of list) or valid input brick IDs
+      for (size_t i = 0; i < arena.size() && ok; i++)
+        ok = arena[i] >= -1 && arena[i] < int64(input.brick.size());
+
+      // each leaf's list is non-empty and terminated inside the arena
+      std::vector<uint32> listSize(leafBegin.size(), 0);
+      for (size_t i = 0; i < leafBegin.size() && ok; i++) {
+        size_t end = leafBegin[i];
+        while (end < arena.size() && arena[end] >= 0)
+          end++;
+        ok = leafBegin[i] < end && end < arena.size();
+        if (ok)
+          listSize[i] = end - leafBegin[i];
+      }
+
+      // inner nodes point to their two children further down the array
+      // (i.e., the tree has no cycles), leaves to a leaf with as many
+      // bricks as the node claims
+      for (size_t i = 0; i < nodes.size() && ok; i++) {
+        const Node &n = nodes[i];
+        if (n.isLeaf()) {
+          ok = n.ofs < leafBegin.size() && n.numItems == listSize[n.ofs];
+        } else {
+          ok = n.ofs > i && uint64(n.ofs) + 1 < nodes.size();
+        }
+      }
+
+      if (!ok) {
+        postStatusMsg(1) << "#osp:amr: ignoring invalid or stale accel cache "
+                         << fileName;
+        return false;
+      }
+
+      node.swap(nodes);
+      brickListArena.resize(arena.size());
+      for (size_t i = 0; i < arena.size(); i++) {
+        brickListArena[i] = arena[i] < 0 ? nullptr : &input.brick[arena[i]];
+      }
+      leaf.resize(leafBounds.size());
+      for (size_t i = 0; i < leaf.size(); i++) {
+        leaf[i].bounds    = leafBounds[i];
+        leaf[i].brickList = brickListArena.data() + leafBegin[i];
       }
+      return true;
     }
 
   } // ::ospray::amr
@@ -31,9 +31,17 @@ namespace ospray {
     {
       /*! constructor that constructs the actual accel from the amr data */
       AMRAccel(const AMRData &input);
+      /*! constructor that loads the accel from 'cacheFileName' if that
+          holds an accel built over the same bricks, and otherwise builds
+          it from the amr data and tries to write it to that file */
+      AMRAccel(const AMRData &input, const std::string &cacheFileName);
       /*! destructor that frees all allocated memory */
       ~AMRAccel();
 
+      /*! write the built accel to 'fileName' (bricks are stored as
+          indices into the input data), returns false on failure */
+      bool save(const std::string &fileName) const;
+
       /*! precomputed values per level, so we can easily compute
           logicla coordinates, find any level's cell width, etc */
       struct Level
@@ -89,7 +97,7 @@ namespace ospray {
         };
       };
 
-      void buildLevelInfo();
+      void buildLevelInfo(const AMRData &input);
 
       inline const Level &finestLevel() const { return level.back(); }
 
@@ -103,13 +111,28 @@ namespace ospray {
       box3f worldBounds;
 
     private:
-      void makeLeaf(index_t nodeID,
-                    const box3f &bounds,
-                    const std::vector<const AMRData::Brick *> &brickIDs);
+
+      /*! temporary, pointer-based tree the (parallel) build produces,
+          which then gets flattened into node[] and leaf[] */
+      struct BuildNode;
+
+      void build(const AMRData &input);
+      bool load(const std::string &fileName, const AMRData &input);
+
+      std::unique_ptr<BuildNode>
+      buildRec(const box3f &bounds,
+               std::vector<const AMRData::Brick *> &brick);
+      void flatten(BuildNode &buildNode, index_t nodeID,
+                   std::vector<std::vector<const AMRData::Brick *>> &lists);
+      void makeLeaf(index_t nodeID, const box3f &bounds, size_t numBricks);
       void makeInner(index_t nodeID, int dim, float pos, int childID);
-      void buildRec(int nodeID,const box3f &bounds,
-                    std::vector<const AMRData::Brick *> &brick);
 
+      /*! storage of all leaves' (null-terminated) brickLists */
+      std::vector<const AMRData::Brick *> brickListArena;
+      /*! first brick of the input, to map brick pointers to indices */
+      const AMRData::Brick *firstBrick {nullptr};
+      /*! hash of the input brick layout, identifies cached accels */
+      uint64 inputHash {0};
     };
 
   } // ::ospray::amr
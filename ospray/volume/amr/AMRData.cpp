@@ -49,6 +49,7 @@ namespace ospray {
       auto numBricks = getNumBricks(brickInfoData);
       const BrickInfo *brickInfo = (const BrickInfo *)brickInfoData.data;
       const Data **allBricksData = (const Data **)brickDataData.data;
+      brick.reserve(numBricks);
       for (int i = 0; i < numBricks; i++)
         brick.emplace_back(brickInfo[i], (const float*)allBricksData[i]->data);
     }
@@ -77,6 +77,9 @@ namespace ospray {
       else if (methodString == "octant")
         ispc::AMR_install_octant(getIE());
 
+      if (!getParam1i("coherentSampling", true))
+        ispc::AMRVolume_disableCoherentSampling(getIE());
+
       if (data != nullptr) //TODO: support data updates
         return;
 
@@ -89,7 +92,14 @@ namespace ospray {
       assert(brickDataData->data);
 
       data  = make_unique<amr::AMRData>(*brickInfoData,*brickDataData);
-      accel = make_unique<amr::AMRAccel>(*data);
+
+      // optionally load the accel from (or store it to) a cache file, so
+      // re-opening large data sets doesn't need to rebuild it
+      const std::string accelCacheFile = getParamString("accelCacheFile", "");
+      if (accelCacheFile.empty())
+        accel = make_unique<amr::AMRAccel>(*data);
+      else
+        accel = make_unique<amr::AMRAccel>(*data, accelCacheFile);
 
       // finding coarset cell size + finest level cell width
       float coarsestCellWidth = 0.f;
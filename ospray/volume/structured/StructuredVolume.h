@@ -115,22 +115,25 @@ namespace ospray {
                                                const vec3i &regionSize,
                                                const vec3i &scaledRegionSize)
   {
-    for (int z = 0; z < scaledRegionSize.z; ++z) {
-      const auto nTasks = scaledRegionSize.x * scaledRegionSize.y;
-
-      tasking::parallel_for(nTasks, [&](int taskID) {
-        int x = taskID % scaledRegionSize.x;
-        int y = taskID / scaledRegionSize.x;
-        const int idx =
-            static_cast<int>(z / scaleFactor.z) * regionSize.x * regionSize.y
-            + static_cast<int>(y / scaleFactor.y) * regionSize.x
-            + static_cast<int>(x / scaleFactor.x);
-
-        const auto outIdx = z * scaledRegionSize.y * scaledRegionSize.x
-                            + y * scaledRegionSize.x + x;
-        out[outIdx] = source[idx];
-      });
-    }
+    // the source x of each output x is the same for all rows
+    std::vector<int> sourceX(scaledRegionSize.x);
+    for (int x = 0; x < scaledRegionSize.x; ++x)
+      sourceX[x] = static_cast<int>(x / scaleFactor.x);
+
+    const int nTasks = scaledRegionSize.y * scaledRegionSize.z;
+    tasking::parallel_for(nTasks, [&](int taskID) {
+      const int y = taskID % scaledRegionSize.y;
+      const int z = taskID / scaledRegionSize.y;
+
+      const T *sourceRow = source + regionSize.x *
+          (static_cast<int>(y / scaleFactor.y) + size_t(regionSize.y) *
+           static_cast<int>(z / scaleFactor.z));
+      T *outRow = out + scaledRegionSize.x *
+          (y + size_t(scaledRegionSize.y) * z);
+
+      for (int x = 0; x < scaledRegionSize.x; ++x)
+        outRow[x] = sourceRow[sourceX[x]];
+    });
   }
 
 } // ::ospray
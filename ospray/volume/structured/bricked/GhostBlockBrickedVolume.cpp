@@ -18,6 +18,7 @@
 #include "GhostBlockBrickedVolume.h"
 #include "GhostBlockBrickedVolume_ispc.h"
 // ospcommon
+#include "ospcommon/numa.h"
 #include "ospcommon/tasking/parallel_for.h"
 
 namespace ospray {
@@ -76,9 +77,13 @@ namespace ospray {
     void *finalSource = const_cast<void*>(source);
     const bool upsampling = scaleRegion(source, finalSource,
                                         finalRegionSize, finalRegionCoords);
-    // Copy voxel data into the volume.
-    const int NTASKS = finalRegionSize.y * finalRegionSize.z;
-    tasking::parallel_for(NTASKS, [&](int taskIndex){
+    // Copy voxel data into the volume, one task per block of the volume
+    // that the region overlaps.
+    const int NTASKS =
+        ispc::GBBV_numRegionBlocks(ispcEquivalent,
+                                   (const ispc::vec3i&)finalRegionCoords,
+                                   (const ispc::vec3i&)finalRegionSize);
+    tasking::parallel_for(NTASKS, [&](int taskIndex) {
         ispc::GBBV_setRegion(ispcEquivalent,
                              finalSource,
                              (const ispc::vec3i&)finalRegionCoords,
@@ -114,6 +119,19 @@ namespace ospray {
     ispcEquivalent = ispc::GBBV_createInstance(this,
                                          (int)getVoxelType(),
                                          (const ispc::vec3i &)this->dimensions);
+
+    // Touch the block memory from all threads, so that on NUMA systems its
+    // pages get spread over all nodes rather than all landing on the node
+    // of whichever threads happen to write the first regions. With a NUMA
+    // mode set the pages are explicitly interleaved before that.
+    uint64 numBytes = 0;
+    void *blockMem = ispc::GBBV_blockMemory(ispcEquivalent, numBytes);
+    numa::distribute(blockMem, numBytes);
+
+    const int numBlocks = ispc::GBBV_numBlocks(ispcEquivalent);
+    tasking::parallel_for(numBlocks, [&](int blockID) {
+      ispc::GBBV_clearBlock(ispcEquivalent, blockID);
+    });
   }
 
 #ifdef EXP_NEW_BB_VOLUME_KERNELS
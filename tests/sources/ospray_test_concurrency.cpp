@@ -0,0 +1,254 @@
+#include <ospray/ospray.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Objects are created, set and committed from several threads at once;
+// every thread works on its own objects, the only shared object is the
+// (read-only) quad index array.
+
+namespace {
+
+const int numThreads = 8;
+const int gridSize   = 16; // gridSize^2 quads, one triangle mesh each
+const int pixelsPerQuad = 16;
+
+osp::vec3f quadColor(int quad) {
+  return osp::vec3f{((quad % gridSize) * 16 + 8) / 255.f,
+                    ((quad / gridSize) * 16 + 8) / 255.f,
+                    0.5f};
+}
+
+OSPGeometry createQuad(int quad, OSPData index) {
+  const float x = quad % gridSize;
+  const float y = quad / gridSize;
+  const float vertices[] = { x,     y,     0.f,
+                             x+1.f, y,     0.f,
+                             x+1.f, y+1.f, 0.f,
+                             x,     y+1.f, 0.f };
+  const osp::vec3f c = quadColor(quad);
+  const float colors[] = { c.x, c.y, c.z, 1.f,
+                           c.x, c.y, c.z, 1.f,
+                           c.x, c.y, c.z, 1.f,
+                           c.x, c.y, c.z, 1.f };
+
+  OSPGeometry mesh = ospNewGeometry("triangles");
+  OSPData data = ospNewData(4, OSP_FLOAT3, vertices);
+  ospCommit(data);
+  ospSetData(mesh, "vertex", data);
+  ospRelease(data);
+  data = ospNewData(4, OSP_FLOAT4, colors);
+  ospCommit(data);
+  ospSetData(mesh, "vertex.color", data);
+  ospRelease(data);
+  ospSetData(mesh, "index", index);
+  ospCommit(mesh);
+
+  return mesh;
+}
+
+OSPData createQuadIndex() {
+  const int32_t indices[] = { 0, 1, 2,
+                              0, 2, 3 };
+  OSPData index = ospNewData(2, OSP_INT3, indices);
+  ospCommit(index);
+  return index;
+}
+
+// runs fcn(thread) on numThreads threads
+template <typename F>
+void runThreads(F fcn) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++)
+    threads.emplace_back(fcn, t);
+  for (auto &thread : threads)
+    thread.join();
+}
+
+// renders the model from the top and checks that each quad in 'quads'
+// shows colorOf(quad) and all other quads the background
+void checkRenderedQuads(OSPModel model, const std::vector<bool> &quads,
+                        osp::vec3f (*colorOf)(int) = quadColor) {
+  const osp::vec2i size{gridSize * pixelsPerQuad, gridSize * pixelsPerQuad};
+
+  OSPCamera camera = ospNewCamera("orthographic");
+  ospSet3f(camera, "pos", gridSize / 2.f, gridSize / 2.f, -1.f);
+  ospSet3f(camera, "dir", 0.f, 0.f, 1.f);
+  ospSet3f(camera, "up", 0.f, 1.f, 0.f);
+  ospSet1f(camera, "height", gridSize);
+  ospSet1f(camera, "aspect", 1.f);
+  ospCommit(camera);
+
+  OSPRenderer renderer = ospNewRenderer("eyeLight_vertexColor");
+  ospSetObject(renderer, "model", model);
+  ospSetObject(renderer, "camera", camera);
+  ospCommit(renderer);
+
+  OSPFrameBuffer fb = ospNewFrameBuffer(size, OSP_FB_RGBA8, OSP_FB_COLOR);
+  ospRenderFrame(fb, renderer, OSP_FB_COLOR);
+
+  auto *pixels = (const uint8_t*)ospMapFrameBuffer(fb, OSP_FB_COLOR);
+  int wrongQuads = 0;
+  for (int quad = 0; quad < gridSize * gridSize; quad++) {
+    const int px = (quad % gridSize) * pixelsPerQuad + pixelsPerQuad / 2;
+    const int py = (quad / gridSize) * pixelsPerQuad + pixelsPerQuad / 2;
+    const uint8_t *pixel = pixels + 4 * (py * size.x + px);
+    const osp::vec3f c = quads[quad] ? colorOf(quad) : osp::vec3f{0.f, 0.f, 0.f};
+    const int expected[] = {int(c.x * 255.f + .5f),
+                            int(c.y * 255.f + .5f),
+                            int(c.z * 255.f + .5f)};
+    for (int i = 0; i < 3; i++) {
+      if (std::abs(pixel[i] - expected[i]) > 2) {
+        wrongQuads++;
+        break;
+      }
+    }
+  }
+  ospUnmapFrameBuffer(pixels, fb);
+
+  EXPECT_EQ(wrongQuads, 0);
+
+  ospRelease(fb);
+  ospRelease(renderer);
+  ospRelease(camera);
+}
+
+// an invisible volume, instances write their transform into it
+OSPVolume createVolume() {
+  const float voxels[8] = {0.f, 1.f, 0.f, 1.f, 0.f, 1.f, 0.f, 1.f};
+  OSPVolume volume = ospNewVolume("shared_structured_volume");
+  OSPData data = ospNewData(8, OSP_FLOAT, voxels);
+  ospCommit(data);
+  ospSetData(volume, "voxelData", data);
+  ospRelease(data);
+  ospSet3i(volume, "dimensions", 2, 2, 2);
+  ospSetString(volume, "voxelType", "float");
+
+  OSPTransferFunction transferFunction = ospNewTransferFunction("piecewise_linear");
+  ospSet2f(transferFunction, "valueRange", 0.f, 1.f);
+  const float colors[] = {1.f, 1.f, 1.f, 1.f, 1.f, 1.f};
+  const float opacities[] = {0.f, 0.f};
+  data = ospNewData(2, OSP_FLOAT3, colors);
+  ospSetData(transferFunction, "colors", data);
+  ospRelease(data);
+  data = ospNewData(2, OSP_FLOAT, opacities);
+  ospSetData(transferFunction, "opacities", data);
+  ospRelease(data);
+  ospCommit(transferFunction);
+  ospSetObject(volume, "transferFunction", transferFunction);
+  ospRelease(transferFunction);
+
+  ospCommit(volume);
+  return volume;
+}
+
+// the first row are instances of quad 0
+osp::vec3f instancedQuadColor(int quad) {
+  return quadColor(quad < gridSize ? 0 : quad);
+}
+
+} // namespace
+
+TEST(Concurrency, createAndCommitGeometries) {
+  OSPData index = createQuadIndex();
+
+  std::vector<OSPGeometry> meshes(gridSize * gridSize, nullptr);
+  runThreads([&](int thread) {
+    for (size_t quad = thread; quad < meshes.size(); quad += numThreads)
+      meshes[quad] = createQuad(quad, index);
+  });
+
+  EXPECT_EQ(ospDeviceGetLastErrorCode(ospGetCurrentDevice()), OSP_NO_ERROR);
+
+  // committing the model finalizes its geometries in parallel
+  OSPModel model = ospNewModel();
+  ospSet1i(model, "parallelCommit", 1);
+  for (auto mesh : meshes) {
+    ASSERT_TRUE(mesh);
+    ospAddGeometry(model, mesh);
+    ospRelease(mesh);
+  }
+  ospCommit(model);
+
+  checkRenderedQuads(model, std::vector<bool>(meshes.size(), true));
+
+  ospRelease(model);
+  ospRelease(index);
+}
+
+TEST(Concurrency, commitModels) {
+  OSPData index = createQuadIndex();
+
+  std::vector<OSPModel> models(numThreads, nullptr);
+  runThreads([&](int thread) {
+    OSPModel model = ospNewModel();
+    for (int quad = thread; quad < gridSize * gridSize; quad += numThreads) {
+      OSPGeometry mesh = createQuad(quad, index);
+      ospAddGeometry(model, mesh);
+      ospRelease(mesh);
+    }
+    ospCommit(model);
+    models[thread] = model;
+  });
+
+  EXPECT_EQ(ospDeviceGetLastErrorCode(ospGetCurrentDevice()), OSP_NO_ERROR);
+
+  for (int thread = 0; thread < numThreads; thread++) {
+    ASSERT_TRUE(models[thread]);
+    std::vector<bool> quads(gridSize * gridSize, false);
+    for (size_t quad = thread; quad < quads.size(); quad += numThreads)
+      quads[quad] = true;
+    checkRenderedQuads(models[thread], quads);
+    ospRelease(models[thread]);
+  }
+
+  ospRelease(index);
+}
+
+TEST(Concurrency, instancesOfModelWithVolume) {
+  OSPData index = createQuadIndex();
+
+  // quad 0 and a volume, instanced along the first row of the grid
+  OSPModel instanced = ospNewModel();
+  OSPGeometry mesh = createQuad(0, index);
+  ospAddGeometry(instanced, mesh);
+  ospRelease(mesh);
+  OSPVolume volume = createVolume();
+  ospAddVolume(instanced, volume);
+  ospRelease(volume);
+  ospCommit(instanced);
+
+  // committing the model finalizes the instances, which all update the
+  // shared volume, after the meshes of the second row got finalized in
+  // parallel
+  OSPModel model = ospNewModel();
+  ospSet1i(model, "parallelCommit", 1);
+  std::vector<bool> quads(gridSize * gridSize, false);
+  for (int quad = gridSize; quad < 2 * gridSize; quad++) {
+    OSPGeometry mesh = createQuad(quad, index);
+    ospAddGeometry(model, mesh);
+    ospRelease(mesh);
+    quads[quad] = true;
+  }
+  for (int i = 0; i < gridSize; i++) {
+    const osp::affine3f xfm = {{{1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 1.f}},
+                               {float(i), 0.f, 0.f}};
+    OSPGeometry instance = ospNewInstance(instanced, xfm);
+    ospAddGeometry(model, instance);
+    ospRelease(instance);
+    quads[i] = true;
+  }
+
+  for (int commits = 0; commits < 8; commits++)
+    ospCommit(model);
+
+  EXPECT_EQ(ospDeviceGetLastErrorCode(ospGetCurrentDevice()), OSP_NO_ERROR);
+
+  checkRenderedQuads(model, quads, instancedQuadColor);
+
+  ospRelease(model);
+  ospRelease(instanced);
+  ospRelease(index);
+}
@@ -0,0 +1,241 @@
+#include <ospray/ospray.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+
+// The normal and albedo channels and the "denoise" pixel op, mostly with a
+// quad in the left half of the (orthographic) view.
+
+namespace {
+
+const osp::vec2i size{64, 64};
+const osp::vec3f quadAlbedo{0.8f, 0.4f, 0.2f};
+
+OSPGeometry createQuad(float x0, float y0, float x1, float y1, float z,
+                       const osp::vec3f &c) {
+  const float vertices[] = { x0, y0, z,
+                             x1, y0, z,
+                             x1, y1, z,
+                             x0, y1, z };
+  const float colors[] = { c.x, c.y, c.z, 1.f,
+                           c.x, c.y, c.z, 1.f,
+                           c.x, c.y, c.z, 1.f,
+                           c.x, c.y, c.z, 1.f };
+  const int32_t indices[] = { 0, 1, 2,
+                              0, 2, 3 };
+
+  OSPGeometry mesh = ospNewGeometry("triangles");
+  OSPData data = ospNewData(4, OSP_FLOAT3, vertices);
+  ospCommit(data);
+  ospSetData(mesh, "vertex", data);
+  ospRelease(data);
+  data = ospNewData(4, OSP_FLOAT4, colors);
+  ospCommit(data);
+  ospSetData(mesh, "vertex.color", data);
+  ospRelease(data);
+  data = ospNewData(2, OSP_INT3, indices);
+  ospCommit(data);
+  ospSetData(mesh, "index", data);
+  ospRelease(data);
+  ospCommit(mesh);
+
+  return mesh;
+}
+
+// the view is [0..2]x[0..2], seen from z=-1 along +z
+OSPRenderer createRenderer(OSPModel model, const char *type = "ao") {
+  OSPCamera camera = ospNewCamera("orthographic");
+  ospSet3f(camera, "pos", 1.f, 1.f, -1.f);
+  ospSet3f(camera, "dir", 0.f, 0.f, 1.f);
+  ospSet3f(camera, "up", 0.f, 1.f, 0.f);
+  ospSet1f(camera, "height", 2.f);
+  ospSet1f(camera, "aspect", 1.f);
+  ospCommit(camera);
+
+  OSPRenderer renderer = ospNewRenderer(type);
+  ospSet1i(renderer, "aoSamples", 1);
+  ospSetObject(renderer, "model", model);
+  ospSetObject(renderer, "camera", camera);
+  ospCommit(renderer);
+  ospRelease(camera);
+
+  return renderer;
+}
+
+OSPModel createQuadModel() {
+  OSPModel model = ospNewModel();
+  OSPGeometry quad = createQuad(0.f, 0.f, 1.f, 2.f, 0.f, quadAlbedo);
+  ospAddGeometry(model, quad);
+  ospRelease(quad);
+  ospCommit(model);
+  return model;
+}
+
+// renders one frame into a new RGBA32F frame buffer, optionally denoised
+OSPFrameBuffer renderFrame(OSPRenderer renderer, bool denoise) {
+  OSPFrameBuffer fb = ospNewFrameBuffer(size, OSP_FB_RGBA32F, OSP_FB_COLOR);
+  if (denoise) {
+    OSPPixelOp op = ospNewPixelOp("denoise");
+    ospCommit(op);
+    ospSetPixelOp(fb, op);
+    ospRelease(op);
+  }
+  ospFrameBufferClear(fb, OSP_FB_COLOR);
+  ospRenderFrame(fb, renderer, OSP_FB_COLOR);
+  return fb;
+}
+
+void expectVec3f(const float *v, const osp::vec3f &expected) {
+  EXPECT_NEAR(v[0], expected.x, 1e-3f);
+  EXPECT_NEAR(v[1], expected.y, 1e-3f);
+  EXPECT_NEAR(v[2], expected.z, 1e-3f);
+}
+
+// mean of the red channel and the mean absolute difference between
+// horizontal neighbors (i.e., the noise) in the given pixel region
+void measureRegion(const float *rgba, int x0, int y0, int x1, int y1,
+                   float &mean, float &noise) {
+  double sum = 0.0, diff = 0.0;
+  int n = 0;
+  for (int y = y0; y < y1; y++) {
+    for (int x = x0; x < x1; x++) {
+      const float r = rgba[4 * (y * size.x + x)];
+      sum  += r;
+      diff += std::abs(rgba[4 * (y * size.x + x + 1)] - r);
+      n++;
+    }
+  }
+  mean  = sum / n;
+  noise = diff / n;
+}
+
+} // namespace
+
+TEST(FrameBuffer, mapNormalAndAlbedo) {
+  OSPModel model = createQuadModel();
+  OSPRenderer renderer = createRenderer(model);
+
+  const uint32_t channels = OSP_FB_COLOR | OSP_FB_ACCUM
+                            | OSP_FB_NORMAL | OSP_FB_ALBEDO;
+  OSPFrameBuffer fb = ospNewFrameBuffer(size, OSP_FB_RGBA8, channels);
+  ospFrameBufferClear(fb, channels);
+  // the channels hold the average over the accumulated frames
+  for (int frame = 0; frame < 2; frame++)
+    ospRenderFrame(fb, renderer, channels);
+
+  auto *normal = (const float*)ospMapFrameBuffer(fb, OSP_FB_NORMAL);
+  auto *albedo = (const float*)ospMapFrameBuffer(fb, OSP_FB_ALBEDO);
+  ASSERT_TRUE(normal);
+  ASSERT_TRUE(albedo);
+
+  // facing the camera, and the vertex color
+  const int onQuad = size.y / 2 * size.x + size.x / 4;
+  expectVec3f(normal + 3 * onQuad, osp::vec3f{0.f, 0.f, -1.f});
+  expectVec3f(albedo + 3 * onQuad, quadAlbedo);
+
+  // no hit: zero normal and unit albedo
+  const int background = size.y / 2 * size.x + 3 * size.x / 4;
+  expectVec3f(normal + 3 * background, osp::vec3f{0.f, 0.f, 0.f});
+  expectVec3f(albedo + 3 * background, osp::vec3f{1.f, 1.f, 1.f});
+
+  ospUnmapFrameBuffer(albedo, fb);
+  ospUnmapFrameBuffer(normal, fb);
+
+  EXPECT_EQ(ospDeviceGetLastErrorCode(ospGetCurrentDevice()), OSP_NO_ERROR);
+
+  ospRelease(fb);
+  ospRelease(renderer);
+  ospRelease(model);
+}
+
+TEST(FrameBuffer, noNormalAndAlbedoUnlessRequested) {
+  OSPFrameBuffer fb = ospNewFrameBuffer(size, OSP_FB_RGBA8, OSP_FB_COLOR);
+  EXPECT_FALSE(ospMapFrameBuffer(fb, OSP_FB_NORMAL));
+  EXPECT_FALSE(ospMapFrameBuffer(fb, OSP_FB_ALBEDO));
+  ospRelease(fb);
+}
+
+TEST(FrameBuffer, denoiseKeepsNoiseFreeImage) {
+  // noise free, and without normals the depth has to stop the filter
+  OSPModel model = createQuadModel();
+  OSPRenderer renderer = createRenderer(model, "eyeLight_vertexColor");
+
+  OSPFrameBuffer reference = renderFrame(renderer, false);
+  OSPFrameBuffer denoised  = renderFrame(renderer, true);
+
+  EXPECT_EQ(ospDeviceGetLastErrorCode(ospGetCurrentDevice()), OSP_NO_ERROR);
+
+  auto *expected = (const float*)ospMapFrameBuffer(reference, OSP_FB_COLOR);
+  auto *color    = (const float*)ospMapFrameBuffer(denoised, OSP_FB_COLOR);
+
+  // the filter must neither blur across the edge of the quad nor change
+  // its (constant) color; pixels at the edge itself are antialiased
+  int wrongPixels = 0;
+  for (int y = 0; y < size.y; y++) {
+    for (int x = 0; x < size.x; x++) {
+      const float *c = color + 4 * (y * size.x + x);
+      const float *e = expected + 4 * (y * size.x + x);
+      if (std::abs(x - size.x / 2) <= 1)
+        continue;
+      for (int i = 0; i < 3; i++) {
+        if (std::abs(c[i] - e[i]) > 1e-2f) {
+          wrongPixels++;
+          break;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(wrongPixels, 0);
+
+  ospUnmapFrameBuffer(color, denoised);
+  ospUnmapFrameBuffer(expected, reference);
+
+  ospRelease(denoised);
+  ospRelease(reference);
+  ospRelease(renderer);
+  ospRelease(model);
+}
+
+TEST(FrameBuffer, denoiseReducesNoise) {
+  // a white floor, whose left half is partially occluded by a quad in
+  // front of its right half: with a single ao sample that is noisy
+  OSPModel model = ospNewModel();
+  const osp::vec3f white{1.f, 1.f, 1.f};
+  OSPGeometry floor = createQuad(-1.f, -1.f, 3.f, 3.f, 0.f, white);
+  ospAddGeometry(model, floor);
+  ospRelease(floor);
+  OSPGeometry occluder = createQuad(1.f, -1.f, 3.f, 3.f, -0.5f, white);
+  ospAddGeometry(model, occluder);
+  ospRelease(occluder);
+  ospCommit(model);
+
+  OSPRenderer renderer = createRenderer(model);
+
+  OSPFrameBuffer noisy    = renderFrame(renderer, false);
+  OSPFrameBuffer denoised = renderFrame(renderer, true);
+
+  EXPECT_EQ(ospDeviceGetLastErrorCode(ospGetCurrentDevice()), OSP_NO_ERROR);
+
+  auto *noisyColor    = (const float*)ospMapFrameBuffer(noisy, OSP_FB_COLOR);
+  auto *denoisedColor = (const float*)ospMapFrameBuffer(denoised, OSP_FB_COLOR);
+
+  // the occluded part of the floor, away from the edge of the occluder
+  const int x0 = size.x / 8, x1 = size.x / 2 - 4;
+  const int y0 = size.y / 4, y1 = 3 * size.y / 4;
+  float noisyMean, noisyNoise, denoisedMean, denoisedNoise;
+  measureRegion(noisyColor, x0, y0, x1, y1, noisyMean, noisyNoise);
+  measureRegion(denoisedColor, x0, y0, x1, y1, denoisedMean, denoisedNoise);
+
+  EXPECT_GT(noisyNoise, 0.05f);
+  EXPECT_LT(denoisedNoise, 0.5f * noisyNoise);
+  EXPECT_NEAR(denoisedMean, noisyMean, 0.1f);
+
+  ospUnmapFrameBuffer(denoisedColor, denoised);
+  ospUnmapFrameBuffer(noisyColor, noisy);
+
+  ospRelease(denoised);
+  ospRelease(noisy);
+  ospRelease(renderer);
+  ospRelease(model);
+}
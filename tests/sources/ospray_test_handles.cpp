@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include "common/Managed.h"
+#include "common/ObjectHandle.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+
+// The handle table behind ObjectHandle (used by the MPI devices), without
+// going through a device.
+
+using ospray::ManagedObject;
+using ospray::ObjectHandle;
+
+namespace {
+
+// a new object holding one (i.e., the application's) reference
+ManagedObject *newObject() {
+  ManagedObject *object = new ManagedObject;
+  object->refInc();
+  return object;
+}
+
+} // namespace
+
+TEST(ObjectHandle, assignLookupAndFree) {
+  ManagedObject *object = newObject();
+  ObjectHandle handle;
+  EXPECT_NE(handle, ospray::nullHandle);
+  EXPECT_FALSE(handle.defined());
+
+  handle.assign(object);
+  EXPECT_TRUE(handle.defined());
+  EXPECT_EQ(handle.lookup(), object);
+  EXPECT_EQ(ObjectHandle::lookup(object), handle);
+
+  handle.freeObject();
+  EXPECT_FALSE(handle.defined());
+  EXPECT_EQ(handle.lookup(), nullptr);
+  EXPECT_EQ(ObjectHandle::lookup(object), ospray::nullHandle);
+  object->refDec();
+}
+
+TEST(ObjectHandle, nullObjectIsDefined) {
+  ObjectHandle handle;
+  handle.assign(nullptr);
+  EXPECT_TRUE(handle.defined());
+  EXPECT_EQ(handle.lookup(), nullptr);
+  handle.freeObject();
+  EXPECT_FALSE(handle.defined());
+}
+
+TEST(ObjectHandle, staleHandleDoesNotResolve) {
+  ManagedObject *first = newObject();
+  ObjectHandle stale;
+  stale.assign(first);
+  stale.freeObject();
+  first->refDec();
+
+  // the freed slot is reused (LIFO) by the next handle of this thread
+  ManagedObject *second = newObject();
+  ObjectHandle handle;
+  handle.assign(second);
+  EXPECT_EQ(handle.objID(), stale.objID());
+  EXPECT_NE(handle, stale);
+
+  EXPECT_FALSE(stale.defined());
+  EXPECT_EQ(stale.lookup(), nullptr);
+  EXPECT_EQ(handle.lookup(), second);
+
+  handle.freeObject();
+  second->refDec();
+}
+
+TEST(ObjectHandle, doubleFreeIsNoOp) {
+  ObjectHandle handle;
+  handle.free();
+  handle.free();
+
+  // the slot is on a free list only once, thus two new handles can't
+  // share it
+  ObjectHandle a, b;
+  EXPECT_NE(a.objID(), b.objID());
+  a.free();
+  b.free();
+}
+
+TEST(ObjectHandle, generationWrapsAround) {
+  ObjectHandle first;
+  const int32_t id = first.objID();
+  std::set<int64_t> seen;
+  seen.insert(first);
+  first.free();
+
+  // the generation is 16 bits, 0 is skipped; freeing and allocating on
+  // the same thread keeps reusing the same slot
+  ObjectHandle handle = ospray::nullHandle;
+  for (int i = 1; i < 0xffff; i++) {
+    handle = ObjectHandle();
+    ASSERT_EQ(handle.objID(), id);
+    ASSERT_NE(handle.i32.generation, 0);
+    seen.insert(handle);
+    handle.free();
+  }
+  EXPECT_EQ(seen.size(), size_t(0xffff));
+
+  // after a full cycle the generation (and thus the handle) repeats
+  handle = ObjectHandle();
+  EXPECT_EQ(handle, first);
+  handle.free();
+}
+
+TEST(ObjectHandle, slotsFreedOnOtherThreadsAreReused) {
+  // more than the other tests leave on the free lists, thus the first
+  // thread takes all of them (and then grows the table)
+  const int numHandles = 1024;
+  std::vector<int32_t> freedIDs;
+  std::thread([&]() {
+    std::vector<ObjectHandle> handles(numHandles);
+    for (auto &h : handles) {
+      freedIDs.push_back(h.objID());
+      h.free();
+    }
+  }).join();
+
+  // new slots get IDs above all existing ones; as the second thread
+  // finds enough free slots in the first one's list the table must not
+  // grow
+  const int32_t maxID = *std::max_element(freedIDs.begin(), freedIDs.end());
+  std::thread([&]() {
+    std::vector<ObjectHandle> handles(numHandles);
+    for (auto &h : handles) {
+      EXPECT_LE(h.objID(), maxID);
+      h.free();
+    }
+  }).join();
+}
+
+TEST(ObjectHandle, concurrentAllocateLookupFree) {
+  const int numThreads = 8;
+  const int numIterations = 10000;
+
+  // all threads look up the shared objects while allocating and freeing
+  // their own
+  std::vector<ManagedObject*> sharedObjects(16);
+  std::vector<ObjectHandle> sharedHandles(sharedObjects.size());
+  for (size_t i = 0; i < sharedObjects.size(); i++) {
+    sharedObjects[i] = newObject();
+    sharedHandles[i].assign(sharedObjects[i]);
+  }
+
+  std::vector<int> errors(numThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t]() {
+      ManagedObject *object = newObject();
+      for (int i = 0; i < numIterations; i++) {
+        ObjectHandle handle;
+        handle.assign(object);
+        if (handle.lookup() != object)
+          errors[t]++;
+
+        const size_t s = i % sharedHandles.size();
+        if (sharedHandles[s].lookup() != sharedObjects[s])
+          errors[t]++;
+
+        handle.freeObject();
+        if (handle.defined())
+          errors[t]++;
+      }
+      object->refDec();
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (int t = 0; t < numThreads; t++)
+    EXPECT_EQ(errors[t], 0) << "thread " << t;
+
+  for (size_t i = 0; i < sharedObjects.size(); i++) {
+    sharedHandles[i].freeObject();
+    sharedObjects[i]->refDec();
+  }
+}